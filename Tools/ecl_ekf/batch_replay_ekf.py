@@ -0,0 +1,275 @@
+#! /usr/bin/env python3
+"""
+Replays all .ulg files in the supplied directory through EKF2 (SITL replay_mode=ekf2), running one px4 process per
+log in parallel, and writes summary metrics of each replayed log (innovation test ratios and estimator_status flags)
+to <output>/<log name>/summary.json, and of all logs to <output>/summary.csv.
+
+uORB, the parameters and the lockstep time are global to a px4 process, so every session runs in its own process with
+its own instance id and working directory.
+
+The logs are replayed with the SITL replay build (uORB publisher rules, without lockstep), which is built by setting
+the replay environment variable to any log file and ends up in build/px4_sitl_default_replay.
+
+Example:
+    replay=logs/any.ulg make px4_sitl_default
+    Tools/ecl_ekf/batch_replay_ekf.py -o replay_results logs/
+"""
+# -*- coding: utf-8 -*-
+
+import argparse
+import csv
+import glob
+import json
+import os
+import queue
+import shutil
+import subprocess
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+
+import numpy as np
+from pyulog import ULog
+
+TEST_RATIOS = ['mag_test_ratio', 'vel_test_ratio', 'pos_test_ratio', 'hgt_test_ratio', 'tas_test_ratio',
+               'hagl_test_ratio', 'beta_test_ratio']
+
+FLAGS = ['filter_fault_flags', 'innovation_check_flags', 'gps_check_fail_flags']
+
+
+def get_arguments():
+    parser = argparse.ArgumentParser(description='Replay the .ulg files in the specified directory through EKF2 in '
+                                                 'parallel and summarize the estimator_status of the replayed logs')
+    parser.add_argument("directory_path")
+    parser.add_argument('--build-dir', type=str, default='build/px4_sitl_default_replay',
+                        help='SITL replay build directory containing bin/px4 and etc/ '
+                             '(built with: replay=<log> make px4_sitl_default)')
+    parser.add_argument('-o', '--output', type=str, default='ekf2_replay_results',
+                        help='Output directory (one working directory per log and the summary.csv).')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='Number of parallel replay sessions (default: number of cores).')
+    parser.add_argument('--timeout', type=float, default=3600,
+                        help='Timeout in seconds per replayed log.')
+    parser.add_argument('--params', type=str, default=None,
+                        help='replay_params.txt to override parameters in every session (default: EKF2 parameters '
+                             'from each log).')
+    parser.add_argument('-x', '--overwrite', action='store_true',
+                        help='Replay logs again, even if a summary already exists.')
+    parser.add_argument('--keep-logs', action='store_true',
+                        help='Keep the replayed logs and working directories of successful sessions.')
+    return parser.parse_args()
+
+
+def is_replay_build(build_dir: str) -> bool:
+    """
+    Check that the px4 binary in build_dir was built for replay: the uORB publisher rules are compiled in, and the
+    lockstep scheduler is not (the replay module runs at its own pace then)
+    """
+    with open(os.path.join(build_dir, 'bin', 'px4'), 'rb') as px4_binary:
+        if b'orb_publisher.rules' not in px4_binary.read():
+            return False
+
+    compile_commands = os.path.join(build_dir, 'compile_commands.json')
+
+    if os.path.isfile(compile_commands):
+        with open(compile_commands, 'r') as compile_commands_file:
+            if '-DENABLE_LOCKSTEP_SCHEDULER' in compile_commands_file.read():
+                return False
+
+    return True
+
+
+def summarize_estimator_status(ulog_file: str) -> dict:
+    """
+    Compute the summary metrics of the estimator_status of a (replayed) log
+    """
+    ulog = ULog(ulog_file, ['estimator_status'])
+    datasets = [d for d in ulog.data_list if d.name == 'estimator_status' and d.multi_id == 0]
+
+    if not datasets:
+        raise RuntimeError('no estimator_status in {:s}'.format(ulog_file))
+
+    data = datasets[0].data
+    timestamps = data['timestamp']
+    metrics = {'num_samples': int(len(timestamps)),
+               'duration_s': float(timestamps[-1] - timestamps[0]) / 1e6 if len(timestamps) > 1 else 0.}
+
+    for field in TEST_RATIOS:
+        if field not in data:
+            continue
+
+        values = data[field]
+        values = values[np.isfinite(values)]
+
+        if len(values) == 0:
+            continue
+
+        metrics[field + '_max'] = float(np.max(values))
+        metrics[field + '_mean'] = float(np.mean(values))
+        metrics[field + '_pct_above_1'] = 100. * float(np.count_nonzero(values > 1.)) / len(values)
+
+    for field in FLAGS:
+        if field not in data:
+            continue
+
+        values = data[field].astype(np.uint64)
+        union = 0
+
+        for value in np.unique(values):
+            union |= int(value)
+
+        # bits set at any time and percentage of samples with any bit set
+        metrics[field] = union
+        metrics[field + '_pct_set'] = 100. * float(np.count_nonzero(values)) / len(values)
+
+    return metrics
+
+
+def replay_log(ulog_file: str, args, instance_ids: queue.Queue) -> dict:
+    """
+    Replay a single log in its own px4 process and summarize the result
+    """
+    name = os.path.splitext(os.path.basename(ulog_file))[0]
+    working_dir = os.path.join(args.output, name)
+    shutil.rmtree(working_dir, ignore_errors=True)
+    os.makedirs(working_dir)
+
+    if args.params is not None:
+        shutil.copy(args.params, os.path.join(working_dir, 'replay_params.txt'))
+
+    build_dir = os.path.abspath(args.build_dir)
+    env = dict(os.environ, replay=os.path.abspath(ulog_file), replay_mode='ekf2', PX4_SIM_SPEED_FACTOR='0')
+    result = {'log': ulog_file, 'status': 'failed'}
+
+    instance = instance_ids.get()
+    start = time.monotonic()
+
+    try:
+        with open(os.path.join(working_dir, 'px4.log'), 'w') as output:
+            process = subprocess.run([os.path.join(build_dir, 'bin', 'px4'), '-d', os.path.join(build_dir, 'etc'),
+                                      '-s', 'etc/init.d-posix/rcS', '-i', str(instance),
+                                      '-w', os.path.abspath(working_dir)],
+                                     env=env, stdin=subprocess.DEVNULL, stdout=output, stderr=subprocess.STDOUT,
+                                     timeout=args.timeout)
+        result['returncode'] = process.returncode
+
+    except subprocess.TimeoutExpired:
+        result['status'] = 'timeout'
+
+    finally:
+        instance_ids.put(instance)
+
+    result['replay_time_s'] = time.monotonic() - start
+
+    replayed_logs = sorted(glob.glob(os.path.join(working_dir, 'log', '**', '*_replayed.ulg'), recursive=True),
+                           key=os.path.getmtime)
+
+    if replayed_logs and result['status'] != 'timeout':
+        try:
+            result.update(summarize_estimator_status(replayed_logs[-1]))
+            result['status'] = 'ok'
+
+        except Exception as e:
+            result['error'] = str(e)
+
+    with open(os.path.join(working_dir, 'summary.json'), 'w') as summary_file:
+        json.dump(result, summary_file, indent=2)
+
+    if result['status'] == 'ok' and not args.keep_logs:
+        for entry in os.listdir(working_dir):
+            if entry not in ('summary.json', 'px4.log'):
+                path = os.path.join(working_dir, entry)
+                if os.path.isdir(path) and not os.path.islink(path):
+                    shutil.rmtree(path, ignore_errors=True)
+                else:
+                    os.remove(path)
+
+    return result
+
+
+def main() -> None:
+
+    args = get_arguments()
+
+    px4_binary = os.path.join(args.build_dir, 'bin', 'px4')
+
+    if not os.path.isfile(px4_binary):
+        print('px4 binary not found in {:s}, build it first with: replay=<log> make px4_sitl_default'.format(
+            args.build_dir))
+        sys.exit(1)
+
+    if not is_replay_build(args.build_dir):
+        print('{:s} is not a replay build (uORB publisher rules, without lockstep), build it with: '
+              'replay=<log> make px4_sitl_default'.format(args.build_dir))
+        sys.exit(1)
+
+    # get all the ulog files found in the specified directory and in subdirectories
+    ulog_files = glob.glob(os.path.join(args.directory_path, '**/*.ulg'), recursive=True)
+    print("found {:d} .ulg files in {:s}".format(len(ulog_files), args.directory_path))
+
+    # log names are used as working directory names and need to be unique
+    names = [os.path.splitext(os.path.basename(f))[0] for f in ulog_files]
+    duplicates = set(n for n in names if names.count(n) > 1)
+    if duplicates:
+        print('skipping logs with duplicate file names: {:s}'.format(', '.join(sorted(duplicates))))
+        ulog_files = [f for f, n in zip(ulog_files, names) if n not in duplicates]
+
+    os.makedirs(args.output, exist_ok=True)
+
+    results = []
+
+    if not args.overwrite:
+        remaining = []
+        for ulog_file in ulog_files:
+            name = os.path.splitext(os.path.basename(ulog_file))[0]
+            summary = os.path.join(args.output, name, 'summary.json')
+            if os.path.exists(summary):
+                with open(summary, 'r') as summary_file:
+                    results.append(json.load(summary_file))
+            else:
+                remaining.append(ulog_file)
+        print("skipping {:d} already replayed .ulg files.".format(len(ulog_files) - len(remaining)))
+        ulog_files = remaining
+
+    jobs = max(1, args.jobs)
+    print("replaying {:d} .ulg files with {:d} parallel sessions".format(len(ulog_files), jobs))
+
+    # px4 instance ids (lock file, daemon socket), reused when a session finishes
+    instance_ids = queue.Queue()
+    for instance in range(jobs):
+        instance_ids.put(instance)
+
+    start = time.monotonic()
+    n_failed = 0
+
+    with ThreadPoolExecutor(max_workers=jobs) as executor:
+        futures = [executor.submit(replay_log, ulog_file, args, instance_ids) for ulog_file in ulog_files]
+
+        for i, future in enumerate(as_completed(futures), 1):
+            result = future.result()
+            results.append(result)
+
+            if result['status'] != 'ok':
+                n_failed += 1
+
+            print('{:d}/{:d} {:s}: {:s} ({:.1f} s)'.format(i, len(futures), result['log'], result['status'],
+                                                            result['replay_time_s']))
+
+    elapsed = time.monotonic() - start
+    print('{:d}/{:d} logs replayed in {:.1f} s ({:.2f} logs/s), {:d} failed.'.format(
+        len(ulog_files) - n_failed, len(ulog_files), elapsed, len(ulog_files) / elapsed if elapsed > 0 else 0.,
+        n_failed))
+
+    # write the summary of all logs
+    fields = []
+    for result in results:
+        fields += [key for key in result.keys() if key not in fields]
+
+    with open(os.path.join(args.output, 'summary.csv'), 'w', newline='') as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames=fields)
+        writer.writeheader()
+        writer.writerows(sorted(results, key=lambda r: r['log']))
+
+
+if __name__ == '__main__':
+    main()
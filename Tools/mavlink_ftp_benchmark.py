@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+"""
+Measure the MAVLink FTP throughput (burst download, pipelined upload and directory listing).
+
+Run against SITL on localhost:
+    make px4_sitl_default
+    Tools/mavlink_ftp_benchmark.py --file /log/<dir>/<log>.ulg
+    Tools/mavlink_ftp_benchmark.py --upload 10000000 --upload-path /fs/microsd/ftp_benchmark.bin
+
+Burst reads are requested again from the first missing offset when a burst completes or packets are lost.
+Uploads keep up to --window Write commands in flight and match the acks by their offset.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+os.environ['MAVLINK20'] = '1'
+
+try:
+    from pymavlink import mavutil
+except ImportError as e:
+    print("Failed to import pymavlink: " + str(e))
+    print("")
+    print("You may need to install it with:")
+    print("    pip3 install --user pymavlink")
+    print("")
+    sys.exit(1)
+
+PAYLOAD_LEN = 251
+HEADER_FORMAT = '<HBBBBBBI'
+HEADER_LEN = struct.calcsize(HEADER_FORMAT)
+MAX_DATA_LEN = PAYLOAD_LEN - HEADER_LEN
+
+CMD_TERMINATE_SESSION = 1
+CMD_RESET_SESSIONS = 2
+CMD_LIST_DIRECTORY = 3
+CMD_OPEN_FILE_RO = 4
+CMD_CREATE_FILE = 6
+CMD_WRITE_FILE = 7
+CMD_REMOVE_FILE = 8
+CMD_BURST_READ_FILE = 15
+RSP_ACK = 128
+RSP_NAK = 129
+
+ERR_EOF = 6
+
+
+class FtpPayload:
+    def __init__(self, seq=0, session=0, opcode=0, size=0, req_opcode=0, burst_complete=0, offset=0, data=b''):
+        self.seq = seq
+        self.session = session
+        self.opcode = opcode
+        self.size = size
+        self.req_opcode = req_opcode
+        self.burst_complete = burst_complete
+        self.offset = offset
+        self.data = data
+
+    def pack(self):
+        payload = struct.pack(HEADER_FORMAT, self.seq, self.session, self.opcode, len(self.data) or self.size,
+                              self.req_opcode, self.burst_complete, 0, self.offset) + self.data
+        return list(payload.ljust(PAYLOAD_LEN, b'\0'))
+
+    @staticmethod
+    def unpack(payload):
+        payload = bytes(payload)
+        seq, session, opcode, size, req_opcode, burst_complete, _, offset = struct.unpack_from(HEADER_FORMAT, payload)
+        return FtpPayload(seq, session, opcode, size, req_opcode, burst_complete, offset,
+                          payload[HEADER_LEN:HEADER_LEN + size])
+
+
+class FtpClient:
+    def __init__(self, url, target_component, timeout):
+        self.mav = mavutil.mavlink_connection(url, source_system=254)
+        print('waiting for heartbeat on {:s}'.format(url))
+        self.mav.wait_heartbeat()
+        self.target_system = self.mav.target_system
+        self.target_component = target_component
+        self.timeout = timeout
+        self.seq = 0
+
+    def send(self, payload):
+        payload.seq = self.seq
+        self.seq = (self.seq + 1) & 0xffff
+        self.mav.mav.file_transfer_protocol_send(0, self.target_system, self.target_component, payload.pack())
+
+    def receive(self, timeout=None):
+        msg = self.mav.recv_match(type='FILE_TRANSFER_PROTOCOL', blocking=True,
+                                  timeout=self.timeout if timeout is None else timeout)
+        return None if msg is None else FtpPayload.unpack(msg.payload)
+
+    def request(self, payload, retries=5):
+        """ send a request and wait for its (n)ack """
+        for _ in range(retries):
+            self.send(payload)
+            deadline = time.monotonic() + self.timeout
+            while time.monotonic() < deadline:
+                reply = self.receive()
+                if reply is not None and reply.req_opcode == payload.opcode and reply.seq == self.seq:
+                    return reply
+        raise RuntimeError('no reply to opcode {:d}'.format(payload.opcode))
+
+    def check_ack(self, reply, what):
+        if reply.opcode != RSP_ACK:
+            raise RuntimeError('{:s} failed: error {:s}'.format(what, str(list(reply.data))))
+
+    def reset(self):
+        self.request(FtpPayload(opcode=CMD_RESET_SESSIONS))
+
+    def list_directory(self, path):
+        entries = []
+        while True:
+            reply = self.request(FtpPayload(opcode=CMD_LIST_DIRECTORY, offset=len(entries), data=path.encode() + b'\0'))
+            if reply.opcode == RSP_NAK:
+                if reply.data[0] == ERR_EOF:
+                    return entries
+                raise RuntimeError('list {:s} failed: error {:s}'.format(path, str(list(reply.data))))
+            if not reply.data:
+                return entries
+            names = reply.data.rstrip(b'\0').split(b'\0')
+            entries += [name.decode(errors='replace') for name in names]
+
+    def download(self, path):
+        reply = self.request(FtpPayload(opcode=CMD_OPEN_FILE_RO, data=path.encode() + b'\0'))
+        self.check_ack(reply, 'open ' + path)
+        session = reply.session
+        file_size, = struct.unpack_from('<I', reply.data)
+        data = bytearray(file_size)
+        received = [False] * ((file_size + MAX_DATA_LEN - 1) // MAX_DATA_LEN)
+        num_received = 0
+        num_bursts = 0
+        offset = 0
+
+        while num_received < len(received):
+            # (re-)start the burst at the first missing chunk
+            while received[offset // MAX_DATA_LEN]:
+                offset += MAX_DATA_LEN
+            self.send(FtpPayload(session=session, opcode=CMD_BURST_READ_FILE, offset=offset, size=MAX_DATA_LEN))
+            num_bursts += 1
+
+            while True:
+                reply = self.receive(timeout=0.5)
+
+                if reply is None:
+                    break  # lost the end of the burst
+
+                if reply.req_opcode != CMD_BURST_READ_FILE:
+                    continue
+
+                if reply.opcode == RSP_NAK:
+                    if reply.data[0] != ERR_EOF:
+                        raise RuntimeError('burst read failed: error {:s}'.format(str(list(reply.data))))
+                    break
+
+                chunk = reply.offset // MAX_DATA_LEN
+                if chunk < len(received) and not received[chunk]:
+                    received[chunk] = True
+                    num_received += 1
+                    data[reply.offset:reply.offset + len(reply.data)] = reply.data
+
+                if reply.burst_complete:
+                    break
+
+            offset = 0
+
+        self.request(FtpPayload(session=session, opcode=CMD_TERMINATE_SESSION))
+        return bytes(data), num_bursts
+
+    def upload(self, path, data, window):
+        reply = self.request(FtpPayload(opcode=CMD_CREATE_FILE, data=path.encode() + b'\0'))
+        self.check_ack(reply, 'create ' + path)
+        session = reply.session
+
+        pending = {}  # offset -> send time
+        next_offset = 0
+        num_resent = 0
+
+        while next_offset < len(data) or pending:
+            # keep the window full
+            while next_offset < len(data) and len(pending) < window:
+                self.send(FtpPayload(session=session, opcode=CMD_WRITE_FILE, offset=next_offset,
+                                     data=data[next_offset:next_offset + MAX_DATA_LEN]))
+                pending[next_offset] = time.monotonic()
+                next_offset += MAX_DATA_LEN
+
+            reply = self.receive(timeout=0.1)
+
+            if reply is not None and reply.req_opcode == CMD_WRITE_FILE:
+                self.check_ack(reply, 'write')
+                pending.pop(reply.offset, None)
+
+            # resend writes without ack (acks are matched by offset, so they can arrive in any order)
+            now = time.monotonic()
+            for offset, send_time in list(pending.items()):
+                if now - send_time > self.timeout:
+                    self.send(FtpPayload(session=session, opcode=CMD_WRITE_FILE, offset=offset,
+                                         data=data[offset:offset + MAX_DATA_LEN]))
+                    pending[offset] = now
+                    num_resent += 1
+
+        reply = self.request(FtpPayload(session=session, opcode=CMD_TERMINATE_SESSION))
+        self.check_ack(reply, 'terminate')
+        return num_resent
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Measure the MAVLink FTP throughput')
+    parser.add_argument('--url', default='udpin:0.0.0.0:14550', help='MAVLink connection (default: SITL GCS link)')
+    parser.add_argument('--component', type=int, default=1, help='target component id')
+    parser.add_argument('--file', help='file to download')
+    parser.add_argument('--list', help='directory to list')
+    parser.add_argument('--upload', type=int, default=0, help='number of bytes to upload')
+    parser.add_argument('--upload-path', default='/fs/microsd/ftp_benchmark.bin', help='upload destination')
+    parser.add_argument('--window', type=int, default=32, help='number of Write commands in flight')
+    parser.add_argument('--timeout', type=float, default=1.0, help='reply timeout [s]')
+    args = parser.parse_args()
+
+    client = FtpClient(args.url, args.component, args.timeout)
+    client.reset()
+
+    if args.list:
+        start = time.monotonic()
+        entries = client.list_directory(args.list)
+        print('list {:s}: {:d} entries in {:.3f} s'.format(args.list, len(entries), time.monotonic() - start))
+
+    if args.file:
+        start = time.monotonic()
+        data, num_bursts = client.download(args.file)
+        elapsed = time.monotonic() - start
+        print('download {:s}: {:.2f} MB in {:.2f} s, {:.2f} MB/s ({:d} bursts)'.format(
+            args.file, len(data) / 1e6, elapsed, len(data) / 1e6 / elapsed, num_bursts))
+
+    if args.upload > 0:
+        data = os.urandom(args.upload)
+        start = time.monotonic()
+        num_resent = client.upload(args.upload_path, data, args.window)
+        elapsed = time.monotonic() - start
+        print('upload {:s}: {:.2f} MB in {:.2f} s, {:.2f} MB/s (window {:d}, {:d} resent)'.format(
+            args.upload_path, len(data) / 1e6, elapsed, len(data) / 1e6 / elapsed, args.window, num_resent))
+
+        # read it back to verify the written data
+        readback, _ = client.download(args.upload_path)
+        print('upload verification: {:s}'.format('ok' if readback == data else 'FAILED'))
+        client.request(FtpPayload(opcode=CMD_REMOVE_FILE, data=args.upload_path.encode() + b'\0'))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+"""
+Convert an ULog file written with logger compression (SDLOG_COMPRESS) and/or delta encoded data messages
+(SDLOG_DELTA) into a standard ULog file.
+
+After the uncompressed file header and flag bits message, a compressed log consists of frames of a 4 byte header
+(uint16 compressed size, uint16 uncompressed size) followed by heatshrink compressed data (window size 2^8,
+lookahead 2^4). Every frame is compressed independently. File offsets stored in the log (e.g. the seek index)
+refer to the decompressed file.
+
+Delta encoded data messages ('X') contain the XOR with the previous data message of the same msg_id, packed as runs of
+[unchanged byte count, changed byte count, changed bytes] with LEB128 varint counts. They are expanded into
+regular data messages ('D'), which changes the file offsets after the first one (a seek index is thus removed).
+
+Example:
+    Tools/ulog_decompress.py log.ulg log_decompressed.ulg
+"""
+
+import argparse
+import struct
+import sys
+
+ULOG_MAGIC = b'ULog\x01\x12\x35'
+ULOG_FILE_HEADER_LEN = 16
+ULOG_MSG_HEADER_LEN = 3
+FLAG_BITS_LEN = ULOG_MSG_HEADER_LEN + 40
+INCOMPAT_FLAG0_DATA_APPENDED_MASK = 1 << 0
+INCOMPAT_FLAG0_COMPRESSED_MASK = 1 << 1
+INCOMPAT_FLAG0_DELTA_DATA_MASK = 1 << 2
+INCOMPAT_FLAGS_OFFSET = ULOG_FILE_HEADER_LEN + ULOG_MSG_HEADER_LEN + 8
+INDEX_TRAILER_KEY = b'uint64_t index_offset'
+
+FRAME_HEADER_LEN = 4
+WINDOW_BITS = 8
+LOOKAHEAD_BITS = 4
+
+
+def heatshrink_decode(data, uncompressed_size, window_bits=WINDOW_BITS, lookahead_bits=LOOKAHEAD_BITS):
+    """ decode a single heatshrink stream (the decoder starts with a zero filled window) """
+    window_size = 1 << window_bits
+    out = bytearray(window_size)
+    end = window_size + uncompressed_size
+    num_bits = len(data) * 8
+    bit_pos = 0
+
+    def get_bits(count):
+        nonlocal bit_pos
+        value = 0
+        for _ in range(count):
+            value = (value << 1) | ((data[bit_pos >> 3] >> (7 - (bit_pos & 7))) & 1)
+            bit_pos += 1
+        return value
+
+    while len(out) < end:
+        if bit_pos + 1 > num_bits:
+            break
+
+        if get_bits(1):  # literal
+            if bit_pos + 8 > num_bits:
+                break
+            out.append(get_bits(8))
+
+        else:  # backref
+            if bit_pos + window_bits + lookahead_bits > num_bits:
+                break
+            offset = get_bits(window_bits) + 1
+            count = get_bits(lookahead_bits) + 1
+            for _ in range(count):
+                out.append(out[-offset])
+
+    return bytes(out[window_size:end])
+
+
+def read_flag_bits(data):
+    """ return the incompat flags byte 0 """
+    if data[:len(ULOG_MAGIC)] != ULOG_MAGIC:
+        raise ValueError('not an ULog file')
+
+    msg_size, msg_type = struct.unpack_from('<HB', data, ULOG_FILE_HEADER_LEN)
+
+    if chr(msg_type) != 'B' or msg_size != FLAG_BITS_LEN - ULOG_MSG_HEADER_LEN:
+        raise ValueError('no flag bits message')
+
+    return data[INCOMPAT_FLAGS_OFFSET]
+
+
+def decompress(data):
+    """ decompress the content of a compressed ULog file, returns the decompressed file content """
+    if not read_flag_bits(data) & INCOMPAT_FLAG0_COMPRESSED_MASK:
+        raise ValueError('not compressed')
+
+    out = bytearray(data[:ULOG_FILE_HEADER_LEN + FLAG_BITS_LEN])
+    out[INCOMPAT_FLAGS_OFFSET] &= ~INCOMPAT_FLAG0_COMPRESSED_MASK & 0xff
+
+    offset = ULOG_FILE_HEADER_LEN + FLAG_BITS_LEN
+    num_frames = 0
+
+    while offset + FRAME_HEADER_LEN <= len(data):
+        compressed_size, uncompressed_size = struct.unpack_from('<HH', data, offset)
+        offset += FRAME_HEADER_LEN
+
+        if offset + compressed_size > len(data):
+            print('truncated frame at the end of the file (offset {:d}), ignoring it'.format(offset))
+            break
+
+        frame = heatshrink_decode(data[offset:offset + compressed_size], uncompressed_size)
+
+        if len(frame) != uncompressed_size:
+            raise ValueError('corrupt frame at offset {:d}'.format(offset))
+
+        out += frame
+        offset += compressed_size
+        num_frames += 1
+
+    return bytes(out), num_frames
+
+
+def read_varint(data, pos):
+    value = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value |= (byte & 0x7f) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def delta_decode(encoded, previous):
+    """ decode a delta encoded data message payload (after the msg_id) with respect to the previous data """
+    data = bytearray(previous)
+    in_pos = 0
+    pos = 0
+
+    while in_pos < len(encoded):
+        unchanged, in_pos = read_varint(encoded, in_pos)
+        changed, in_pos = read_varint(encoded, in_pos)
+        pos += unchanged
+
+        if pos + changed > len(data) or in_pos + changed > len(encoded):
+            raise ValueError('corrupt delta encoded data')
+
+        for i in range(changed):
+            data[pos + i] ^= encoded[in_pos + i]
+
+        pos += changed
+        in_pos += changed
+
+    return data
+
+
+def expand_delta_data(data):
+    """ replace the delta encoded data messages with data messages, returns the new file content """
+    if not read_flag_bits(data) & INCOMPAT_FLAG0_DELTA_DATA_MASK:
+        raise ValueError('no delta encoded data')
+
+    out = bytearray(data[:ULOG_FILE_HEADER_LEN + FLAG_BITS_LEN])
+    out[INCOMPAT_FLAGS_OFFSET] &= ~INCOMPAT_FLAG0_DELTA_DATA_MASK & 0xff
+
+    end = len(data)
+    if out[INCOMPAT_FLAGS_OFFSET] & INCOMPAT_FLAG0_DATA_APPENDED_MASK:
+        # the appended data offsets would be wrong: drop the appended data
+        appended_offsets = struct.unpack_from('<3Q', data, INCOMPAT_FLAGS_OFFSET + 8)
+        if appended_offsets[0] > 0:
+            print('dropping the appended data')
+            end = appended_offsets[0]
+        out[INCOMPAT_FLAGS_OFFSET] &= ~INCOMPAT_FLAG0_DATA_APPENDED_MASK & 0xff
+        out[INCOMPAT_FLAGS_OFFSET + 8:INCOMPAT_FLAGS_OFFSET + 32] = bytes(24)
+
+    previous = {}  # msg_id -> data of the previous data message
+    offset = ULOG_FILE_HEADER_LEN + FLAG_BITS_LEN
+    num_expanded = 0
+
+    while offset + ULOG_MSG_HEADER_LEN <= end:
+        msg_size, msg_type = struct.unpack_from('<HB', data, offset)
+        payload = offset + ULOG_MSG_HEADER_LEN
+
+        if payload + msg_size > end:
+            print('truncated message at the end of the file (offset {:d}), ignoring it'.format(offset))
+            break
+
+        message = data[offset:payload + msg_size]
+        msg_type = chr(msg_type)
+
+        if msg_type == 'D':
+            msg_id, = struct.unpack_from('<H', data, payload)
+            previous[msg_id] = data[payload + 2:payload + msg_size]
+
+        elif msg_type == 'X':
+            msg_id, = struct.unpack_from('<H', data, payload)
+
+            if msg_id not in previous:
+                print('delta encoded data message without reference (offset {:d}), skipping it'.format(offset))
+                message = b''
+            else:
+                previous[msg_id] = delta_decode(data[payload + 2:payload + msg_size], previous[msg_id])
+                message = struct.pack('<HBH', len(previous[msg_id]) + 2, ord('D'), msg_id) + previous[msg_id]
+                num_expanded += 1
+
+        elif msg_type == 'I' and data[payload + 1:payload + 1 + data[payload]] == INDEX_TRAILER_KEY:
+            message = b''  # the seek index offsets are not valid anymore
+
+        out += message
+        offset = payload + msg_size
+
+    return bytes(out), num_expanded
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert a compressed and/or delta encoded ULog file')
+    parser.add_argument('input', help='compressed or delta encoded .ulg file')
+    parser.add_argument('output', help='standard .ulg file')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+
+    try:
+        flags = read_flag_bits(data)
+
+        if not flags & (INCOMPAT_FLAG0_COMPRESSED_MASK | INCOMPAT_FLAG0_DELTA_DATA_MASK):
+            raise ValueError('neither compressed nor delta encoded')
+
+        converted = data
+
+        if flags & INCOMPAT_FLAG0_COMPRESSED_MASK:
+            converted, num_frames = decompress(converted)
+            print('decompressed {:d} frames: {:.1f} MB -> {:.1f} MB (ratio {:.2f})'.format(
+                num_frames, len(data) / 1e6, len(converted) / 1e6, len(converted) / max(len(data), 1)))
+
+        if flags & INCOMPAT_FLAG0_DELTA_DATA_MASK:
+            size = len(converted)
+            converted, num_expanded = expand_delta_data(converted)
+            print('expanded {:d} delta encoded messages: {:.1f} MB -> {:.1f} MB'.format(
+                num_expanded, size / 1e6, len(converted) / 1e6))
+
+    except ValueError as e:
+        print('{:s}: {:s}'.format(args.input, str(e)))
+        sys.exit(1)
+
+    with open(args.output, 'wb') as f:
+        f.write(converted)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,225 @@
+#!/usr/bin/env python3
+"""
+Extract a time range of an ULog file into a new, valid ULog file.
+
+The seek index appended by the logger (INFO_MULTIPLE 'index_sync'/'index_msg_id' messages and the fixed size
+'uint64_t index_offset' INFO message at the end of the file) is used to find the start and end of the range without
+parsing the data section. Logs without an index are scanned once.
+
+The output contains the definitions section (header, formats, info messages and initial parameters), the
+subscriptions (ADD_LOGGED_MSG) of the skipped part and all messages within the range.
+
+Example:
+    Tools/ulog_slice.py --start 2700 --end 2760 log.ulg log_45min.ulg
+"""
+
+import argparse
+import mmap
+import re
+import struct
+import sys
+
+ULOG_MAGIC = b'ULog\x01\x12\x35'
+ULOG_FILE_HEADER_LEN = 16
+ULOG_MSG_HEADER_LEN = 3
+SYNC_MAGIC = b'\x2F\x73\x13\x20\x25\x0C\xBB\x12'
+
+INCOMPAT_FLAG0_DATA_APPENDED_MASK = 1 << 0
+INCOMPAT_FLAG0_COMPRESSED_MASK = 1 << 1
+INCOMPAT_FLAG0_DELTA_DATA_MASK = 1 << 2
+
+INDEX_TRAILER_KEY = b'uint64_t index_offset'
+INDEX_TRAILER_SIZE = ULOG_MSG_HEADER_LEN + 1 + len(INDEX_TRAILER_KEY) + 8
+
+
+def messages(data, start, end):
+    """ iterate over (offset, msg_type, payload start, payload end) of the messages in [start, end) """
+    offset = start
+    while offset + ULOG_MSG_HEADER_LEN <= end:
+        msg_size, msg_type = struct.unpack_from('<HB', data, offset)
+        payload = offset + ULOG_MSG_HEADER_LEN
+        if payload + msg_size > end:
+            break  # truncated
+        yield offset, chr(msg_type), payload, payload + msg_size
+        offset = payload + msg_size
+
+
+class ULogFile:
+    def __init__(self, data):
+        self.data = data
+
+        if data[:len(ULOG_MAGIC)] != ULOG_MAGIC:
+            raise ValueError('not an ULog file')
+
+        self.start_time, = struct.unpack_from('<Q', data, 8)
+        self.end = len(data)
+        self.flag_bits_offset = None
+
+        # flag bits (must be the first message): the appended data is not part of the data section
+        msg_size, msg_type = struct.unpack_from('<HB', data, ULOG_FILE_HEADER_LEN)
+        if chr(msg_type) == 'B' and msg_size >= 40:
+            self.flag_bits_offset = ULOG_FILE_HEADER_LEN
+            incompat_flags = data[ULOG_FILE_HEADER_LEN + ULOG_MSG_HEADER_LEN + 8]
+
+            # compressed frames and delta encoded data messages cannot be cut at a sync point
+            if incompat_flags & INCOMPAT_FLAG0_COMPRESSED_MASK:
+                raise ValueError('compressed log, convert it with Tools/ulog_decompress.py first')
+
+            if incompat_flags & INCOMPAT_FLAG0_DELTA_DATA_MASK:
+                raise ValueError('log with delta encoded data, convert it with Tools/ulog_decompress.py first')
+
+            appended_offsets = struct.unpack_from('<3Q', data, ULOG_FILE_HEADER_LEN + ULOG_MSG_HEADER_LEN + 16)
+            if appended_offsets[0] > 0:
+                self.end = min(self.end, appended_offsets[0])
+
+        # the definitions end with the first ADD_LOGGED_MSG
+        self.data_section_start = None
+        for offset, msg_type, _, _ in messages(data, ULOG_FILE_HEADER_LEN, self.end):
+            if msg_type == 'A':
+                self.data_section_start = offset
+                break
+
+        if self.data_section_start is None:
+            raise ValueError('no data section')
+
+        self.sync_points = []  # (timestamp, offset), in file order
+        self.subscriptions = []  # ADD_LOGGED_MSG offsets, in file order
+
+        if self._read_index():
+            print('using seek index ({:d} sync points)'.format(len(self.sync_points)))
+        else:
+            print('no seek index, scanning the file')
+            self._scan()
+
+    def _read_index(self):
+        data = self.data
+        trailer = self.end - INDEX_TRAILER_SIZE
+
+        if trailer < self.data_section_start:
+            return False
+
+        msg_size, msg_type, key_len = struct.unpack_from('<HBB', data, trailer)
+        key_start = trailer + ULOG_MSG_HEADER_LEN + 1
+
+        if (chr(msg_type) != 'I' or msg_size != INDEX_TRAILER_SIZE - ULOG_MSG_HEADER_LEN or
+                data[key_start:key_start + key_len] != INDEX_TRAILER_KEY):
+            return False
+
+        index_offset, = struct.unpack_from('<Q', data, key_start + key_len)
+
+        if not self.data_section_start <= index_offset < trailer:
+            return False
+
+        for _, msg_type, payload, payload_end in messages(data, index_offset, trailer):
+            if msg_type != 'M':
+                continue
+
+            key_len = data[payload + 1]
+            key = bytes(data[payload + 2:payload + 2 + key_len]).decode('ascii', 'replace')
+            match = re.match(r'uint64_t\[(\d+)\] (\w+)$', key)
+
+            if not match:
+                continue
+
+            num_values = int(match.group(1))
+            values_start = payload + 2 + key_len
+
+            if values_start + num_values * 8 != payload_end:
+                continue
+
+            values = struct.unpack_from('<{:d}Q'.format(num_values), data, values_start)
+
+            if match.group(2) == 'index_sync':
+                self.sync_points += [(values[i], values[i + 1]) for i in range(0, num_values - 1, 2)]
+
+            elif match.group(2) == 'index_msg_id':
+                self.subscriptions += [values[i + 1] for i in range(0, num_values - 3, 4) if values[i + 1] > 0]
+
+        self.sync_points.sort(key=lambda sync_point: sync_point[1])
+        self.subscriptions.sort()
+        self.end = index_offset  # the index itself is not copied
+        return len(self.sync_points) > 0
+
+    def _scan(self):
+        # use the timestamp of the last data message before each SYNC message
+        # (all PX4 topics start with the timestamp)
+        timestamp = self.start_time
+
+        for offset, msg_type, payload, payload_end in messages(self.data, self.data_section_start, self.end):
+            if msg_type == 'D' and payload_end - payload >= 10:
+                timestamp = max(timestamp, struct.unpack_from('<Q', self.data, payload + 2)[0])
+
+            elif msg_type == 'S' and self.data[payload:payload_end] == SYNC_MAGIC:
+                self.sync_points.append((timestamp, offset))
+
+            elif msg_type == 'A':
+                self.subscriptions.append(offset)
+
+    def seek(self, timestamp):
+        """ file offset of the last sync point at or before timestamp (or the start of the data section) """
+        offset = self.data_section_start
+        for sync_timestamp, sync_offset in self.sync_points:
+            if sync_timestamp > timestamp:
+                break
+            offset = sync_offset
+        return offset
+
+    def seek_end(self, timestamp):
+        """ file offset of the first sync point after timestamp (or the end of the data section) """
+        for sync_timestamp, sync_offset in self.sync_points:
+            if sync_timestamp > timestamp:
+                return sync_offset
+        return self.end
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Extract a time range of an ULog file')
+    parser.add_argument('input', help='input .ulg file')
+    parser.add_argument('output', help='output .ulg file')
+    parser.add_argument('-s', '--start', type=float, default=0, help='start time [s] since the start of the log')
+    parser.add_argument('-e', '--end', type=float, default=None, help='end time [s] since the start of the log')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        try:
+            ulog = ULogFile(data)
+        except ValueError as e:
+            print('{:s}: {:s}'.format(args.input, str(e)))
+            sys.exit(1)
+
+        start = ulog.seek(ulog.start_time + int(args.start * 1e6))
+        end = ulog.end if args.end is None else ulog.seek_end(ulog.start_time + int(args.end * 1e6))
+
+        if end <= start:
+            print('empty time range')
+            sys.exit(1)
+
+        with open(args.output, 'wb') as out:
+            definitions = bytearray(data[:ulog.data_section_start])
+
+            if ulog.flag_bits_offset is not None:
+                # the appended data is not copied: clear the DATA_APPENDED flag and the offsets
+                flags = ulog.flag_bits_offset + ULOG_MSG_HEADER_LEN
+                definitions[flags + 8] &= ~INCOMPAT_FLAG0_DATA_APPENDED_MASK & 0xff
+                definitions[flags + 16:flags + 40] = bytes(24)
+
+            out.write(definitions)
+
+            for offset in ulog.subscriptions:
+                if offset >= start:
+                    break
+                msg_size, = struct.unpack_from('<H', data, offset)
+                out.write(data[offset:offset + ULOG_MSG_HEADER_LEN + msg_size])
+
+            out.write(data[start:end])
+
+        print('wrote {:s}: {:.1f} MB of {:.1f} MB (file offsets {:d} - {:d})'.format(
+            args.output, (ulog.data_section_start + end - start) / 1e6, len(data) / 1e6, start, end))
+
+        data.close()
+
+
+if __name__ == '__main__':
+    main()
@@ -36,19 +36,22 @@
 #include "WorkQueueManager.hpp"
 #include "WorkQueue.hpp"
 
+#include <containers/IntrusiveMpscQueue.hpp>
 #include <containers/IntrusiveQueue.hpp>
 #include <containers/IntrusiveSortedList.hpp>
 #include <px4_platform_common/defines.h>
 #include <drivers/drv_hrt.h>
 #include <lib/mathlib/mathlib.h>
+#include <lib/perf/log2_histogram.hpp>
 #include <lib/perf/perf_counter.h>
+#include <px4_platform_common/atomic.h>
 
 #include <string.h>
 
 namespace px4
 {
 
-class WorkItem : public IntrusiveSortedListNode<WorkItem *>, public IntrusiveQueueNode<WorkItem *>
+class WorkItem : public IntrusiveSortedListNode<WorkItem *>, public WorkQueue::QueueNode
 {
 public:
 
@@ -66,12 +69,24 @@ public:
 	inline void ScheduleNow()
 	{
 		if (_wq != nullptr) {
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+			// keep the first schedule time until the item runs
+			uint32_t unscheduled = 0;
+			_time_scheduled.compare_exchange(&unscheduled, (uint32_t)hrt_absolute_time());
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
 			_wq->Add(this);
 		}
 	}
 
 	virtual void print_run_status();
 
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+	void print_histograms();
+
+	const Log2Histogram &latency_histogram() const { return _latency; }
+	const Log2Histogram &run_time_histogram() const { return _run_time; }
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
+
 	/**
 	 * Switch to a different WorkQueue.
 	 * NOTE: Caller is responsible for synchronization.
@@ -99,16 +114,39 @@ protected:
 
 	void RunPreamble()
 	{
+		const hrt_abstime now = hrt_absolute_time();
+
 		if (_run_count == 0) {
-			_time_first_run = hrt_absolute_time();
+			_time_first_run = now;
 			_run_count = 1;
 
 		} else {
+			const uint32_t interval = now - _time_last_run;
+			_interval_min = math::min(_interval_min, interval);
+			_interval_max = math::max(_interval_max, interval);
 			_run_count++;
 		}
+
+		_time_last_run = now;
+
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+		uint32_t scheduled = _time_scheduled.load();
+
+		while (!_time_scheduled.compare_exchange(&scheduled, 0)) {}
+
+		if (scheduled != 0) {
+			_latency.record((uint32_t)now - scheduled);
+		}
+
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
 	}
 
-	friend void WorkQueue::Run();
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+	// called by the WorkQueue after Run(), only if the item was not detached meanwhile
+	void RunPostamble() { _run_time.record(hrt_elapsed_time(&_time_last_run)); }
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
+
+	friend void WorkQueue::Run(uint8_t worker_index);
 	virtual void Run() = 0;
 
 	/**
@@ -127,9 +165,20 @@ protected:
 	float average_interval() const;
 
 	hrt_abstime	_time_first_run{0};
+	hrt_abstime	_time_last_run{0};
 	const char 	*_item_name;
 	uint32_t	_run_count{0};
 
+	// shortest and longest interval between consecutive runs since the last status print
+	uint32_t	_interval_min{UINT32_MAX};
+	uint32_t	_interval_max{0};
+
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+	px4::atomic<uint32_t>	_time_scheduled{0};	// lower 32 bits of the first ScheduleNow() time, 0 if not scheduled
+	Log2Histogram		_latency;		// ScheduleNow() to Run() start (us)
+	Log2Histogram		_run_time;		// Run() duration (us)
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
+
 private:
 
 	WorkQueue	*_wq{nullptr};
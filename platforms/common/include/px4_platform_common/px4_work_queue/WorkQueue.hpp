@@ -37,7 +37,9 @@
 
 #include <containers/BlockingList.hpp>
 #include <containers/List.hpp>
+#include <containers/IntrusiveMpscQueue.hpp>
 #include <containers/IntrusiveQueue.hpp>
+#include <drivers/drv_hrt.h>
 #include <px4_platform_common/atomic.h>
 #include <px4_platform_common/defines.h>
 #include <px4_platform_common/sem.h>
@@ -51,6 +53,16 @@ class WorkItem;
 class WorkQueue : public IntrusiveSortedListNode<WorkQueue *>
 {
 public:
+
+#ifdef __PX4_NUTTX
+	// In NuttX work can be enqueued from an ISR, the queue is protected by a critical section
+	using Queue = IntrusiveQueue<WorkItem *>;
+	using QueueNode = IntrusiveQueueNode<WorkItem *>;
+#else
+	// Lock-free for producers (Add), the worker thread pops under _qlock (serialized with Remove/Clear)
+	using Queue = IntrusiveMpscQueue<WorkItem *>;
+	using QueueNode = IntrusiveMpscQueueNode<WorkItem *>;
+#endif
 	explicit WorkQueue(const wq_config_t &wq_config);
 	WorkQueue() = delete;
 
@@ -67,11 +79,30 @@ public:
 
 	void Clear();
 
-	void Run();
+	void Run(uint8_t worker_index = 0);
+
+#ifndef __PX4_NUTTX
+	static constexpr uint8_t MAX_WORKERS = 8;
+
+	/**
+	 * Set the number of threads running this work queue (thread pool mode).
+	 * Must be called before any of the threads is started.
+	 */
+	void set_num_workers(uint8_t num_workers);
+	uint8_t num_workers() const { return _num_workers; }
+#endif /* __PX4_NUTTX */
 
 	void request_stop() { _should_exit.store(true); }
 
-	void print_status(bool last = false);
+	void print_status(bool last = false, bool verbose = false);
+
+	/**
+	 * Get the run statistics of the WorkItem at the given position.
+	 *
+	 * @param index	position of the WorkItem, reduced by the number of WorkItems if not found
+	 * @return false if index is past the last WorkItem
+	 */
+	bool item_stats(unsigned &index, work_item_stats_t &stats);
 
 	// WorkQueues sorted numerically by relative priority (-1 to -255)
 	bool operator<=(const WorkQueue &rhs) const { return _config.relative_priority >= rhs.get_config().relative_priority; }
@@ -82,6 +113,22 @@ private:
 
 	inline void SignalWorkerThread();
 
+#ifndef __PX4_NUTTX
+	struct worker_t {
+		const WorkItem *current{nullptr};	// item being run, only compared, never dereferenced (cleared by Detach)
+		bool rerun{false};			// current item was scheduled again while running
+		hrt_abstime start{0};			// start of the utilization measurement
+		hrt_abstime busy{0};			// time spent running items since start
+		uint32_t runs{0};
+	};
+
+	// thread pool mode, called with the work lock held
+	bool claim(WorkItem *item, worker_t &worker);
+	void release(worker_t &worker);
+
+	void print_worker_status(bool last);
+#endif /* __PX4_NUTTX */
+
 #ifdef __PX4_NUTTX
 	// In NuttX work can be enqueued from an ISR
 	void work_lock() { _flags = enter_critical_section(); }
@@ -94,15 +141,27 @@ private:
 	px4_sem_t _qlock;
 #endif
 
-	IntrusiveQueue<WorkItem *>	_q;
+	Queue				_q;
 	px4_sem_t			_process_lock;
 	px4_sem_t			_exit_lock;
 	const wq_config_t		&_config;
 	BlockingList<WorkItem *>	_work_items;
 	px4::atomic_bool		_should_exit{false};
 
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS) && defined(__PX4_NUTTX)
+	const WorkItem			*_running_item{nullptr};	// item being run, cleared by Detach
+#endif
+
+#ifndef __PX4_NUTTX
+	px4::atomic_bool		_signalled {false};	// worker thread wakeup pending
+
+	worker_t			_workers[MAX_WORKERS] {};
+	uint8_t				_num_workers{1};
+	uint8_t				_num_running{0};	// items currently running (thread pool mode)
+#endif
+
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
-	int _lockstep_component {-1};
+	px4::atomic_int _lockstep_component {-1};
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
 };
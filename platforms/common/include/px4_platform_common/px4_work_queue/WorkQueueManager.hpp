@@ -44,6 +44,7 @@ struct wq_config_t {
 	const char *name;
 	uint16_t stacksize;
 	int8_t relative_priority; // relative to max
+	bool pool{false}; // non-realtime, may be served by a thread pool (CONFIG_WORK_QUEUE_POOL)
 };
 
 namespace wq_configurations
@@ -72,6 +73,20 @@ static constexpr wq_config_t INS1{"wq:INS1", 6000, -15};
 static constexpr wq_config_t INS2{"wq:INS2", 6000, -16};
 static constexpr wq_config_t INS3{"wq:INS3", 6000, -17};
 
+// additional INS instances of the same IMU, with their own thread (CONFIG_EKF2_MULTI_INSTANCE_PARALLEL)
+static constexpr wq_config_t INS0_1{"wq:INS0_1", 6000, -14};
+static constexpr wq_config_t INS0_2{"wq:INS0_2", 6000, -14};
+static constexpr wq_config_t INS0_3{"wq:INS0_3", 6000, -14};
+static constexpr wq_config_t INS1_1{"wq:INS1_1", 6000, -15};
+static constexpr wq_config_t INS1_2{"wq:INS1_2", 6000, -15};
+static constexpr wq_config_t INS1_3{"wq:INS1_3", 6000, -15};
+static constexpr wq_config_t INS2_1{"wq:INS2_1", 6000, -16};
+static constexpr wq_config_t INS2_2{"wq:INS2_2", 6000, -16};
+static constexpr wq_config_t INS2_3{"wq:INS2_3", 6000, -16};
+static constexpr wq_config_t INS3_1{"wq:INS3_1", 6000, -17};
+static constexpr wq_config_t INS3_2{"wq:INS3_2", 6000, -17};
+static constexpr wq_config_t INS3_3{"wq:INS3_3", 6000, -17};
+
 static constexpr wq_config_t hp_default{"wq:hp_default", 2392, -18};
 
 static constexpr wq_config_t uavcan{"wq:uavcan", 3624, -19};
@@ -89,7 +104,7 @@ static constexpr wq_config_t ttyS9{"wq:ttyS9", 1728, -30};
 static constexpr wq_config_t ttyACM0{"wq:ttyACM0", 1728, -31};
 static constexpr wq_config_t ttyUnknown{"wq:ttyUnknown", 1728, -32};
 
-static constexpr wq_config_t lp_default{"wq:lp_default", 1920, -50};
+static constexpr wq_config_t lp_default{"wq:lp_default", 1920, -50, true};
 
 static constexpr wq_config_t test1{"wq:test1", 2000, 0};
 static constexpr wq_config_t test2{"wq:test2", 2000, 0};
@@ -108,8 +123,33 @@ int WorkQueueManagerStop();
 
 /**
  * Work queue manager status.
+ *
+ * @param verbose		Also print the latency and run time histograms of every WorkItem.
  */
-int WorkQueueManagerStatus();
+int WorkQueueManagerStatus(bool verbose = false);
+
+/**
+ * Run statistics of a single WorkItem (see CONFIG_WORK_QUEUE_HISTOGRAMS).
+ */
+struct work_item_stats_t {
+	const char *item_name;
+	const char *wq_name;
+	uint32_t latency_p50;		// ScheduleNow() to Run() start (us)
+	uint32_t latency_p99;
+	uint32_t latency_max;
+	uint32_t run_time_p50;		// Run() duration (us)
+	uint32_t run_time_p99;
+	uint32_t run_time_max;
+};
+
+/**
+ * Get the run statistics of a WorkItem.
+ *
+ * @param index		Index over the WorkItems of all work queues.
+ * @param stats		Filled with the WorkItem statistics.
+ * @return		false if index is past the last WorkItem.
+ */
+bool WorkQueueManagerItemStats(unsigned index, work_item_stats_t &stats);
 
 /**
  * Create (or find) a work queue with a particular configuration.
@@ -137,5 +177,11 @@ const wq_config_t &serial_port_to_wq(const char *serial);
 
 const wq_config_t &ins_instance_to_wq(uint8_t instance);
 
+/**
+ * Map an INS instance and a sub-instance of it (eg. the magnetometer of a multi-EKF instance) to a work queue.
+ * Sub-instance 0 uses the work queue of the INS instance.
+ */
+const wq_config_t &ins_instance_to_wq(uint8_t instance, uint8_t sub_instance);
+
 
 } // namespace px4
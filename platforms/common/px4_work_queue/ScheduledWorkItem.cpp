@@ -75,8 +75,21 @@ void ScheduledWorkItem::ScheduleClear()
 void ScheduledWorkItem::print_run_status()
 {
 	if (_call.period > 0) {
-		PX4_INFO_RAW("%-29s %8.1f Hz %12.0f us (%" PRId64 " us)\n", _item_name, (double)average_rate(),
-			     (double)average_interval(), _call.period);
+		// jitter: largest deviation of the actual run interval from the scheduled period
+		const hrt_abstime period = _call.period;
+		hrt_abstime jitter = 0;
+
+		if (_run_count > 1) {
+			jitter = math::max((_interval_max > period) ? _interval_max - period : 0,
+					   (_interval_min < period) ? period - _interval_min : 0);
+		}
+
+		PX4_INFO_RAW("%-29s %8.1f Hz %12.0f us (%" PRId64 " us) %8" PRId64 " us\n", _item_name, (double)average_rate(),
+			     (double)average_interval(), period, jitter);
+
+		// reset statistics
+		_interval_min = UINT32_MAX;
+		_interval_max = 0;
 
 	} else {
 		WorkItem::print_run_status();
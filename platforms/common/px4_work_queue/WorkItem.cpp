@@ -39,6 +39,8 @@
 #include <px4_platform_common/log.h>
 #include <drivers/drv_hrt.h>
 
+#include <inttypes.h>
+
 namespace px4
 {
 
@@ -138,6 +140,17 @@ void WorkItem::print_run_status()
 
 	// reset statistics
 	_run_count = 0;
+	_interval_min = UINT32_MAX;
+	_interval_max = 0;
+}
+
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+void WorkItem::print_histograms()
+{
+	PX4_INFO_RAW("latency p50 %5" PRIu32 " p99 %6" PRIu32 " max %6" PRIu32 " us, run p50 %5" PRIu32 " p99 %6" PRIu32 " max %6"
+		     PRIu32 " us\n", _latency.percentile(50), _latency.percentile(99), _latency.max(),
+		     _run_time.percentile(50), _run_time.percentile(99), _run_time.max());
 }
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
 
 } // namespace px4
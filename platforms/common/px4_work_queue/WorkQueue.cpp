@@ -34,6 +34,7 @@
 #include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
 #include <px4_platform_common/px4_work_queue/WorkItem.hpp>
 
+#include <inttypes.h>
 #include <string.h>
 
 #include <px4_platform_common/log.h>
@@ -105,6 +106,24 @@ void WorkQueue::Detach(WorkItem *item)
 
 	_work_items.remove(item);
 
+	// the item may be deleted, stop the worker from touching it after its Run() returns
+#ifndef __PX4_NUTTX
+
+	for (int i = 0; i < _num_workers; i++) {
+		if (_workers[i].current == item) {
+			_workers[i].current = nullptr;
+			_workers[i].rerun = false;
+		}
+	}
+
+#elif defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+
+	if (_running_item == item) {
+		_running_item = nullptr;
+	}
+
+#endif /* __PX4_NUTTX */
+
 	if (_work_items.size() == 0) {
 		// shutdown, no active WorkItems
 		PX4_DEBUG("stopping: %s, last active WorkItem closing", _config.name);
@@ -128,35 +147,74 @@ void WorkQueue::Detach(WorkItem *item)
 
 void WorkQueue::Add(WorkItem *item)
 {
+#ifdef __PX4_NUTTX
 	work_lock();
+	_q.push(item);
+	work_unlock();
+
+#else
+
+	// lock-free, nothing to do if the item is already queued
+	if (!_q.push(item)) {
+		return;
+	}
+
+#endif /* __PX4_NUTTX */
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 
-	if (_lockstep_component == -1) {
-		_lockstep_component = px4_lockstep_register_component();
+	// checked after the push, see Run()
+	if (_lockstep_component.load() == -1) {
+		work_lock();
+
+		if (_lockstep_component.load() == -1) {
+			_lockstep_component.store(px4_lockstep_register_component());
+		}
+
+		work_unlock();
 	}
 
 #endif // ENABLE_LOCKSTEP_SCHEDULER
 
-	_q.push(item);
-	work_unlock();
-
 	SignalWorkerThread();
 }
 
 void WorkQueue::SignalWorkerThread()
 {
+#ifdef __PX4_NUTTX
 	int sem_val;
 
 	if (px4_sem_getvalue(&_process_lock, &sem_val) == 0 && sem_val <= 0) {
 		px4_sem_post(&_process_lock);
 	}
+
+#else
+	// only the first signal until the worker thread wakes up posts the semaphore
+	bool signalled = false;
+
+	if (_signalled.compare_exchange(&signalled, true)) {
+		px4_sem_post(&_process_lock);
+	}
+
+#endif /* __PX4_NUTTX */
 }
 
 void WorkQueue::Remove(WorkItem *item)
 {
 	work_lock();
 	_q.remove(item);
+
+#ifndef __PX4_NUTTX
+
+	// don't requeue the item once it finished running in another worker
+	for (int i = 0; i < _num_workers; i++) {
+		if (_workers[i].current == item) {
+			_workers[i].rerun = false;
+		}
+	}
+
+#endif /* __PX4_NUTTX */
+
 	work_unlock();
 }
 
@@ -168,33 +226,149 @@ void WorkQueue::Clear()
 		_q.pop();
 	}
 
+#ifndef __PX4_NUTTX
+
+	for (int i = 0; i < _num_workers; i++) {
+		_workers[i].rerun = false;
+	}
+
+#endif /* __PX4_NUTTX */
+
 	work_unlock();
 }
 
-void WorkQueue::Run()
+#ifndef __PX4_NUTTX
+void WorkQueue::set_num_workers(uint8_t num_workers)
+{
+	_num_workers = math::constrain(num_workers, (uint8_t)1, MAX_WORKERS);
+}
+
+bool WorkQueue::claim(WorkItem *item, worker_t &worker)
+{
+	// a WorkItem never runs concurrently with itself, let the worker running it requeue it
+	for (int i = 0; i < _num_workers; i++) {
+		if (_workers[i].current == item) {
+			_workers[i].rerun = true;
+			return false;
+		}
+	}
+
+	worker.current = item;
+	worker.rerun = false;
+	_num_running++;
+
+	return true;
+}
+
+void WorkQueue::release(worker_t &worker)
+{
+	_num_running--;
+
+	if (worker.rerun && (worker.current != nullptr)) {
+		_q.push(const_cast<WorkItem *>(worker.current));
+	}
+
+	worker.rerun = false;
+
+	worker.current = nullptr;
+}
+#endif /* __PX4_NUTTX */
+
+void WorkQueue::Run(uint8_t worker_index)
 {
+#ifndef __PX4_NUTTX
+	worker_t &worker = _workers[worker_index];
+	worker.start = hrt_absolute_time();
+#endif /* __PX4_NUTTX */
+
 	while (!should_exit()) {
 		// loop as the wait may be interrupted by a signal
 		do {} while (px4_sem_wait(&_process_lock) != 0);
 
+#ifndef __PX4_NUTTX
+		// reset before processing, anything added from now on signals again
+		_signalled.store(false);
+#endif /* __PX4_NUTTX */
+
 		work_lock();
 
 		// process queued work
 		while (!_q.empty()) {
 			WorkItem *work = _q.pop();
 
+#ifndef __PX4_NUTTX
+			const bool pool = (_num_workers > 1);
+
+			if (pool) {
+				if (!claim(work, worker)) {
+					continue;
+				}
+
+				// let another worker take the remaining work
+				if (!_q.empty()) {
+					SignalWorkerThread();
+				}
+			}
+
+			const hrt_abstime run_start = pool ? hrt_absolute_time() : 0;
+#endif /* __PX4_NUTTX */
+
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+#ifdef __PX4_NUTTX
+			_running_item = work;
+			const WorkItem *&running_item = _running_item;
+#else
+			worker.current = work; // already claimed in thread pool mode
+			const WorkItem *&running_item = worker.current;
+#endif /* __PX4_NUTTX */
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
+
 			work_unlock(); // unlock work queue to run (item may requeue itself)
 			work->RunPreamble();
 			work->Run();
 			// Note: after Run() we cannot access work anymore, as it might have been deleted
 			work_lock(); // re-lock
+
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+
+			// unless it's still attached (Detach clears the running item, with the work lock held)
+			if (running_item == work) {
+				work->RunPostamble();
+			}
+
+#ifndef __PX4_NUTTX
+
+			if (!pool) {
+				worker.current = nullptr;
+			}
+
+#endif /* __PX4_NUTTX */
+
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
+
+#ifndef __PX4_NUTTX
+
+			if (pool) {
+				worker.busy += hrt_elapsed_time(&run_start);
+				worker.runs++;
+				release(worker);
+			}
+
+#endif /* __PX4_NUTTX */
 		}
 
 #if defined(ENABLE_LOCKSTEP_SCHEDULER)
 
-		if (_q.empty()) {
-			px4_lockstep_unregister_component(_lockstep_component);
-			_lockstep_component = -1;
+		// with a thread pool, items might still be running in other workers
+		if (_q.empty() && (_num_running == 0)) {
+			px4_lockstep_unregister_component(_lockstep_component.load());
+			_lockstep_component.store(-1);
+
+			// an Add() racing with the empty check above may have seen the component
+			// still registered and skipped the registration
+			if (!_q.empty()) {
+				_lockstep_component.store(px4_lockstep_register_component());
+			}
 		}
 
 #endif // ENABLE_LOCKSTEP_SCHEDULER
@@ -202,13 +376,27 @@ void WorkQueue::Run()
 		work_unlock();
 	}
 
+#ifndef __PX4_NUTTX
+
+	// wake up the next worker of the pool, so that it exits as well
+	if (_num_workers > 1) {
+		px4_sem_post(&_process_lock);
+	}
+
+#endif /* __PX4_NUTTX */
+
 	PX4_DEBUG("%s: exiting", _config.name);
 }
 
-void WorkQueue::print_status(bool last)
+void WorkQueue::print_status(bool last, bool verbose)
 {
 	const size_t num_items = _work_items.size();
 	PX4_INFO_RAW("%-16s\n", get_name());
+
+#ifndef __PX4_NUTTX
+	print_worker_status(last);
+#endif /* __PX4_NUTTX */
+
 	unsigned i = 0;
 
 	for (WorkItem *item : _work_items) {
@@ -229,7 +417,66 @@ void WorkQueue::print_status(bool last)
 		}
 
 		item->print_run_status();
+
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+
+		if (verbose) {
+			PX4_INFO_RAW("%s   %s      ", last ? " " : "|", (i < num_items) ? "|" : " ");
+			item->print_histograms();
+		}
+
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
+	}
+}
+
+bool WorkQueue::item_stats(unsigned &index, work_item_stats_t &stats)
+{
+	LockGuard lg{_work_items.mutex()};
+
+	for (WorkItem *item : _work_items) {
+		if (index-- == 0) {
+			stats.item_name = item->ItemName();
+			stats.wq_name = get_name();
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+			const Log2Histogram &latency = item->latency_histogram();
+			const Log2Histogram &run_time = item->run_time_histogram();
+			stats.latency_p50 = latency.percentile(50);
+			stats.latency_p99 = latency.percentile(99);
+			stats.latency_max = latency.max();
+			stats.run_time_p50 = run_time.percentile(50);
+			stats.run_time_p99 = run_time.percentile(99);
+			stats.run_time_max = run_time.max();
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#ifndef __PX4_NUTTX
+void WorkQueue::print_worker_status(bool last)
+{
+	if (_num_workers <= 1) {
+		return;
+	}
+
+	const hrt_abstime now = hrt_absolute_time();
+
+	for (int i = 0; i < _num_workers; i++) {
+		worker_t &worker = _workers[i];
+
+		const hrt_abstime elapsed = now - worker.start;
+		const float utilization = (elapsed > 0) ? 100.f * worker.busy / elapsed : 0.f;
+
+		PX4_INFO_RAW("%s   (worker %d) %5.1f %% busy %8" PRIu32 " runs\n", last ? " " : "|", i, (double)utilization, worker.runs);
+
+		// reset statistics
+		worker.start = now;
+		worker.busy = 0;
+		worker.runs = 0;
 	}
 }
+#endif /* __PX4_NUTTX */
 
 } // namespace px4
@@ -47,6 +47,7 @@
 #include <lib/mathlib/mathlib.h>
 
 #include <limits.h>
+#include <stdlib.h>
 #include <string.h>
 
 using namespace time_literals;
@@ -226,23 +227,188 @@ const wq_config_t &ins_instance_to_wq(uint8_t instance)
 	return wq_configurations::INS0;
 }
 
+const wq_config_t &ins_instance_to_wq(uint8_t instance, uint8_t sub_instance)
+{
+	static constexpr const wq_config_t *ins_sub_instance_wq[4][3] {
+		{&wq_configurations::INS0_1, &wq_configurations::INS0_2, &wq_configurations::INS0_3},
+		{&wq_configurations::INS1_1, &wq_configurations::INS1_2, &wq_configurations::INS1_3},
+		{&wq_configurations::INS2_1, &wq_configurations::INS2_2, &wq_configurations::INS2_3},
+		{&wq_configurations::INS3_1, &wq_configurations::INS3_2, &wq_configurations::INS3_3},
+	};
+
+	if ((sub_instance == 0) || (instance >= 4) || (sub_instance > 3)) {
+		return ins_instance_to_wq(instance);
+	}
+
+	return *ins_sub_instance_wq[instance][sub_instance - 1];
+}
+
+#if defined(CONFIG_WORK_QUEUE_POOL)
+struct pool_worker_context_t {
+	WorkQueue *wq;
+	uint8_t index;
+};
+
+static void *
+WorkQueuePoolWorker(void *context)
+{
+	pool_worker_context_t *worker = static_cast<pool_worker_context_t *>(context);
+
+#ifdef __PX4_DARWIN
+	pthread_setname_np(worker->wq->get_name());
+#else
+	pthread_setname_np(pthread_self(), worker->wq->get_name());
+#endif
+
+	worker->wq->Run(worker->index);
+
+	return nullptr;
+}
+
+// start the additional threads of a pooled work queue, they inherit the scheduling of the calling thread
+static int
+WorkQueuePoolStart(WorkQueue &wq, pthread_t *threads, pool_worker_context_t *contexts)
+{
+	const long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+	const int num_workers = math::constrain((int)num_cores, 1, math::min((int)CONFIG_WORK_QUEUE_POOL_MAX_WORKERS,
+					  (int)WorkQueue::MAX_WORKERS));
+
+	wq.set_num_workers(num_workers);
+
+	const unsigned int page_size = sysconf(_SC_PAGESIZE);
+	const size_t stacksize_adj = math::max((int)PTHREAD_STACK_MIN, PX4_STACK_ADJUSTED(wq.get_config().stacksize));
+	const size_t stacksize = (stacksize_adj + page_size - (stacksize_adj % page_size));
+
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, stacksize);
+
+	int started = 0;
+
+	for (int i = 1; i < num_workers; i++) {
+		contexts[started].wq = &wq;
+		contexts[started].index = i;
+
+		int ret_create = pthread_create(&threads[started], &attr, WorkQueuePoolWorker, &contexts[started]);
+
+		if (ret_create == 0) {
+			started++;
+
+		} else {
+			PX4_ERR("failed to create pool thread %d for %s (%i)", i, wq.get_name(), ret_create);
+			break;
+		}
+	}
+
+	pthread_attr_destroy(&attr);
+
+	// the work queue must only expect the threads that are actually running
+	wq.set_num_workers(started + 1);
+
+	PX4_DEBUG("%s: thread pool of %d workers", wq.get_name(), started + 1);
+
+	return started;
+}
+#endif // CONFIG_WORK_QUEUE_POOL
+
 static void *
 WorkQueueRunner(void *context)
 {
 	wq_config_t *config = static_cast<wq_config_t *>(context);
 	WorkQueue wq(*config);
 
+#if defined(CONFIG_WORK_QUEUE_POOL)
+	pthread_t pool_threads[WorkQueue::MAX_WORKERS] {};
+	pool_worker_context_t pool_contexts[WorkQueue::MAX_WORKERS] {};
+	const int num_pool_threads = config->pool ? WorkQueuePoolStart(wq, pool_threads, pool_contexts) : 0;
+#endif // CONFIG_WORK_QUEUE_POOL
+
 	// add to work queue list
 	_wq_manager_wqs_list->add(&wq);
 
 	wq.Run();
 
+#if defined(CONFIG_WORK_QUEUE_POOL)
+
+	for (int i = 0; i < num_pool_threads; i++) {
+		pthread_join(pool_threads[i], nullptr);
+	}
+
+#endif // CONFIG_WORK_QUEUE_POOL
+
 	// remove from work queue list
 	_wq_manager_wqs_list->remove(&wq);
 
 	return nullptr;
 }
 
+#if defined(__PX4_LINUX) && defined(CONFIG_WORK_QUEUE_CPU_AFFINITY)
+/**
+ * Look up the CPUs of a work queue in CONFIG_WORK_QUEUE_CPU_AFFINITY
+ * ("<work queue>=<cpu>[-<cpu>],...", "*" matching all other work queues).
+ *
+ * @return true if the work queue thread should be pinned to cpuset
+ */
+static bool
+WorkQueueCpuAffinity(const char *name, cpu_set_t *cpuset)
+{
+	const char *entry = CONFIG_WORK_QUEUE_CPU_AFFINITY;
+	const size_t name_len = strlen(name);
+
+	// an explicit entry takes precedence over the wildcard
+	long cpu_first = -1;
+	long cpu_last = -1;
+
+	while (*entry != '\0') {
+		const char *separator = strchr(entry, '=');
+
+		if (separator == nullptr) {
+			PX4_ERR("invalid work queue affinity entry: %s", entry);
+			return false;
+		}
+
+		char *end = nullptr;
+		const long first = strtol(separator + 1, &end, 10);
+		long last = first;
+
+		if (*end == '-') {
+			last = strtol(end + 1, &end, 10);
+		}
+
+		if ((first < 0) || (last < first) || (last >= CPU_SETSIZE) || ((*end != ',') && (*end != '\0'))) {
+			PX4_ERR("invalid work queue affinity entry: %s", entry);
+			return false;
+		}
+
+		const size_t entry_name_len = separator - entry;
+
+		if ((entry_name_len == 1) && (entry[0] == '*')) {
+			cpu_first = first;
+			cpu_last = last;
+
+		} else if ((entry_name_len == name_len) && (strncmp(entry, name, name_len) == 0)) {
+			cpu_first = first;
+			cpu_last = last;
+			break;
+		}
+
+		entry = (*end == ',') ? end + 1 : end;
+	}
+
+	if (cpu_first < 0) {
+		return false;
+	}
+
+	CPU_ZERO(cpuset);
+
+	for (long cpu = cpu_first; cpu <= cpu_last; cpu++) {
+		CPU_SET(cpu, cpuset);
+	}
+
+	return true;
+}
+#endif // __PX4_LINUX && CONFIG_WORK_QUEUE_CPU_AFFINITY
+
 #if defined(__PX4_NUTTX) && !defined(CONFIG_BUILD_FLAT)
 // Wrapper for px4_task_spawn_cmd interface
 inline static int
@@ -319,10 +485,44 @@ WorkQueueManagerRun(int, char **)
 				PX4_ERR("setting sched params for %s failed (%i)", wq->name, ret_setschedparam);
 			}
 
+#if defined(CONFIG_WORK_QUEUE_SCHED_FIFO)
+			// the policy and priority above are ignored unless explicitly requested
+			int ret_setinheritsched = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+
+			if (ret_setinheritsched != 0) {
+				PX4_ERR("setting explicit sched for %s failed (%i)", wq->name, ret_setinheritsched);
+			}
+
+#endif // CONFIG_WORK_QUEUE_SCHED_FIFO
+
+#if defined(__PX4_LINUX) && defined(CONFIG_WORK_QUEUE_CPU_AFFINITY)
+			cpu_set_t cpuset;
+
+			if (WorkQueueCpuAffinity(wq->name, &cpuset)) {
+				int ret_setaffinity = pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+
+				if (ret_setaffinity != 0) {
+					PX4_ERR("setting CPU affinity for %s failed (%i)", wq->name, ret_setaffinity);
+				}
+			}
+
+#endif // __PX4_LINUX && CONFIG_WORK_QUEUE_CPU_AFFINITY
+
 			// create thread
 			pthread_t thread;
 			int ret_create = pthread_create(&thread, &attr, WorkQueueRunner, (void *)wq);
 
+#if defined(CONFIG_WORK_QUEUE_SCHED_FIFO)
+
+			if (ret_create == EPERM) {
+				// not permitted to use real-time scheduling (e.g. not running as root), inherit it instead
+				PX4_WARN("%s: no permission for SCHED_FIFO, using inherited scheduling", wq->name);
+				pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+				ret_create = pthread_create(&thread, &attr, WorkQueueRunner, (void *)wq);
+			}
+
+#endif // CONFIG_WORK_QUEUE_SCHED_FIFO
+
 			if (ret_create == 0) {
 				PX4_DEBUG("starting: %s, priority: %d, stack: %zu bytes", wq->name, param.sched_priority, stacksize);
 
@@ -462,12 +662,12 @@ WorkQueueManagerStop()
 }
 
 int
-WorkQueueManagerStatus()
+WorkQueueManagerStatus(bool verbose)
 {
 	if (!_wq_manager_should_exit.load() && _wq_manager_running.load()) {
 
 		const size_t num_wqs = _wq_manager_wqs_list->size();
-		PX4_INFO_RAW("\nWork Queue: %-2zu threads                          RATE        INTERVAL\n", num_wqs);
+		PX4_INFO_RAW("\nWork Queue: %-2zu threads                          RATE        INTERVAL             JITTER\n", num_wqs);
 
 		LockGuard lg{_wq_manager_wqs_list->mutex()};
 		size_t i = 0;
@@ -484,7 +684,7 @@ WorkQueueManagerStatus()
 				PX4_INFO_RAW("\\__ %zu) ", i);
 			}
 
-			wq->print_status(last_wq);
+			wq->print_status(last_wq, verbose);
 		}
 
 	} else {
@@ -494,4 +694,23 @@ WorkQueueManagerStatus()
 	return PX4_OK;
 }
 
+bool
+WorkQueueManagerItemStats(unsigned index, work_item_stats_t &stats)
+{
+	if (_wq_manager_should_exit.load() || !_wq_manager_running.load()) {
+		return false;
+	}
+
+	LockGuard lg{_wq_manager_wqs_list->mutex()};
+
+	for (WorkQueue *wq : *_wq_manager_wqs_list) {
+		// index is advanced past the WorkItems of this queue
+		if (wq->item_stats(index, stats)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 } // namespace px4
@@ -32,7 +32,9 @@
  ****************************************************************************/
 
 #include "wqueue_test.h"
+#include "wqueue_pool_test.h"
 #include "wqueue_scheduled_test.h"
+#include "wqueue_throughput_test.h"
 
 #include <px4_platform_common/log.h>
 #include <px4_platform_common/app.h>
@@ -51,6 +53,14 @@ int PX4_MAIN(int argc, char **argv)
 	WQueueScheduledTest wq2;
 	wq2.main();
 
+	PX4_INFO("wqueue test 3 (throughput)");
+	WQueueThroughputTest wq3;
+	wq3.main();
+
+	PX4_INFO("wqueue test 4 (thread pool)");
+	WQueuePoolTest wq4;
+	wq4.main();
+
 	PX4_INFO("wqueue test complete, exiting");
 
 	return 0;
@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+
+#include "wqueue_pool_test.h"
+
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/px4_work_queue/WorkQueue.hpp>
+#include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
+#include <px4_platform_common/time.h>
+
+#include <inttypes.h>
+
+WQueuePoolTest::BlockingItem::BlockingItem() :
+	px4::WorkItem("WQueuePoolTest", px4::wq_configurations::lp_default)
+{
+	px4_sem_init(&started, 0, 0);
+	px4_sem_init(&proceed, 0, 0);
+}
+
+WQueuePoolTest::BlockingItem::~BlockingItem()
+{
+	px4_sem_destroy(&started);
+	px4_sem_destroy(&proceed);
+}
+
+void WQueuePoolTest::BlockingItem::Run()
+{
+	// only the first run blocks
+	if (runs.fetch_add(1) == 0) {
+		px4_sem_post(&started);
+
+		do {} while (px4_sem_wait(&proceed) != 0);
+	}
+}
+
+int WQueuePoolTest::main()
+{
+	px4::WorkQueue *wq = px4::WorkQueueFindOrCreate(px4::wq_configurations::lp_default);
+
+	if ((wq == nullptr) || (wq->num_workers() < 2)) {
+		PX4_INFO("WQueuePoolTest skipped, %s is not served by a thread pool", px4::wq_configurations::lp_default.name);
+		return 0;
+	}
+
+	BlockingItem item{};
+	BlockingItem keep_alive{}; // keeps the work queue running while item is detached
+
+	item.ScheduleNow();
+
+	do {} while (px4_sem_wait(&item.started) != 0);
+
+	// another worker takes the queued item and leaves it to the running worker to requeue
+	item.ScheduleNow();
+	px4_usleep(20000);
+
+	// detach while Run() is still executing (without the Remove() of WorkItem::Deinit(), as if the item was
+	// scheduled again in between), the worker must forget the item instead of requeueing it
+	wq->Detach(&item);
+
+	px4_sem_post(&item.proceed);
+	px4_usleep(50000);
+
+	const uint32_t runs = item.runs.load();
+
+	wq->Attach(&item);
+
+	if (runs != 1) {
+		PX4_ERR("WQueuePoolTest failed: detached item ran %" PRIu32 " times", runs);
+		return 1;
+	}
+
+	PX4_INFO("WQueuePoolTest finished");
+
+	return 0;
+}
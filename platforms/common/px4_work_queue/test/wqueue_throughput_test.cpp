@@ -0,0 +1,100 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include "wqueue_throughput_test.h"
+
+#include <drivers/drv_hrt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/time.h>
+
+#include <inttypes.h>
+#include <pthread.h>
+
+void *WQueueThroughputTest::producer_entry(void *arg)
+{
+	Consumer *consumer = static_cast<Consumer *>(arg);
+
+	for (int i = 0; i < ADDS_PER_PRODUCER; i++) {
+		consumer->ScheduleNow();
+	}
+
+	return nullptr;
+}
+
+void WQueueThroughputTest::run(int producers)
+{
+	for (int i = 0; i < producers; i++) {
+		_consumers[i].runs.store(0);
+	}
+
+	pthread_t threads[MAX_PRODUCERS] {};
+
+	const hrt_abstime start = hrt_absolute_time();
+
+	for (int i = 0; i < producers; i++) {
+		pthread_create(&threads[i], nullptr, &WQueueThroughputTest::producer_entry, &_consumers[i]);
+	}
+
+	for (int i = 0; i < producers; i++) {
+		pthread_join(threads[i], nullptr);
+	}
+
+	const hrt_abstime elapsed = hrt_elapsed_time(&start);
+
+	// let the work queue drain
+	px4_usleep(100000);
+
+	uint32_t runs = 0;
+
+	for (int i = 0; i < producers; i++) {
+		runs += _consumers[i].runs.load();
+	}
+
+	const float elapsed_s = math::max(elapsed, (hrt_abstime)1) * 1e-6f;
+	const int adds = producers * ADDS_PER_PRODUCER;
+
+	PX4_INFO("%d producers: %d adds in %.3f s, %.0f adds/s, %.0f items/s run (%" PRIu32 ")",
+		 producers, adds, (double)elapsed_s, (double)(adds / elapsed_s), (double)(runs / elapsed_s), runs);
+}
+
+int WQueueThroughputTest::main()
+{
+	for (int producers = 1; producers <= MAX_PRODUCERS; producers *= 2) {
+		run(producers);
+	}
+
+	PX4_INFO("WQueueThroughputTest finished");
+
+	return 0;
+}
@@ -131,6 +131,31 @@ public:
 
 		return (Manager::orb_publish(get_topic(), _handle, &data) == PX4_OK);
 	}
+
+#if defined(CONFIG_ORB_LOAN)
+	/**
+	 * Loan the buffer of the next publication to fill it in place, avoiding the copy of publish().
+	 * The buffer holds stale data and all fields have to be set. Every successful loan()
+	 * must be followed by publish_loaned(), other publishers of the topic block until then.
+	 * @return the buffer, or nullptr if the topic cannot be loaned (use publish() instead)
+	 */
+	T *loan()
+	{
+		if (!advertised()) {
+			advertise();
+		}
+
+		return static_cast<T *>(Manager::orb_loan(_handle));
+	}
+
+	/**
+	 * Publish the buffer returned by loan()
+	 */
+	bool publish_loaned()
+	{
+		return (Manager::orb_publish_loan(get_topic(), _handle) == PX4_OK);
+	}
+#endif // CONFIG_ORB_LOAN
 };
 
 /**
@@ -171,6 +171,31 @@ public:
 		return valid() ? Manager::orb_data_copy(_node, dst, _last_generation, false) : false;
 	}
 
+#if defined(CONFIG_ORB_LOAN)
+	/**
+	 * Borrow the next update in place instead of copying it.
+	 * The publisher may overwrite the message while it is being read, so the
+	 * result must only be used if borrow_valid() returns true afterwards.
+	 * @return pointer to the message, nullptr if there is no update
+	 */
+	const void *borrow()
+	{
+		if (!valid()) {
+			subscribe();
+		}
+
+		return valid() ? Manager::orb_data_borrow(_node, _last_generation, _borrowed_generation) : nullptr;
+	}
+
+	/**
+	 * Check that the message returned by the last borrow() was not modified until now.
+	 */
+	bool borrow_valid() const
+	{
+		return valid() && Manager::orb_borrow_valid(_node, _borrowed_generation);
+	}
+#endif // CONFIG_ORB_LOAN
+
 	/**
 	 * Change subscription instance
 	 * @param instance The new multi-Subscription instance
@@ -194,6 +219,10 @@ protected:
 
 	unsigned _last_generation{0}; /**< last generation the subscriber has seen */
 
+#if defined(CONFIG_ORB_LOAN)
+	unsigned _borrowed_generation{0}; /**< generation of the message returned by the last borrow() */
+#endif // CONFIG_ORB_LOAN
+
 	ORB_ID _orb_id{ORB_ID::INVALID};
 	uint8_t _instance{0};
 };
@@ -163,8 +163,8 @@ uORB::DeviceNode::read(cdev::file_t *filp, char *buffer, size_t buflen)
 	return filp_to_subscription(filp)->copy(buffer) ? _meta->o_size : 0;
 }
 
-ssize_t
-uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
+bool
+uORB::DeviceNode::allocate_data()
 {
 	/*
 	 * Writes are legal from interrupt context as long as the
@@ -172,8 +172,6 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 	 *
 	 * Writes outside interrupt context will allocate the object
 	 * if it has not yet been allocated.
-	 *
-	 * Note that filp will usually be NULL.
 	 */
 	if (nullptr == _data) {
 
@@ -186,12 +184,15 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 
 			/* re-check size */
 			if (nullptr == _data) {
-				const size_t data_size = _meta->o_size * _queue_size;
-				_data = (uint8_t *) px4_cache_aligned_alloc(data_size);
+				const size_t data_size = _meta->o_size * slot_count();
+				uint8_t *data = (uint8_t *) px4_cache_aligned_alloc(data_size);
 
-				if (_data) {
-					memset(_data, 0, data_size);
+				if (data) {
+					memset(data, 0, data_size);
 				}
+
+				// lock-free readers must never see the buffer before it is initialized
+				__atomic_store_n(&_data, data, __ATOMIC_RELEASE);
 			}
 
 			unlock();
@@ -200,11 +201,18 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 		}
 
 #endif /* __PX4_NUTTX */
+	}
 
-		/* failed or could not allocate */
-		if (nullptr == _data) {
-			return -ENOMEM;
-		}
+	/* failed or could not allocate */
+	return (nullptr != _data);
+}
+
+ssize_t
+uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
+{
+	/* Note that filp will usually be NULL. */
+	if (!allocate_data()) {
+		return -ENOMEM;
 	}
 
 	/* If write size does not match, that is an error */
@@ -214,10 +222,24 @@ uORB::DeviceNode::write(cdev::file_t *filp, const char *buffer, size_t buflen)
 
 	/* Perform an atomic copy. */
 	ATOMIC_ENTER;
+#if defined(CONFIG_ORB_SEQLOCK)
+	/* publishers are still serialized by ATOMIC_ENTER, readers only observe the write sequence */
+	const unsigned generation = _generation.load();
+
+	/* announce the write before touching the slot, so concurrent readers of this slot retry */
+	_write_generation.store(generation + 1);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	memcpy(slot(generation), buffer, _meta->o_size);
+
+	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
+	release_generation(generation + 1);
+#else
 	/* wrap-around happens after ~49 days, assuming a publisher rate of 1 kHz */
 	unsigned generation = _generation.fetch_add(1);
 
-	memcpy(_data + (_meta->o_size * (generation % _queue_size)), buffer, _meta->o_size);
+	memcpy(slot(generation), buffer, _meta->o_size);
+#endif /* CONFIG_ORB_SEQLOCK */
 
 	// callbacks
 	for (auto item : _callbacks) {
@@ -325,6 +347,115 @@ uORB::DeviceNode::publish(const orb_metadata *meta, orb_advert_t handle, const v
 	return PX4_OK;
 }
 
+#if defined(CONFIG_ORB_LOAN)
+void *
+uORB::DeviceNode::loan()
+{
+	if (!allocate_data()) {
+		return nullptr;
+	}
+
+	// ATOMIC_ENTER on POSIX, held until publish_loan()
+	lock();
+
+	const unsigned generation = _generation.load();
+
+	/* announce the write before handing out the slot, so concurrent readers of this slot retry */
+	_write_generation.store(generation + 1);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	return slot(generation);
+}
+
+ssize_t
+uORB::DeviceNode::publish_loan(const orb_metadata *meta, orb_advert_t handle)
+{
+	uORB::DeviceNode *devnode = (uORB::DeviceNode *)handle;
+
+	if ((devnode == nullptr) || (meta == nullptr)) {
+		errno = EFAULT;
+		return PX4_ERROR;
+	}
+
+	if (devnode->_meta->o_id != meta->o_id) {
+		errno = EINVAL;
+		return PX4_ERROR;
+	}
+
+	const unsigned generation = devnode->_generation.load();
+
+	// the slot was loaned by loan(), the node is still locked
+	devnode->release_generation(generation + 1);
+
+	// callbacks
+	for (auto item : devnode->_callbacks) {
+		item->call();
+	}
+
+	/* Mark at least one data has been published */
+	devnode->_data_valid = true;
+
+	int ret = PX4_OK;
+
+#ifdef CONFIG_ORB_COMMUNICATOR
+	/*
+	 * send the data over the Multi-ORB link while the node is still locked: once unlocked,
+	 * later publications may overwrite the slot
+	 */
+	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
+
+	if (ch != nullptr) {
+		if (ch->send_message(meta->o_name, meta->o_size, devnode->slot(generation)) != 0) {
+			PX4_ERR("Error Sending [%s] topic data over comm_channel", meta->o_name);
+			ret = PX4_ERROR;
+		}
+	}
+
+#endif /* CONFIG_ORB_COMMUNICATOR */
+
+	devnode->unlock();
+
+	/* notify any poll waiters */
+	devnode->poll_notify(POLLIN);
+
+	return ret;
+}
+
+const void *
+uORB::DeviceNode::borrow(unsigned &generation, unsigned &slot_generation)
+{
+	if (_data == nullptr) {
+		return nullptr;
+	}
+
+	const unsigned current_generation = acquire_generation();
+
+	if (_queue_size == 1) {
+		slot_generation = current_generation - 1;
+		generation = current_generation;
+
+	} else {
+		if (current_generation == generation) {
+			/* The subscriber already read the latest message, but nothing new was published yet.
+			* Return the previous message
+			*/
+			--generation;
+		}
+
+		// Compatible with normal and overflow conditions
+		if (!is_in_range(current_generation - _queue_size, generation, current_generation - 1)) {
+			// Reader is too far behind: some messages are lost
+			generation = current_generation - _queue_size;
+		}
+
+		slot_generation = generation;
+		++generation;
+	}
+
+	return slot(slot_generation);
+}
+#endif /* CONFIG_ORB_LOAN */
+
 int uORB::DeviceNode::unadvertise(orb_advert_t handle)
 {
 	if (handle == nullptr) {
@@ -447,7 +578,7 @@ int16_t uORB::DeviceNode::process_add_subscription()
 	uORBCommunicator::IChannel *ch = uORB::Manager::get_instance()->get_uorb_communicator();
 
 	if (_data != nullptr && ch != nullptr) { // _data will not be null if there is a publisher.
-		ch->send_message(_meta->o_name, _meta->o_size, _data);
+		ch->send_message(_meta->o_name, _meta->o_size, slot(_generation.load() - 1));
 	}
 
 	return PX4_OK;
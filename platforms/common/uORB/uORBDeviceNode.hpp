@@ -234,6 +234,44 @@ public:
 	bool copy(void *dst, unsigned &generation)
 	{
 		if ((dst != nullptr) && (_data != nullptr)) {
+#if defined(CONFIG_ORB_SEQLOCK)
+
+			// Lock-free read: copy the slot, then check that no publication touching
+			// that slot started in the meantime. Retry on a (rare) collision.
+			for (;;) {
+				const unsigned current_generation = acquire_generation();
+				unsigned read_generation = generation;
+
+				if (_queue_size == 1) {
+					read_generation = current_generation;
+
+				} else {
+					if (current_generation == read_generation) {
+						/* The subscriber already read the latest message, but nothing new was published yet.
+						* Return the previous message
+						*/
+						--read_generation;
+					}
+
+					// Compatible with normal and overflow conditions
+					if (!is_in_range(current_generation - _queue_size, read_generation, current_generation - 1)) {
+						// Reader is too far behind: some messages are lost
+						read_generation = current_generation - _queue_size;
+					}
+				}
+
+				const unsigned slot_generation = (_queue_size == 1) ? read_generation - 1 : read_generation;
+
+				memcpy(dst, slot(slot_generation), _meta->o_size);
+
+				if (slot_valid(slot_generation)) {
+					generation = (_queue_size == 1) ? read_generation : read_generation + 1;
+					return true;
+				}
+			}
+
+#else
+
 			if (_queue_size == 1) {
 				ATOMIC_ENTER;
 				memcpy(dst, _data, _meta->o_size);
@@ -258,19 +296,53 @@ public:
 					generation = current_generation - _queue_size;
 				}
 
-				memcpy(dst, _data + (_meta->o_size * (generation % _queue_size)), _meta->o_size);
+				memcpy(dst, slot(generation), _meta->o_size);
 				ATOMIC_LEAVE;
 
 				++generation;
 
 				return true;
 			}
+
+#endif /* CONFIG_ORB_SEQLOCK */
 		}
 
 		return false;
 
 	}
 
+#if defined(CONFIG_ORB_LOAN)
+	/**
+	 * Loan the queue slot the next publication will be written to, so that the
+	 * publisher can fill it in place instead of copying a message in.
+	 * Other publishers of this node are blocked until publish_loan() is called,
+	 * which must always follow a successful loan.
+	 * @return pointer to the slot (holding stale data), nullptr on failure
+	 */
+	void *loan();
+
+	/**
+	 * Publish the slot previously returned by loan().
+	 */
+	static ssize_t publish_loan(const orb_metadata *meta, orb_advert_t handle);
+
+	/**
+	 * Returns a read-only view of the message following 'generation' without
+	 * copying it, and advances 'generation' like copy() does.
+	 *
+	 * The view may be overwritten by later publications. After reading, the
+	 * caller has to confirm with borrow_valid(slot_generation) that the data
+	 * was consistent.
+	 *
+	 * @param generation The generation of the subscriber.
+	 * @param slot_generation The generation of the returned slot.
+	 * @return pointer to the message, nullptr if no data is available
+	 */
+	const void *borrow(unsigned &generation, unsigned &slot_generation);
+
+	bool borrow_valid(unsigned slot_generation) const { return slot_valid(slot_generation); }
+#endif /* CONFIG_ORB_LOAN */
+
 	// add item to list of work items to schedule on node update
 	bool register_callback(SubscriptionCallback *callback_sub);
 
@@ -291,6 +363,9 @@ private:
 	uint8_t *_data{nullptr};   /**< allocated object buffer */
 	bool _data_valid{false}; /**< At least one valid data */
 	px4::atomic<unsigned>  _generation{0};  /**< object generation count */
+#if defined(CONFIG_ORB_SEQLOCK)
+	px4::atomic<unsigned>  _write_generation{0}; /**< generation of the most recently started write (seqlock) */
+#endif /* CONFIG_ORB_SEQLOCK */
 	List<uORB::SubscriptionCallback *>	_callbacks;
 
 	const uint8_t _instance; /**< orb multi instance identifier */
@@ -299,6 +374,57 @@ private:
 	int8_t _subscriber_count{0};
 
 
+	/**
+	 * Number of message slots in the buffer. With the seqlock, topics without a queue are
+	 * double-buffered so that readers of the latest message never collide with the publisher.
+	 */
+	uint8_t slot_count() const
+	{
+#if defined(CONFIG_ORB_SEQLOCK)
+		return (_queue_size == 1) ? 2 : _queue_size;
+#else
+		return _queue_size;
+#endif /* CONFIG_ORB_SEQLOCK */
+	}
+
+	uint8_t *slot(unsigned generation) const { return _data + (_meta->o_size * (generation % slot_count())); }
+
+#if defined(CONFIG_ORB_SEQLOCK)
+	/**
+	 * Read the generation of the latest completed publication (acquire): the slot data written
+	 * before the matching release_generation() is visible afterwards.
+	 */
+	unsigned acquire_generation() const
+	{
+		const unsigned generation = _generation.load();
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return generation;
+	}
+
+	/**
+	 * Complete a publication (release), after the slot data was written.
+	 */
+	void release_generation(unsigned generation)
+	{
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		_generation.store(generation);
+	}
+
+	/**
+	 * Check (after reading it) that the slot of 'generation' was not touched by a publication,
+	 * which only happens once the write of 'generation + slot_count()' has started.
+	 * The acquire fence orders the slot reads before the re-check, and pairs with the release
+	 * fence between the _write_generation store and the slot writes of the publisher.
+	 */
+	bool slot_valid(unsigned generation) const
+	{
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return (_write_generation.load() - generation) <= slot_count();
+	}
+#endif /* CONFIG_ORB_SEQLOCK */
+
+	bool allocate_data();
+
 // Determine the data range
 	static inline bool is_in_range(unsigned left, unsigned value, unsigned right)
 	{
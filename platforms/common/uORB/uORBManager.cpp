@@ -385,6 +385,30 @@ int uORB::Manager::orb_publish(const struct orb_metadata *meta, orb_advert_t han
 	return uORB::DeviceNode::publish(meta, handle, data);
 }
 
+#if defined(CONFIG_ORB_LOAN)
+void *uORB::Manager::orb_loan(orb_advert_t handle)
+{
+	if (handle == nullptr) {
+		return nullptr;
+	}
+
+#ifdef ORB_USE_PUBLISHER_RULES
+
+	if (handle == _Instance) {
+		return nullptr;
+	}
+
+#endif /* ORB_USE_PUBLISHER_RULES */
+
+	return static_cast<DeviceNode *>(handle)->loan();
+}
+
+int uORB::Manager::orb_publish_loan(const struct orb_metadata *meta, orb_advert_t handle)
+{
+	return uORB::DeviceNode::publish_loan(meta, handle);
+}
+#endif /* CONFIG_ORB_LOAN */
+
 int uORB::Manager::orb_copy(const struct orb_metadata *meta, int handle, void *buffer)
 {
 	int ret;
@@ -468,6 +492,26 @@ bool uORB::Manager::orb_data_copy(void *node_handle, void *dst, unsigned &genera
 	return static_cast<DeviceNode *>(node_handle)->copy(dst, generation);
 }
 
+#if defined(CONFIG_ORB_LOAN)
+const void *uORB::Manager::orb_data_borrow(void *node_handle, unsigned &generation, unsigned &slot_generation)
+{
+	if (!is_advertised(node_handle)) {
+		return nullptr;
+	}
+
+	if (!static_cast<const uORB::DeviceNode *>(node_handle)->updates_available(generation)) {
+		return nullptr;
+	}
+
+	return static_cast<DeviceNode *>(node_handle)->borrow(generation, slot_generation);
+}
+
+bool uORB::Manager::orb_borrow_valid(const void *node_handle, unsigned slot_generation)
+{
+	return static_cast<const DeviceNode *>(node_handle)->borrow_valid(slot_generation);
+}
+#endif /* CONFIG_ORB_LOAN */
+
 // add item to list of work items to schedule on node update
 bool uORB::Manager::register_callback(void *node_handle, SubscriptionCallback *callback_sub)
 {
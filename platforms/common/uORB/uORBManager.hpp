@@ -284,6 +284,30 @@ public:
 	 */
 	static int  orb_publish(const struct orb_metadata *meta, orb_advert_t handle, const void *data);
 
+#if defined(CONFIG_ORB_LOAN)
+	/**
+	 * Loan the buffer of the next publication of a topic, to be filled in place.
+	 *
+	 * Other publishers of the topic are blocked until the loan is published with
+	 * orb_publish_loan(), which must always follow a successful loan. The loaned
+	 * buffer contains stale data and has to be filled completely.
+	 *
+	 * @handle    The handle returned from orb_advertise.
+	 * @return    Pointer to the loaned buffer, nullptr if the topic cannot be loaned.
+	 */
+	static void *orb_loan(orb_advert_t handle);
+
+	/**
+	 * Publish the buffer previously loaned with orb_loan().
+	 *
+	 * @param meta    The uORB metadata (usually from the ORB_ID() macro)
+	 *      for the topic.
+	 * @handle    The handle returned from orb_advertise.
+	 * @return    OK on success, PX4_ERROR otherwise with errno set accordingly.
+	 */
+	static int  orb_publish_loan(const struct orb_metadata *meta, orb_advert_t handle);
+#endif /* CONFIG_ORB_LOAN */
+
 	/**
 	 * Subscribe to a topic.
 	 *
@@ -447,6 +471,12 @@ public:
 
 	static bool orb_data_copy(void *node_handle, void *dst, unsigned &generation, bool only_if_updated);
 
+#if defined(CONFIG_ORB_LOAN)
+	static const void *orb_data_borrow(void *node_handle, unsigned &generation, unsigned &slot_generation);
+
+	static bool orb_borrow_valid(const void *node_handle, unsigned slot_generation);
+#endif /* CONFIG_ORB_LOAN */
+
 	static bool register_callback(void *node_handle, SubscriptionCallback *callback_sub);
 
 	static void unregister_callback(void *node_handle, SubscriptionCallback *callback_sub);
@@ -39,7 +39,9 @@
 #include <errno.h>
 #include <math.h>
 #include <lib/cdev/CDev.hpp>
+#include <uORB/Publication.hpp>
 #include <uORB/PublicationMulti.hpp>
+#include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionMultiArray.hpp>
 
 uORBTest::UnitTest &uORBTest::UnitTest::instance()
@@ -206,7 +208,18 @@ int uORBTest::UnitTest::test()
 		return ret;
 	}
 
-	return test_queue_poll_notify();
+	ret = test_queue_poll_notify();
+
+#if defined(CONFIG_ORB_LOAN)
+
+	if (ret != OK) {
+		return ret;
+	}
+
+	ret = test_loan();
+#endif // CONFIG_ORB_LOAN
+
+	return ret;
 }
 
 int uORBTest::UnitTest::test_unadvertise()
@@ -1117,3 +1130,55 @@ int uORBTest::UnitTest::pubsubtest_threadEntry(int argc, char *argv[])
 	uORBTest::UnitTest &t = uORBTest::UnitTest::instance();
 	return t.pubsublatency_main();
 }
+
+#if defined(CONFIG_ORB_LOAN)
+int uORBTest::UnitTest::test_loan()
+{
+	test_note("Testing loaned publications");
+
+	uORB::Publication<orb_test_large_s> pub{ORB_ID(orb_test_large)};
+	uORB::Subscription sub{ORB_ID(orb_test_large)};
+
+	for (int i = 0; i < 10; i++) {
+		orb_test_large_s *loaned = pub.loan();
+
+		if (loaned == nullptr) {
+			return test_fail("loan %i failed", i);
+		}
+
+		loaned->timestamp = hrt_absolute_time();
+		loaned->val = i;
+		memset(loaned->junk, i, sizeof(loaned->junk));
+
+		if (!pub.publish_loaned()) {
+			return test_fail("publish loan %i failed", i);
+		}
+
+		const orb_test_large_s *borrowed = static_cast<const orb_test_large_s *>(sub.borrow());
+
+		if (borrowed == nullptr) {
+			return test_fail("borrow %i failed", i);
+		}
+
+		if ((borrowed->val != i) || (borrowed->junk[sizeof(borrowed->junk) - 1] != i)) {
+			return test_fail("borrowed wrong element (got %i, should be %i)", borrowed->val, i);
+		}
+
+		if (!sub.borrow_valid()) {
+			return test_fail("borrowed element %i not valid", i);
+		}
+
+		if (sub.borrow() != nullptr) {
+			return test_fail("spurious borrow %i", i);
+		}
+
+		orb_test_large_s copied{};
+
+		if (!sub.copy(&copied) || (copied.val != i)) {
+			return test_fail("copy of loaned element %i failed", i);
+		}
+	}
+
+	return test_note("PASS loaned publications");
+}
+#endif // CONFIG_ORB_LOAN
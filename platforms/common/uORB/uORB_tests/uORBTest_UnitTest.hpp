@@ -113,6 +113,10 @@ private:
 	static int pub_test_queue_entry(int argc, char *argv[]);
 	int pub_test_queue_main();
 	int test_queue_poll_notify();
+
+#if defined(CONFIG_ORB_LOAN)
+	int test_loan();
+#endif // CONFIG_ORB_LOAN
 	volatile int _num_messages_sent = 0;
 
 	int test_fail(const char *fmt, ...);
@@ -46,6 +46,7 @@
 #include <drivers/drv_hrt.h>
 
 #include <semaphore.h>
+#include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #include <errno.h>
@@ -61,9 +62,22 @@ static constexpr unsigned HRT_INTERVAL_MIN = 50;
 static constexpr unsigned HRT_INTERVAL_MAX = 50000000;
 
 /*
- * Queue of callout entries.
+ * Queue of callout entries, kept as a binary min-heap ordered by deadline.
+ * Entries with equal deadlines are ordered by insertion (sequence), like the
+ * sorted list this replaced, so that callouts stay deterministic in lockstep.
  */
-static struct sq_queue_s	callout_queue;
+struct callout_node {
+	hrt_abstime	deadline;
+	uint32_t	sequence;
+	struct hrt_call	*call;
+};
+
+static constexpr unsigned CALLOUT_HEAP_INITIAL_CAPACITY = 32;
+
+static callout_node	*callout_heap;
+static unsigned		callout_heap_size;
+static unsigned		callout_heap_capacity;
+static uint32_t		callout_sequence;
 
 /* latency baseline (last compare value applied) */
 static uint64_t			latency_baseline;
@@ -84,6 +98,8 @@ static void hrt_latency_update();
 static void hrt_call_reschedule();
 static void hrt_call_invoke();
 
+static void callout_remove(struct hrt_call *entry);
+
 static void hrt_lock()
 {
 	// loop as the wait may be interrupted by a signal
@@ -138,7 +154,7 @@ bool	hrt_called(struct hrt_call *entry)
 void	hrt_cancel(struct hrt_call *entry)
 {
 	hrt_lock();
-	sq_rem(&entry->link, &callout_queue);
+	callout_remove(entry);
 	entry->deadline = 0;
 
 	/* if this is a periodic call being removed by the callout, prevent it from
@@ -191,7 +207,10 @@ void	hrt_call_delay(struct hrt_call *entry, hrt_abstime delay)
  */
 void	hrt_init()
 {
-	sq_init(&callout_queue);
+	free(callout_heap);
+	callout_heap = nullptr;
+	callout_heap_size = 0;
+	callout_heap_capacity = 0;
 
 	int sem_ret = px4_sem_init(&_hrt_lock, 0, 1);
 
@@ -202,29 +221,136 @@ void	hrt_init()
 	memset(&_hrt_work, 0, sizeof(_hrt_work));
 }
 
+static bool
+callout_before(const callout_node &a, const callout_node &b)
+{
+	if (a.deadline != b.deadline) {
+		return a.deadline < b.deadline;
+	}
+
+	// wrap-around safe comparison of the insertion order
+	return (int32_t)(a.sequence - b.sequence) < 0;
+}
+
+static void
+callout_place(unsigned index, const callout_node &node)
+{
+	callout_heap[index] = node;
+	node.call->heap_index = index + 1;
+}
+
+static void
+callout_sift_up(unsigned index)
+{
+	const callout_node node = callout_heap[index];
+
+	while (index > 0) {
+		const unsigned parent = (index - 1) / 2;
+
+		if (!callout_before(node, callout_heap[parent])) {
+			break;
+		}
+
+		callout_place(index, callout_heap[parent]);
+		index = parent;
+	}
+
+	callout_place(index, node);
+}
+
+static void
+callout_sift_down(unsigned index)
+{
+	const callout_node node = callout_heap[index];
+
+	while (true) {
+		unsigned child = 2 * index + 1;
+
+		if (child >= callout_heap_size) {
+			break;
+		}
+
+		if ((child + 1 < callout_heap_size) && callout_before(callout_heap[child + 1], callout_heap[child])) {
+			child++;
+		}
+
+		if (!callout_before(callout_heap[child], node)) {
+			break;
+		}
+
+		callout_place(index, callout_heap[child]);
+		index = child;
+	}
+
+	callout_place(index, node);
+}
+
+static struct hrt_call *
+callout_peek()
+{
+	return (callout_heap_size > 0) ? callout_heap[0].call : nullptr;
+}
+
+/*
+ * The entry might be uninitialised (see hrt_call_internal()), so only trust
+ * heap_index if the heap slot actually points back to the entry.
+ */
+static bool
+callout_queued(const struct hrt_call *entry)
+{
+	return (entry->heap_index > 0) && (entry->heap_index <= callout_heap_size)
+	       && (callout_heap[entry->heap_index - 1].call == entry);
+}
+
+static void
+callout_remove(struct hrt_call *entry)
+{
+	if (!callout_queued(entry)) {
+		return;
+	}
+
+	const unsigned index = entry->heap_index - 1;
+	entry->heap_index = 0;
+
+	callout_heap_size--;
+
+	if (index != callout_heap_size) {
+		// move the last node into the hole, it may need to go either way
+		callout_place(index, callout_heap[callout_heap_size]);
+
+		if ((index > 0) && callout_before(callout_heap[index], callout_heap[(index - 1) / 2])) {
+			callout_sift_up(index);
+
+		} else {
+			callout_sift_down(index);
+		}
+	}
+}
+
 static void
 hrt_call_enter(struct hrt_call *entry)
 {
-	struct hrt_call	*call, *next;
+	if (callout_heap_size == callout_heap_capacity) {
+		const unsigned capacity = (callout_heap_capacity == 0) ? CALLOUT_HEAP_INITIAL_CAPACITY : 2 * callout_heap_capacity;
+		callout_node *heap = (callout_node *)realloc(callout_heap, capacity * sizeof(callout_node));
 
-	call = (struct hrt_call *)sq_peek(&callout_queue);
+		if (heap == nullptr) {
+			PX4_ERR("callout queue allocation failed");
+			entry->deadline = 0;
+			return;
+		}
 
-	if ((call == nullptr) || (entry->deadline < call->deadline)) {
-		sq_addfirst(&entry->link, &callout_queue);
-		//if (call != nullptr) PX4_INFO("call enter at head, reschedule (%lu %lu)", entry->deadline, call->deadline);
-		/* we changed the next deadline, reschedule the timer event */
-		hrt_call_reschedule();
+		callout_heap = heap;
+		callout_heap_capacity = capacity;
+	}
 
-	} else {
-		do {
-			next = (struct hrt_call *)sq_next(&call->link);
+	const unsigned index = callout_heap_size++;
+	callout_place(index, callout_node{entry->deadline, callout_sequence++, entry});
+	callout_sift_up(index);
 
-			if ((next == nullptr) || (entry->deadline < next->deadline)) {
-				//lldbg("call enter after head\n");
-				sq_addafter(&call->link, &entry->link, &callout_queue);
-				break;
-			}
-		} while ((call = next) != nullptr);
+	if (entry->heap_index == 1) {
+		/* we changed the next deadline, reschedule the timer event */
+		hrt_call_reschedule();
 	}
 }
 
@@ -263,7 +389,7 @@ hrt_call_reschedule()
 {
 	hrt_abstime	now = hrt_absolute_time();
 	hrt_abstime	delay = HRT_INTERVAL_MAX;
-	struct hrt_call	*next = (struct hrt_call *)sq_peek(&callout_queue);
+	struct hrt_call	*next = callout_peek();
 	hrt_abstime	deadline = now + HRT_INTERVAL_MAX;
 
 	/*
@@ -312,14 +438,12 @@ hrt_call_internal(struct hrt_call *entry, hrt_abstime deadline, hrt_abstime inte
 	//PX4_INFO("hrt_call_internal after lock");
 	/* if the entry is currently queued, remove it */
 	/* note that we are using a potentially uninitialised
-	   entry->link here, but it is safe as sq_rem() doesn't
-	   dereference the passed node unless it is found in the
-	   list. So we potentially waste a bit of time searching the
-	   queue for the uninitialised entry->link but we don't do
-	   anything actually unsafe.
+	   entry->heap_index here, but it is safe as callout_remove()
+	   only touches the heap if the indexed slot refers to
+	   this entry.
 	*/
 	if (entry->deadline != 0) {
-		sq_rem(&entry->link, &callout_queue);
+		callout_remove(entry);
 	}
 
 #if 1
@@ -391,7 +515,7 @@ hrt_call_invoke()
 		/* get the current time */
 		hrt_abstime now = hrt_absolute_time();
 
-		call = (struct hrt_call *)sq_peek(&callout_queue);
+		call = callout_peek();
 
 		if (call == nullptr) {
 			break;
@@ -401,7 +525,7 @@ hrt_call_invoke()
 			break;
 		}
 
-		sq_rem(&call->link, &callout_queue);
+		callout_remove(call);
 		//PX4_INFO("call pop");
 
 		/* save the intended deadline for periodic calls */
@@ -41,6 +41,7 @@
 
 #include "stm32_can.h"
 
+#include <drivers/drv_hrt.h>
 #include <px4_platform_common/log.h>
 
 int CanardNuttXCDev::init()
@@ -140,6 +141,7 @@ int16_t CanardNuttXCDev::receive(CanardRxFrame *received_frame)
 			return -1;
 
 		} else {
+			received_frame->timestamp_usec = hrt_absolute_time();
 			received_frame->frame.extended_can_id = receive_msg.cm_hdr.ch_id;
 			received_frame->frame.payload_size = receive_msg.cm_hdr.ch_dlc;
 			memcpy((void *)received_frame->frame.payload, receive_msg.cm_data, receive_msg.cm_hdr.ch_dlc);
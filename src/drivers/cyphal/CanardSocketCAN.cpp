@@ -131,23 +131,31 @@ int CanardSocketCAN::init()
 	_send_cmsg->cmsg_len = sizeof(struct timeval);
 	_send_tv = (struct timeval *)CMSG_DATA(_send_cmsg);
 
-	// Setup RX msg
-	_recv_iov.iov_base = &_recv_frame;
+	// Setup RX msgs
+	for (int i = 0; i < RX_BATCH_SIZE; i++) {
+		_recv_iov[i].iov_base = &_recv_frame[i];
 
-	if (can_fd) {
-		_recv_iov.iov_len = sizeof(struct canfd_frame);
+		if (can_fd) {
+			_recv_iov[i].iov_len = sizeof(struct canfd_frame);
 
-	} else {
-		_recv_iov.iov_len = sizeof(struct can_frame);
+		} else {
+			_recv_iov[i].iov_len = sizeof(struct can_frame);
+		}
+
+#if defined(CONFIG_CYPHAL_SOCKETCAN_RECVMMSG)
+		struct msghdr &recv_msg = _recv_msg[i].msg_hdr;
+#else
+		struct msghdr &recv_msg = _recv_msg[i];
+#endif
+		recv_msg.msg_iov = &_recv_iov[i];
+		recv_msg.msg_iovlen = 1;
+		recv_msg.msg_control = &_recv_control[i];
 	}
 
 	memset(_recv_control, 0x00, sizeof(_recv_control));
 
-	_recv_msg.msg_iov = &_recv_iov;
-	_recv_msg.msg_iovlen = 1;
-	_recv_msg.msg_control = &_recv_control;
-	_recv_msg.msg_controllen = sizeof(_recv_control);
-	_recv_cmsg = CMSG_FIRSTHDR(&_recv_msg);
+	_recv_count = 0;
+	_recv_index = 0;
 
 	return 0;
 }
@@ -177,34 +185,92 @@ int16_t CanardSocketCAN::transmit(const CanardTxQueueItem &txf, int timeout_ms)
 	return sendmsg(_fd, &_send_msg, 0);
 }
 
+int CanardSocketCAN::fill_receive_buffer()
+{
+	_recv_count = 0;
+	_recv_index = 0;
+
+#if defined(CONFIG_CYPHAL_SOCKETCAN_RECVMMSG)
+
+	for (int i = 0; i < RX_BATCH_SIZE; i++) {
+		// the control length is updated on reception
+		_recv_msg[i].msg_hdr.msg_controllen = sizeof(_recv_control[i]);
+	}
+
+	// read all pending frames (up to RX_BATCH_SIZE) with a single syscall
+	int result = recvmmsg(_fd, _recv_msg, RX_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+
+#else
+	_recv_msg[0].msg_controllen = sizeof(_recv_control[0]);
+
+	int result = recvmsg(_fd, &_recv_msg[0], MSG_DONTWAIT);
+
+	if (result >= 0) {
+		result = 1;
+	}
+
+#endif
+
+	if (result > 0) {
+		_recv_count = result;
+	}
+
+	return result;
+}
+
 int16_t CanardSocketCAN::receive(CanardRxFrame *rxf)
 {
-	int32_t result = recvmsg(_fd, &_recv_msg, MSG_DONTWAIT);
+	if (_recv_index >= _recv_count) {
+		int result = fill_receive_buffer();
 
-	if (result < 0) {
-		return result;
+		if (result <= 0) {
+			return result;
+		}
 	}
 
+	const int index = _recv_index++;
+
+#if defined(CONFIG_CYPHAL_SOCKETCAN_RECVMMSG)
+	struct msghdr *recv_msg = &_recv_msg[index].msg_hdr;
+#else
+	struct msghdr *recv_msg = &_recv_msg[index];
+#endif
+
+	int16_t result;
+
 	/* Copy CAN frame to CanardFrame */
 
 	if (_can_fd) {
-		struct canfd_frame *recv_frame = (struct canfd_frame *)&_recv_frame;
+		struct canfd_frame *recv_frame = &_recv_frame[index];
 		rxf->frame.extended_can_id = recv_frame->can_id & CAN_EFF_MASK;
 		rxf->frame.payload_size = recv_frame->len;
 		rxf->frame.payload = &recv_frame->data;
+		result = sizeof(struct canfd_frame);
 
 	} else {
-		struct can_frame *recv_frame = (struct can_frame *)&_recv_frame;
+		struct can_frame *recv_frame = (struct can_frame *)&_recv_frame[index];
 		rxf->frame.extended_can_id = recv_frame->can_id & CAN_EFF_MASK;
 		rxf->frame.payload_size = recv_frame->can_dlc;
 		rxf->frame.payload = &recv_frame->data; //FIXME either copy or clearly state the pointer reference
+		result = sizeof(struct can_frame);
 	}
 
-	/* Read SO_TIMESTAMP value */
+	/* Read SO_TIMESTAMP value (taken by the driver on reception) and convert it from the monotonic clock to hrt */
+
+	rxf->timestamp_usec = hrt_absolute_time();
 
-	if (_recv_cmsg->cmsg_level == SOL_SOCKET && _recv_cmsg->cmsg_type == SO_TIMESTAMP) {
-		struct timeval *tv = (struct timeval *)CMSG_DATA(_recv_cmsg);
-		rxf->timestamp_usec = tv->tv_sec * 1000000ULL + tv->tv_usec;
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(recv_msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(recv_msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMP) {
+			struct timeval *tv = (struct timeval *)CMSG_DATA(cmsg);
+			const uint64_t rx_timestamp = tv->tv_sec * 1000000ULL + tv->tv_usec;
+			const uint64_t age = getMonotonicTimestampUSec() - rx_timestamp;
+
+			if (age < rxf->timestamp_usec) {
+				rxf->timestamp_usec -= age;
+			}
+
+			break;
+		}
 	}
 
 	return result;
@@ -74,7 +74,8 @@ public:
 	int16_t transmit(const CanardTxQueueItem &txframe, int timeout_ms = 0);
 
 	/// Receive a CanardFrame from the CanardSocketInstance socket
-	/// This function is blocking
+	/// This function is non-blocking. Pending frames are read in batches of up to RX_BATCH_SIZE frames.
+	/// The frame payload points into the receive buffer and is valid until the next call.
 	/// The return value is number of bytes received, negative value on error.
 	int16_t receive(CanardRxFrame *rxf);
 
@@ -94,10 +95,26 @@ private:
 	struct timeval     *_send_tv {};  /* TX deadline timestamp */
 	uint8_t            _send_control[sizeof(struct cmsghdr) + sizeof(struct timeval)] {};
 
-	//// Receive msg structure
-	struct iovec       _recv_iov {};
-	struct canfd_frame _recv_frame {};
-	struct msghdr      _recv_msg {};
-	struct cmsghdr     *_recv_cmsg {};
-	uint8_t            _recv_control[sizeof(struct cmsghdr) + sizeof(struct timeval)] {};
+	/// Read the pending frames into the receive buffer
+	/// The return value is the number of frames read, negative value on error.
+	int fill_receive_buffer();
+
+#if defined(CONFIG_CYPHAL_SOCKETCAN_RECVMMSG)
+	static constexpr int RX_BATCH_SIZE = 16;
+#else
+	static constexpr int RX_BATCH_SIZE = 1;
+#endif
+
+	//// Receive msg structures (one per frame of a batch)
+	struct iovec       _recv_iov[RX_BATCH_SIZE] {};
+	struct canfd_frame _recv_frame[RX_BATCH_SIZE] {};
+#if defined(CONFIG_CYPHAL_SOCKETCAN_RECVMMSG)
+	struct mmsghdr     _recv_msg[RX_BATCH_SIZE] {};
+#else
+	struct msghdr      _recv_msg[RX_BATCH_SIZE] {};
+#endif
+	uint8_t            _recv_control[RX_BATCH_SIZE][CMSG_SPACE(sizeof(struct timeval))] {};
+
+	int                _recv_count{0}; ///< number of frames in the receive buffer
+	int                _recv_index{0}; ///< next frame to return from the receive buffer
 };
@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <stdlib.h>
+
+#include <px4_platform_common/atomic.h>
+
+/**
+ * Intrusive multi-producer single-consumer FIFO queue.
+ *
+ * push() is lock-free and may be called from any thread. Producers prepend to
+ * an atomic LIFO list, which the consumer moves (reversed) into its private
+ * FIFO list. All other methods must be serialized by the consumer.
+ */
+template<class T>
+class IntrusiveMpscQueue
+{
+public:
+
+	bool empty() const { return (_head == nullptr) && (_incoming.load() == nullptr); }
+
+	/**
+	 * Queue a node (any thread).
+	 * @return false if the node is already queued
+	 */
+	bool push(T newNode)
+	{
+		bool queued = false;
+
+		if (!newNode->_mpsc_queued.compare_exchange(&queued, true)) {
+			return false;
+		}
+
+		T head = _incoming.load();
+
+		do {
+			newNode->_mpsc_next_incoming = head;
+		} while (!_incoming.compare_exchange(&head, newNode));
+
+		return true;
+	}
+
+	T pop()
+	{
+		if (_head == nullptr) {
+			drain();
+		}
+
+		T ret = _head;
+
+		if (ret != nullptr) {
+			_head = ret->_mpsc_next;
+
+			if (_head == nullptr) {
+				_tail = nullptr;
+			}
+
+			ret->_mpsc_next = nullptr;
+
+			// the node can be queued again from now on
+			ret->_mpsc_queued.store(false);
+		}
+
+		return ret;
+	}
+
+	bool remove(T removeNode)
+	{
+		drain();
+
+		T prev = nullptr;
+
+		for (T node = _head; node != nullptr; node = node->_mpsc_next) {
+			if (node == removeNode) {
+				if (prev == nullptr) {
+					_head = node->_mpsc_next;
+
+				} else {
+					prev->_mpsc_next = node->_mpsc_next;
+				}
+
+				if (_tail == node) {
+					_tail = prev;
+				}
+
+				node->_mpsc_next = nullptr;
+				node->_mpsc_queued.store(false);
+				return true;
+			}
+
+			prev = node;
+		}
+
+		return false;
+	}
+
+private:
+
+	// move all pushed nodes into the consumer FIFO, preserving push order
+	void drain()
+	{
+		T node = _incoming.load();
+
+		while (!_incoming.compare_exchange(&node, nullptr)) {}
+
+		T first = nullptr;
+		T last = node;
+
+		while (node != nullptr) {
+			T next = node->_mpsc_next_incoming;
+			node->_mpsc_next_incoming = nullptr;
+			node->_mpsc_next = first;
+			first = node;
+			node = next;
+		}
+
+		if (first != nullptr) {
+			if (_tail != nullptr) {
+				_tail->_mpsc_next = first;
+
+			} else {
+				_head = first;
+			}
+
+			_tail = last;
+		}
+	}
+
+	px4::atomic<T> _incoming{nullptr};
+
+	T _head{nullptr};
+	T _tail{nullptr};
+
+};
+
+template<class T>
+class IntrusiveMpscQueueNode
+{
+private:
+	friend IntrusiveMpscQueue<T>;
+
+	px4::atomic_bool _mpsc_queued{false};
+	T _mpsc_next_incoming{nullptr};
+	T _mpsc_next{nullptr};
+};
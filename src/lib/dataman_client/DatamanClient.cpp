@@ -239,6 +239,31 @@ bool DatamanClient::clearSync(dm_item_t item, hrt_abstime timeout)
 	return success;
 }
 
+bool DatamanClient::flushSync(hrt_abstime timeout)
+{
+	bool success = false;
+	hrt_abstime timestamp = hrt_absolute_time();
+
+	dataman_request_s request{};
+	request.timestamp = timestamp;
+	request.client_id = _client_id;
+	request.request_type = DM_SYNC;
+
+	dataman_response_s response{};
+	success = syncHandler(request, response, timestamp, timeout);
+
+	if (success) {
+
+		if (response.status != dataman_response_s::STATUS_SUCCESS) {
+
+			success = false;
+			PX4_ERR("flushSync failed! status=%" PRIu8, response.status);
+		}
+	}
+
+	return success;
+}
+
 bool DatamanClient::readAsync(dm_item_t item, uint32_t index, uint8_t *buffer, uint32_t length)
 {
 	if (length > g_per_item_size[item]) {
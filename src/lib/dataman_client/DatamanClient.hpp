@@ -87,6 +87,18 @@ public:
 	 */
 	bool clearSync(dm_item_t item, hrt_abstime timeout = 1000_ms);
 
+	/**
+	 * @brief Makes all previous writes persistent.
+	 *
+	 * Writes are buffered by the dataman and only guaranteed to be on physical media
+	 * after this returns successfully (or after writing a commit record, e.g. the mission state).
+	 *
+	 * @param[in] timeout The timeout for the operation.
+	 *
+	 * @return True if the operation was successful, false otherwise.
+	 */
+	bool flushSync(hrt_abstime timeout = 1000_ms);
+
 	/**
 	 * @brief Initiates an asynchronous request to read the data from dataman for a specific item and index.
 	 *
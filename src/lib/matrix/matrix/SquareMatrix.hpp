@@ -305,6 +305,69 @@ public:
 		return self.isBlockSymmetric<Width>(first, eps);
 	}
 
+	// symmetric rank one update P = P + alpha * v * v'
+	// only the rows and columns of the non-zero elements of v are updated (upper triangle, mirrored to the lower triangle)
+	void rankOneUpdateSymmetric(const Vector<Type, M> &v, Type alpha)
+	{
+		SquareMatrix<Type, M> &self = *this;
+
+		size_t index[M];
+		size_t non_zeros = 0;
+
+		for (size_t i = 0; i < M; i++) {
+			if (std::fabs(v(i)) > Type(0)) {
+				index[non_zeros++] = i;
+			}
+		}
+
+		for (size_t i = 0; i < non_zeros; i++) {
+			const size_t row_idx = index[i];
+			const Type alpha_v = alpha * v(row_idx);
+
+			for (size_t j = i; j < non_zeros; j++) {
+				const size_t col_idx = index[j];
+				self(row_idx, col_idx) += alpha_v * v(col_idx);
+				self(col_idx, row_idx) = self(row_idx, col_idx);
+			}
+		}
+	}
+
+	// symmetric low rank update P = P + alpha * V * V' in a single pass over P
+	// only the rows and columns of the non-zero rows of V are updated (upper triangle, mirrored to the lower triangle)
+	template<size_t N>
+	void lowRankUpdateSymmetric(const Matrix<Type, M, N> &V, Type alpha)
+	{
+		SquareMatrix<Type, M> &self = *this;
+
+		size_t index[M];
+		size_t non_zeros = 0;
+
+		for (size_t i = 0; i < M; i++) {
+			for (size_t n = 0; n < N; n++) {
+				if (std::fabs(V(i, n)) > Type(0)) {
+					index[non_zeros++] = i;
+					break;
+				}
+			}
+		}
+
+		for (size_t i = 0; i < non_zeros; i++) {
+			const size_t row_idx = index[i];
+
+			for (size_t j = i; j < non_zeros; j++) {
+				const size_t col_idx = index[j];
+				Type sum{};
+
+				for (size_t n = 0; n < N; n++) {
+					sum += V(row_idx, n) * V(col_idx, n);
+				}
+
+				self(row_idx, col_idx) += alpha * sum;
+				self(col_idx, row_idx) = self(row_idx, col_idx);
+			}
+		}
+	}
+
 	void copyLowerToUpperTriangle()
 	{
 		SquareMatrix<Type, M> &self = *this;
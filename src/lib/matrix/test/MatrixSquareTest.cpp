@@ -209,4 +209,36 @@ TEST(MatrixSquareTest, Square)
 	SquareMatrix<float, 4> M(data_M);
 	M.copyUpperToLowerTriangle();
 	EXPECT_EQ(M, L_check);
+
+	// symmetric rank one update, zero elements of the vector leave their rows and columns untouched
+	SquareMatrix<float, 4> N(data_L_check);
+	N.rankOneUpdateSymmetric(Vector4f(1, 0, 2, 0), -2.f);
+	float data_N_check[16] = {-1, 2, -1, 4,
+				  2, 3, 4, 11,
+				  -1, 4, 3, 15,
+				  4, 11, 15, 16
+				 };
+	SquareMatrix<float, 4> N_check(data_N_check);
+	EXPECT_EQ(N, N_check);
+
+	SquareMatrix<float, 4> O(data_L_check);
+	const float data_v[4] = {1, -2, 3, 0.5f};
+	const Vector<float, 4> v(data_v);
+	O.rankOneUpdateSymmetric(v, 0.5f);
+	const SquareMatrix<float, 4> O_check = SquareMatrix<float, 4>(data_L_check) + Matrix<float, 4, 1>(v) * v.transpose() * 0.5f;
+	EXPECT_EQ(O, O_check);
+
+	// symmetric low rank update, rows of V with only zero elements leave their rows and columns untouched
+	SquareMatrix<float, 4> Q(data_L_check);
+	const float data_V[8] = {1, 0.5f,
+				 0, 0,
+				 -2, 1,
+				 0, 3
+				};
+	const Matrix<float, 4, 2> V(data_V);
+	Q.lowRankUpdateSymmetric(V, -0.5f);
+	const SquareMatrix<float, 4> Q_check = SquareMatrix<float, 4>(data_L_check) - V * V.transpose() * 0.5f;
+	EXPECT_EQ(Q, Q_check);
+	EXPECT_FLOAT_EQ(Q(1, 1), data_L_check[5]);
+	EXPECT_TRUE(Q.isBlockSymmetric<4>(0, 0.f));
 }
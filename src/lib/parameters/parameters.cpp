@@ -158,6 +158,22 @@ static param_t param_find_internal(const char *name, bool notification)
 {
 	perf_count(param_find_perf);
 
+#if !defined(CONSTRAINED_FLASH) && defined(PX4_PARAMETERS_PERFECT_HASH)
+	/* look up the only candidate in the generated minimal perfect hash */
+	static constexpr uint32_t num_buckets = sizeof(px4::parameters_hash_seeds) / sizeof(px4::parameters_hash_seeds[0]);
+	const int16_t seed = px4::parameters_hash_seeds[px4::param_name_hash(name, 0) % num_buckets];
+	const uint32_t slot = (seed < 0) ? (-seed - 1) : (px4::param_name_hash(name, seed) % param_info_count);
+	const param_t param = px4::parameters_hash_slots[slot];
+
+	if (strcmp(name, param_name(param)) == 0) {
+		if (notification) {
+			param_set_used(param);
+		}
+
+		return param;
+	}
+
+#else
 	param_t middle;
 	param_t front = 0;
 	param_t last = param_info_count;
@@ -187,6 +203,8 @@ static param_t param_find_internal(const char *name, bool notification)
 		}
 	}
 
+#endif
+
 	/* not found */
 	return PARAM_INVALID;
 }
@@ -19,6 +19,79 @@ except ImportError as e:
 
 import os
 
+FNV_OFFSET_BASIS = 2166136261
+FNV_PRIME = 16777619
+
+def name_hash(name, seed):
+    """
+    32 bit FNV-1a hash of name, with the offset basis perturbed by seed, followed by the
+    murmur3 finalizer (fmix32), so that the low bits are usable modulo small table sizes.
+    Must match param_name_hash() in px4_parameters.hpp.jinja.
+    """
+    h = FNV_OFFSET_BASIS ^ seed
+    for c in name.encode('ascii'):
+        h = ((h ^ c) * FNV_PRIME) & 0xffffffff
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & 0xffffffff
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & 0xffffffff
+    h ^= h >> 16
+    return h
+
+def perfect_hash(names):
+    """
+    Create a minimal perfect hash (hash and displace) over names.
+
+    The names are distributed into len(names) / 2 buckets using seed 0.
+    Every bucket then gets a seed such that all its names hash to free slots,
+    or, for buckets with a single name, directly the slot encoded as -(slot + 1).
+
+    @return (seeds, slots): seed per bucket and parameter index per slot, or None if no
+            seed was found (param_find then uses a binary search)
+    """
+    n = len(names)
+    if n == 0:
+        return None
+
+    num_buckets = max(1, n // 2)
+    buckets = [[] for _ in range(num_buckets)]
+    for i, name in enumerate(names):
+        buckets[name_hash(name, 0) % num_buckets].append(i)
+
+    seeds = [0] * num_buckets
+    slots = [None] * n
+
+    # place the largest buckets first, while most slots are free
+    order = sorted(range(num_buckets), key=lambda b: len(buckets[b]), reverse=True)
+    pending = [b for b in order if len(buckets[b]) > 1]
+    singles = [b for b in order if len(buckets[b]) == 1]
+
+    for b in pending:
+        for seed in range(1, 0x8000):
+            candidate = [name_hash(names[i], seed) % n for i in buckets[b]]
+            if len(set(candidate)) == len(candidate) and all(slots[s] is None for s in candidate):
+                break
+        else:
+            print("no perfect hash seed found for bucket {}, using binary search".format(b))
+            return None
+
+        seeds[b] = seed
+        for i, s in zip(buckets[b], candidate):
+            slots[s] = i
+
+    free = [s for s in range(n) if slots[s] is None]
+    for b, s in zip(singles, free):
+        seeds[b] = -(s + 1)
+        slots[s] = buckets[b][0]
+
+    # verify
+    for i, name in enumerate(names):
+        seed = seeds[name_hash(name, 0) % num_buckets]
+        s = -seed - 1 if seed < 0 else name_hash(name, seed) % n
+        assert slots[s] == i
+
+    return seeds, slots
+
 def generate(xml_file, dest='.'):
     """
     Generate px4 param source from xml.
@@ -39,6 +112,9 @@ def generate(xml_file, dest='.'):
 
     params = sorted(params, key=lambda name: name.attrib["name"])
 
+    perfect_hash_tables = perfect_hash([param.attrib["name"] for param in params])
+    hash_seeds, hash_slots = perfect_hash_tables if perfect_hash_tables else ([], [])
+
     script_path = os.path.dirname(os.path.realpath(__file__))
 
     # for jinja docs see: http://jinja.pocoo.org/docs/2.9/api/
@@ -55,7 +131,8 @@ def generate(xml_file, dest='.'):
         template = env.get_template(template_file)
         with open(os.path.join(
                 dest, template_file.replace('.jinja','')), 'w') as fid:
-            fid.write(template.render(params=params))
+            fid.write(template.render(params=params,
+                hash_seeds=hash_seeds, hash_slots=hash_slots))
 
 if __name__ == "__main__":
     arg_parser = argparse.ArgumentParser()
@@ -0,0 +1,112 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file log2_histogram.hpp
+ * Fixed size histogram with power of two buckets, cheap enough to record on every event.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class Log2Histogram
+{
+public:
+	// bucket 0 counts 0, bucket i in [1, BUCKETS - 2] counts [2^(i-1), 2^i - 1], the last bucket everything above
+	static constexpr int BUCKETS = 16;
+
+	void record(uint32_t value)
+	{
+		const int bucket = (value == 0) ? 0 : 32 - __builtin_clz(value);
+		uint16_t &count = _buckets[(bucket < BUCKETS) ? bucket : (BUCKETS - 1)];
+
+		// halve all buckets instead of overflowing, which keeps the shape and favours recent samples
+		if (count == UINT16_MAX) {
+			for (auto &b : _buckets) {
+				b /= 2;
+			}
+		}
+
+		count++;
+
+		if (value > _max) {
+			_max = value;
+		}
+	}
+
+	/**
+	 * Upper bound of the bucket containing the given percentile.
+	 *
+	 * @param percentile	in [0, 100]
+	 * @return		bucket upper bound, limited to the maximum recorded value (0 if empty)
+	 */
+	uint32_t percentile(uint8_t percentile) const
+	{
+		uint32_t total = 0;
+
+		for (auto b : _buckets) {
+			total += b;
+		}
+
+		// rank of the sample, rounded up
+		const uint32_t rank = (total * percentile + 99) / 100;
+		uint32_t count = 0;
+
+		for (int i = 0; i < BUCKETS; i++) {
+			count += _buckets[i];
+
+			if ((count >= rank) && (count > 0)) {
+				const uint32_t upper = (i == 0) ? 0 : ((i < BUCKETS - 1) ? (1u << i) - 1 : _max);
+				return (upper < _max) ? upper : _max;
+			}
+		}
+
+		return 0;
+	}
+
+	uint32_t max() const { return _max; }
+
+	void reset()
+	{
+		for (auto &b : _buckets) {
+			b = 0;
+		}
+
+		_max = 0;
+	}
+
+private:
+	uint16_t _buckets[BUCKETS] {};
+	uint32_t _max{0};
+};
@@ -49,6 +49,7 @@
 #include <px4_platform_common/getopt.h>
 #include <drivers/drv_hrt.h>
 #include <lib/parameters/param.h>
+#include <lib/mathlib/mathlib.h>
 #include <lib/perf/perf_counter.h>
 #include <stdlib.h>
 
@@ -63,12 +64,16 @@ __BEGIN_DECLS
 __EXPORT int dataman_main(int argc, char *argv[]);
 __END_DECLS
 
+using namespace time_literals;
+
 static constexpr int TASK_STACK_SIZE = 1420;
 
 /* Private File based Operations */
 static ssize_t _file_write(dm_item_t item, unsigned index, const void *buf, size_t count);
 static ssize_t _file_read(dm_item_t item, unsigned index, void *buf, size_t count);
 static int  _file_clear(dm_item_t item);
+static int _file_sync();
+static int _file_flush_background();
 static int _file_initialize(unsigned max_offset);
 static void _file_shutdown();
 
@@ -76,6 +81,7 @@ static void _file_shutdown();
 static ssize_t _ram_write(dm_item_t item, unsigned index, const void *buf, size_t count);
 static ssize_t _ram_read(dm_item_t item, unsigned index, void *buf, size_t count);
 static int  _ram_clear(dm_item_t item);
+static int _ram_sync() { return 0; }
 static int _ram_initialize(unsigned max_offset);
 static void _ram_shutdown();
 
@@ -83,6 +89,8 @@ typedef struct dm_operations_t {
 	ssize_t (*write)(dm_item_t item, unsigned index, const void *buf, size_t count);
 	ssize_t (*read)(dm_item_t item, unsigned index, void *buf, size_t count);
 	int (*clear)(dm_item_t item);
+	int (*sync)();
+	int (*flush_background)();
 	int (*initialize)(unsigned max_offset);
 	void (*shutdown)();
 	int (*wait)(px4_sem_t *sem);
@@ -92,6 +100,8 @@ static constexpr dm_operations_t dm_file_operations = {
 	.write   = _file_write,
 	.read    = _file_read,
 	.clear   = _file_clear,
+	.sync    = _file_sync,
+	.flush_background = _file_flush_background,
 	.initialize = _file_initialize,
 	.shutdown = _file_shutdown,
 	.wait = px4_sem_wait,
@@ -101,6 +111,8 @@ static constexpr dm_operations_t dm_ram_operations = {
 	.write   = _ram_write,
 	.read    = _ram_read,
 	.clear   = _ram_clear,
+	.sync    = _ram_sync,
+	.flush_background = _ram_sync,
 	.initialize = _ram_initialize,
 	.shutdown = _ram_shutdown,
 	.wait = px4_sem_wait,
@@ -140,6 +152,18 @@ static constexpr size_t g_per_item_size_with_hdr[DM_KEY_NUM_KEYS] = {
 /* Table of offset for index 0 of each item type */
 static unsigned int g_key_offsets[DM_KEY_NUM_KEYS];
 
+/* File backend write-back buffer: writes of consecutive items are coalesced into a single pwrite, and fsync
+ * is deferred until a commit record is written (see is_commit_record()), a DM_SYNC request or the periodic sync. */
+static constexpr size_t DM_FILE_BUFFER_SIZE = 512;
+
+static struct {
+	uint8_t data[DM_FILE_BUFFER_SIZE];
+	int offset;	/* file offset of data[0] */
+	size_t length;	/* number of pending bytes, not written to the file yet */
+	bool unsynced;	/* written to the file, but not fsync'ed yet */
+	bool failed;	/* acknowledged data was lost since the last sync, reported by the next _file_sync() */
+} g_write_back;
+
 static uint8_t dataman_clients_count = 1;
 
 static perf_counter_t _dm_read_perf{nullptr};
@@ -186,6 +210,27 @@ calculate_offset(dm_item_t item, unsigned index)
 	return g_key_offsets[item] + (index * g_per_item_size_with_hdr[item]);
 }
 
+/* Commit records complete a transaction of multiple writes: the mission state (which switches to a newly uploaded
+ * mission), the stats at index 0 of the geofence and safe points (written after their items) and the compat key.
+ * They are only written after all previous writes are on physical media, and are on it themselves before the
+ * write returns, so that a reset never leaves a commit record referring to partially written items. */
+static bool
+is_commit_record(dm_item_t item, unsigned index)
+{
+	switch (item) {
+	case DM_KEY_MISSION_STATE:
+	case DM_KEY_COMPAT:
+		return true;
+
+	case DM_KEY_FENCE_POINTS:
+	case DM_KEY_SAFE_POINTS:
+		return index == 0;
+
+	default:
+		return false;
+	}
+}
+
 /* Each data item is stored as follows
  *
  * byte 0: Length of user data item
@@ -237,6 +282,82 @@ static ssize_t _ram_write(dm_item_t item, unsigned index, const void *buf, size_
 	return count;
 }
 
+/* write to the data manager file, retrying once */
+static int
+_file_pwrite(const void *buf, size_t count, int offset)
+{
+	for (int i = 0; i < 2; i++) {
+		ssize_t ret_write = pwrite(dm_operations_data.file.fd, buf, count, offset);
+
+		if (ret_write < 0) {
+			PX4_ERR("file write failed %d", errno);
+			continue;
+		}
+
+		if (ret_write != (ssize_t)count) {
+			PX4_ERR("file write failed, wrote %zd bytes, expected %zu", ret_write, count);
+			continue;
+		}
+
+		g_write_back.unsynced = true;
+		return 0;
+	}
+
+	return -1;
+}
+
+/* write the pending data of the write-back buffer to the file */
+static int
+_file_flush()
+{
+	if (g_write_back.length == 0) {
+		return 0;
+	}
+
+	int result = _file_pwrite(g_write_back.data, g_write_back.length, g_write_back.offset);
+	g_write_back.length = 0;
+
+	if (result != 0) {
+		/* the writers of this data were already acknowledged, fail the next commit record or DM_SYNC */
+		g_write_back.failed = true;
+	}
+
+	return result;
+}
+
+/* make all previous writes persistent, errors are kept for the next _file_sync() */
+static int
+_file_flush_background()
+{
+	int result = _file_flush();
+
+	if (g_write_back.unsynced) {
+		if (fsync(dm_operations_data.file.fd) != 0) {
+			PX4_ERR("file sync failed %d", errno);
+			g_write_back.failed = true;
+			result = -1;
+		}
+
+		g_write_back.unsynced = false;
+	}
+
+	return result;
+}
+
+/* make all previous writes persistent and report any data lost since the last sync */
+static int
+_file_sync()
+{
+	int result = _file_flush_background();
+
+	if (g_write_back.failed) {
+		g_write_back.failed = false;
+		result = -1;
+	}
+
+	return result;
+}
+
 /* write to the data manager file */
 static ssize_t
 _file_write(dm_item_t item, unsigned index, const void *buf, size_t count)
@@ -245,8 +366,6 @@ _file_write(dm_item_t item, unsigned index, const void *buf, size_t count)
 		return -1;
 	}
 
-	unsigned char buffer[g_per_item_size_with_hdr[item]];
-
 	/* Get the offset for this item */
 	const int offset = calculate_offset(item, index);
 
@@ -260,7 +379,29 @@ _file_write(dm_item_t item, unsigned index, const void *buf, size_t count)
 		return -E2BIG;
 	}
 
-	/* Write out the data, prefixed with length */
+	const size_t size = count + DM_SECTOR_HDR_SIZE;
+	static_assert(DM_FILE_BUFFER_SIZE >= MISSION_ITEM_SIZE + DM_SECTOR_HDR_SIZE, "write-back buffer too small");
+
+	if (is_commit_record(item, index)) {
+		/* Make sure all data of the transaction is written to physical media first */
+		if (_file_sync() != 0) {
+			return -1;
+		}
+
+	} else if ((g_write_back.length > 0) && ((offset != g_write_back.offset + (int)g_write_back.length)
+			|| (g_write_back.length + size > DM_FILE_BUFFER_SIZE))) {
+		/* Not consecutive to the pending data or no space left */
+		if (_file_flush() != 0) {
+			return -1;
+		}
+	}
+
+	if (g_write_back.length == 0) {
+		g_write_back.offset = offset;
+	}
+
+	/* Append the data, prefixed with length */
+	uint8_t *buffer = &g_write_back.data[g_write_back.length];
 	buffer[0] = count;
 	buffer[1] = 0;
 	buffer[2] = 0;
@@ -270,49 +411,17 @@ _file_write(dm_item_t item, unsigned index, const void *buf, size_t count)
 		memcpy(buffer + DM_SECTOR_HDR_SIZE, buf, count);
 	}
 
-	count += DM_SECTOR_HDR_SIZE;
-
-	bool write_success = false;
-
-	for (int i = 0; i < 2; i++) {
-		int ret_seek = lseek(dm_operations_data.file.fd, offset, SEEK_SET);
-
-		if (ret_seek < 0) {
-			PX4_ERR("file write lseek failed %d", errno);
-			continue;
-		}
-
-		if (ret_seek != offset) {
-			PX4_ERR("file write lseek failed, incorrect offset %d vs %d", ret_seek, offset);
-			continue;
-		}
-
-		int ret_write = write(dm_operations_data.file.fd, buffer, count);
+	g_write_back.length += size;
 
-		if (ret_write < 0) {
-			PX4_ERR("file write failed %d", errno);
-			continue;
-		}
-
-		if (ret_write != (ssize_t)count) {
-			PX4_ERR("file write failed, wrote %d bytes, expected %zu", ret_write, count);
-			continue;
-
-		} else {
-			write_success = true;
-			break;
+	if (is_commit_record(item, index)) {
+		/* Make sure the commit record is written to physical media */
+		if (_file_sync() != 0) {
+			return -1;
 		}
 	}
 
-	if (!write_success) {
-		return -1;
-	}
-
-	/* Make sure data is written to physical media */
-	fsync(dm_operations_data.file.fd);
-
 	/* All is well... return the number of user data written */
-	return count - DM_SECTOR_HDR_SIZE;
+	return count;
 }
 
 /* Retrieve from the data manager RAM buffer*/
@@ -381,6 +490,11 @@ _file_read(dm_item_t item, unsigned index, void *buf, size_t count)
 		return -E2BIG;
 	}
 
+	/* Pending writes might contain the item */
+	if (_file_flush() != 0) {
+		return -1;
+	}
+
 	int len = -1;
 	bool read_success = false;
 
@@ -479,7 +593,7 @@ _file_clear(dm_item_t item)
 		return -1;
 	}
 
-	int i, result = 0;
+	int result = 0;
 
 	/* Get the offset of 1st item of this type */
 	int offset = calculate_offset(item, 0);
@@ -489,40 +603,54 @@ _file_clear(dm_item_t item)
 		return -1;
 	}
 
-	/* Clear all items of this type */
-	for (i = 0; (unsigned)i < g_per_item_max_index[item]; i++) {
-		char buf[1];
+	/* The write-back buffer is reused for reading */
+	if (_file_flush() != 0) {
+		return -1;
+	}
 
-		if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
-			result = -1;
-			break;
-		}
+	const size_t item_size = g_per_item_size_with_hdr[item];
+	const unsigned items_per_chunk = DM_FILE_BUFFER_SIZE / item_size;
+	uint8_t *chunk = g_write_back.data;
 
-		/* Avoid SD flash wear by only doing writes where necessary */
-		if (read(dm_operations_data.file.fd, buf, 1) < 1) {
+	/* Clear all items of this type, a chunk of items at a time */
+	for (unsigned i = 0; i < g_per_item_max_index[item]; i += items_per_chunk) {
+		const size_t chunk_size = math::min(items_per_chunk, g_per_item_max_index[item] - i) * item_size;
+		const ssize_t len = pread(dm_operations_data.file.fd, chunk, chunk_size, offset);
+
+		if (len < 0) {
+			result = -1;
 			break;
 		}
 
 		/* If item has length greater than 0 it needs to be overwritten */
-		if (buf[0]) {
-			if (lseek(dm_operations_data.file.fd, offset, SEEK_SET) != offset) {
-				result = -1;
-				break;
+		bool modified = false;
+
+		for (size_t item_offset = 0; item_offset < (size_t)len; item_offset += item_size) {
+			if (chunk[item_offset]) {
+				chunk[item_offset] = 0;
+				modified = true;
 			}
+		}
 
-			buf[0] = 0;
+		/* Avoid SD flash wear by only doing writes where necessary */
+		if (modified && (_file_pwrite(chunk, len, offset) != 0)) {
+			result = -1;
+			break;
+		}
 
-			if (write(dm_operations_data.file.fd, buf, 1) != 1) {
-				result = -1;
-				break;
-			}
+		/* End of the file */
+		if ((size_t)len < chunk_size) {
+			break;
 		}
 
-		offset += g_per_item_size_with_hdr[item];
+		offset += chunk_size;
+	}
+
+	/* Make sure data is actually written to physical media (lost data is reported by the next sync) */
+	if (_file_flush_background() != 0) {
+		result = -1;
 	}
 
-	/* Make sure data is actually written to physical media */
-	fsync(dm_operations_data.file.fd);
 	return result;
 }
 
@@ -614,6 +742,7 @@ _ram_initialize(unsigned max_offset)
 static void
 _file_shutdown()
 {
+	_file_sync();
 	close(dm_operations_data.file.fd);
 	dm_operations_data.running = false;
 }
@@ -697,6 +826,8 @@ task_main(int argc, char *argv[])
 	/* Tell startup that the worker thread has completed its initialization */
 	px4_sem_post(&g_init_sema);
 
+	hrt_abstime last_sync = hrt_absolute_time();
+
 	/* Start the endless loop, waiting for then processing work requests */
 	while (true) {
 
@@ -771,6 +902,20 @@ task_main(int argc, char *argv[])
 
 					break;
 
+				case DM_SYNC:
+
+					g_func_counts[DM_SYNC]++;
+					result = g_dm_ops->sync();
+
+					if (result == 0) {
+						response.status = dataman_response_s::STATUS_SUCCESS;
+
+					} else {
+						response.status = dataman_response_s::STATUS_FAILURE_WRITE_FAILED;
+					}
+
+					break;
+
 				case DM_CLEAR:
 
 					g_func_counts[DM_CLEAR]++;
@@ -795,6 +940,12 @@ task_main(int argc, char *argv[])
 			}
 		}
 
+		/* make deferred writes persistent when idle, but at least once a second */
+		if (ret == 0 || hrt_elapsed_time(&last_sync) > 1_s) {
+			g_dm_ops->flush_background();
+			last_sync = hrt_absolute_time();
+		}
+
 		/* time to go???? */
 		if (g_task_should_exit) {
 			break;
@@ -851,6 +1002,7 @@ status()
 	PX4_INFO("Writes   %u", g_func_counts[DM_WRITE]);
 	PX4_INFO("Reads    %u", g_func_counts[DM_READ]);
 	PX4_INFO("Clears   %u", g_func_counts[DM_CLEAR]);
+	PX4_INFO("Syncs    %u", g_func_counts[DM_SYNC]);
 
 	perf_print_counter(_dm_read_perf);
 	perf_print_counter(_dm_write_perf);
@@ -880,6 +1032,11 @@ Each type has a specific type and a fixed maximum amount of storage items, so th
 ### Implementation
 Reading and writing a single item is always atomic.
 
+The file backend coalesces writes of consecutive items and defers fsync until the end of a transaction:
+writing a commit record (the mission state, index 0 of **DM_KEY_FENCE_POINTS** and **DM_KEY_SAFE_POINTS**),
+an explicit sync request, when the dataman is idle and at least once a second. A commit record is only written after
+all previous writes are persistent, so a reset never leaves it referring to partially written items.
+
 **DM_KEY_FENCE_POINTS** and **DM_KEY_SAFE_POINTS** items: the first data element is a `mission_stats_entry_s` struct,
 which stores the number of items for these types. These items are always updated atomically in one transaction (from
 the mavlink mission manager).
@@ -59,6 +59,7 @@ typedef enum {
 	DM_WRITE,			///< Write index for given item
 	DM_READ,			///< Read index for given item
 	DM_CLEAR,			///< Clear all index for given item
+	DM_SYNC,			///< Make all previous writes persistent
 	DM_NUMBER_OF_FUNCS
 } dm_function_t;
 
@@ -72,6 +73,18 @@ enum {
 	DM_KEY_MISSION_STATE_MAX = 1,
 	DM_KEY_COMPAT_MAX = 1
 };
+#define DM_COMPAT_LAYOUT	0ULL
+#elif defined(__PX4_POSIX)
+/* large geofences (thousands of vertices, e.g. uploaded by a companion computer), about 0.6 MB of fence points */
+enum {
+	DM_KEY_SAFE_POINTS_MAX = 32,
+	DM_KEY_FENCE_POINTS_MAX = 16384,
+	DM_KEY_WAYPOINTS_OFFBOARD_0_MAX = NUM_MISSIONS_SUPPORTED,
+	DM_KEY_WAYPOINTS_OFFBOARD_1_MAX = NUM_MISSIONS_SUPPORTED,
+	DM_KEY_MISSION_STATE_MAX = 1,
+	DM_KEY_COMPAT_MAX = 1
+};
+#define DM_COMPAT_LAYOUT	1ULL
 #else
 enum {
 	DM_KEY_SAFE_POINTS_MAX = 32,
@@ -81,6 +94,7 @@ enum {
 	DM_KEY_MISSION_STATE_MAX = 1,
 	DM_KEY_COMPAT_MAX = 1
 };
+#define DM_COMPAT_LAYOUT	0ULL
 #endif
 
 /* table of maximum number of instances for each item type */
@@ -116,7 +130,8 @@ struct dataman_compat_s {
 /* increment this define whenever a binary incompatible change is performed */
 #define DM_COMPAT_VERSION	4ULL
 
-#define DM_COMPAT_KEY ((DM_COMPAT_VERSION << 32) + (sizeof(struct mission_item_s) << 24) + \
+/* DM_COMPAT_LAYOUT distinguishes the different numbers of instances per item type */
+#define DM_COMPAT_KEY ((DM_COMPAT_LAYOUT << 40) + (DM_COMPAT_VERSION << 32) + (sizeof(struct mission_item_s) << 24) + \
 		       (sizeof(struct mission_s) << 16) + (sizeof(struct mission_stats_entry_s) << 12) + \
 		       (sizeof(struct mission_fence_point_s) << 8) + (sizeof(struct mission_item_s) << 4) + \
 		       sizeof(struct dataman_compat_s))
@@ -338,12 +338,12 @@ void Ekf::constrainStateVar(const IdxDof &state, float min, float max)
 
 // if the covariance correction will result in a negative variance, then
 // the covariance matrix is unhealthy and must be corrected
-bool Ekf::checkAndFixCovarianceUpdate(const SquareMatrixState &KHP)
+bool Ekf::checkAndFixCovarianceUpdate(const VectorState &K, const float innovation_variance)
 {
 	bool healthy = true;
 
 	for (int i = 0; i < State::size; i++) {
-		if (P(i, i) < KHP(i, i)) {
+		if (P(i, i) < K(i) * innovation_variance * K(i)) {
 			P.uncorrelateCovarianceSetVariance<1>(i, 0.0f);
 			healthy = false;
 		}
@@ -325,6 +325,11 @@ public:
 	// fuse single velocity and position measurement
 	bool fuseVelPosHeight(const float innov, const float innov_var, const int state_index);
 
+	// fuse N velocity or position measurements of the consecutive states starting at state_index
+	// (block update if CONFIG_EKF2_VEL_POS_BLOCK_FUSION is enabled, sequential scalar updates otherwise)
+	template<size_t N>
+	bool fuseVelPos(const float (&innov)[N], const float (&innov_var)[N], const float (&obs_var)[N], const int state_index);
+
 	// gyro bias
 	const Vector3f &getGyroBias() const { return _state.gyro_bias; } // get the gyroscope bias in rad/s
 	Vector3f getGyroBiasVariance() const { return getStateVariance<State::gyro_bias>(); } // get the gyroscope bias variance in rad/s
@@ -476,24 +481,15 @@ public:
 	{
 		clearInhibitedStateKalmanGains(K);
 
-		const VectorState KS = K * innovation_variance;
-		SquareMatrixState KHP;
-
-		for (unsigned row = 0; row < State::size; row++) {
-			for (unsigned col = 0; col < State::size; col++) {
-				// Instad of literally computing KHP, use an equvalent
-				// equation involving less mathematical operations
-				KHP(row, col) = KS(row) * K(col);
-			}
-		}
-
-		const bool is_healthy = checkAndFixCovarianceUpdate(KHP);
+		const bool is_healthy = checkAndFixCovarianceUpdate(K, innovation_variance);
 
 		if (is_healthy) {
-			// apply the covariance corrections
-			P -= KHP;
+			// apply the covariance corrections P = P - K * S * K'
+			// only the rows and columns of the states with a non-zero Kalman gain are updated
+			P.rankOneUpdateSymmetric(K, -innovation_variance);
 
-			fixCovarianceErrors(true);
+			// the correction is symmetric, no need to force symmetry
+			fixCovarianceErrors(false);
 
 			// apply the state corrections
 			fuse(K, innovation);
@@ -502,6 +498,23 @@ public:
 		return is_healthy;
 	}
 
+	// Kalman gain K = P * H' / S of a scalar observation
+	// only the columns of P with a non-zero Jacobian element are used
+	VectorState computeKalmanGain(const VectorState &H, float innovation_variance) const
+	{
+		VectorState PH;
+
+		for (unsigned col = 0; col < State::size; col++) {
+			if (fabsf(H(col)) > 0.f) {
+				for (unsigned row = 0; row < State::size; row++) {
+					PH(row) += P(row, col) * H(col);
+				}
+			}
+		}
+
+		return PH / innovation_variance;
+	}
+
 	void resetGlobalPosToExternalObservation(double lat_deg, double lon_deg, float accuracy, uint64_t timestamp_observation);
 
 	void updateParameters();
@@ -943,9 +956,9 @@ private:
 #endif // CONFIG_EKF2_WIND
 	}
 
-	// if the covariance correction will result in a negative variance, then
+	// if the covariance correction K * S * K' will result in a negative variance, then
 	// the covariance matrix is unhealthy and must be corrected
-	bool checkAndFixCovarianceUpdate(const SquareMatrixState &KHP);
+	bool checkAndFixCovarianceUpdate(const VectorState &K, float innovation_variance);
 
 	// limit the diagonal of the covariance matrix
 	// force symmetry when the argument is true
@@ -83,6 +83,10 @@ class EstimatorInterface
 public:
 	void setIMUData(const imuSample &imu_sample);
 
+	// set IMU data that has already been down-sampled by the caller (e.g. shared by multiple instances using the same IMU)
+	// imu_sample_down_sampled: new down-sampled IMU data or nullptr if none is available yet
+	void setIMUData(const imuSample &imu_sample, const imuSample *imu_sample_down_sampled);
+
 #if defined(CONFIG_EKF2_GNSS)
 	void setGpsData(const gnssSample &gnss_sample);
 
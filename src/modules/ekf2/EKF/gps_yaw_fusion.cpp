@@ -132,7 +132,7 @@ void Ekf::fuseGpsYaw(float antenna_yaw_offset)
 
 	// calculate the Kalman gains
 	// only calculate gains for states we are using
-	VectorState Kfusion = P * H / gnss_yaw.innovation_variance;
+	VectorState Kfusion = computeKalmanGain(H, gnss_yaw.innovation_variance);
 
 	const bool is_fused = measurementUpdate(Kfusion, gnss_yaw.innovation_variance, gnss_yaw.innovation);
 	_fault_status.flags.bad_hdg = !is_fused;
@@ -60,9 +60,13 @@ public:
 		return imu;
 	}
 
-private:
+	/**
+	 * Discard the accumulated data and apply the current target interval
+	 */
 	void reset();
 
+private:
+
 	imuSample _imu_down_sampled{};
 	Quatf _delta_angle_accumulated{};
 
@@ -176,7 +176,7 @@ bool Ekf::fuseMag(const Vector3f &mag, estimator_aid_source3d_s &aid_src_mag, bo
 			}
 		}
 
-		VectorState Kfusion = P * H / aid_src_mag.innovation_variance[index];
+		VectorState Kfusion = computeKalmanGain(H, aid_src_mag.innovation_variance[index]);
 
 		if (!update_all_states) {
 			// zero non-mag Kalman gains if not updating all states
@@ -245,7 +245,7 @@ bool Ekf::fuseDeclination(float decl_sigma)
 	}
 
 	// Calculate the Kalman gains
-	VectorState Kfusion = P * H / innovation_variance;
+	VectorState Kfusion = computeKalmanGain(H, innovation_variance);
 
 	const bool is_fused = measurementUpdate(Kfusion, innovation_variance, innovation);
 
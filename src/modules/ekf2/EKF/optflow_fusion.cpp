@@ -144,7 +144,7 @@ void Ekf::fuseOptFlow()
 			}
 		}
 
-		VectorState Kfusion = P * H / _aid_src_optical_flow.innovation_variance[index];
+		VectorState Kfusion = computeKalmanGain(H, _aid_src_optical_flow.innovation_variance[index]);
 
 		if (measurementUpdate(Kfusion, _aid_src_optical_flow.innovation_variance[index], _aid_src_optical_flow.innovation[index])) {
 			fused[index] = true;
@@ -132,13 +132,90 @@ void Ekf::updateHorizontalPositionAidSrcStatus(const uint64_t &time_us, const Ve
 	aid_src.timestamp_sample = time_us;
 }
 
+template<size_t N>
+bool Ekf::fuseVelPos(const float (&innov)[N], const float (&innov_var)[N], const float (&obs_var)[N],
+		     const int state_index)
+{
+#if defined(CONFIG_EKF2_VEL_POS_BLOCK_FUSION)
+	// H selects the N consecutive states: S = H * P * H' + R is the covariance block of the observed states
+	matrix::SquareMatrix<float, N> S = P.slice<N, N>(state_index, state_index);
+
+	for (size_t i = 0; i < N; i++) {
+		S(i, i) += obs_var[i];
+	}
+
+	matrix::SquareMatrix<float, N> S_inv;
+
+	if (matrix::inv(S, S_inv)) {
+		// calculate kalman gain K = P * H' * S^-1
+		const matrix::Matrix<float, State::size, N> PHt = P.slice<State::size, N>(0, state_index);
+		matrix::Matrix<float, State::size, N> K = PHt * S_inv;
+
+		for (size_t i = 0; i < N; i++) {
+			VectorState K_col(K.col(i));
+			clearInhibitedStateKalmanGains(K_col);
+			K.setCol(i, K_col);
+		}
+
+		// K * S * K' = (K * L) * (K * L)' with the cholesky decomposition S = L * L'
+		const matrix::Matrix<float, State::size, N> KL = K * matrix::cholesky(S);
+
+		bool healthy = true;
+
+		for (int row = 0; row < State::size; row++) {
+			float KSK_diag = 0.f;
+
+			for (size_t i = 0; i < N; i++) {
+				KSK_diag += KL(row, i) * KL(row, i);
+			}
+
+			if (P(row, row) < KSK_diag) {
+				P.uncorrelateCovarianceSetVariance<1>(row, 0.0f);
+				healthy = false;
+			}
+		}
+
+		for (size_t i = 0; i < N; i++) {
+			setVelPosStatus(state_index + i, healthy);
+		}
+
+		if (healthy) {
+			// apply the covariance corrections P = P - K * S * K' in a single pass
+			P.lowRankUpdateSymmetric(KL, -1.f);
+
+			fixCovarianceErrors(false);
+
+			// apply the state corrections, fuse() subtracts K * innovation
+			fuse(K * matrix::Vector<float, N>(innov), 1.f);
+		}
+
+		return healthy;
+	}
+
+#else
+	(void)obs_var;
+#endif // CONFIG_EKF2_VEL_POS_BLOCK_FUSION
+
+	// sequential fusion of the scalar measurements
+	for (size_t i = 0; i < N; i++) {
+		if (!fuseVelPosHeight(innov[i], innov_var[i], state_index + i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template bool Ekf::fuseVelPos<2>(const float (&innov)[2], const float (&innov_var)[2], const float (&obs_var)[2],
+				 const int state_index);
+template bool Ekf::fuseVelPos<3>(const float (&innov)[3], const float (&innov_var)[3], const float (&obs_var)[3],
+				 const int state_index);
+
 void Ekf::fuseVelocity(estimator_aid_source2d_s &aid_src)
 {
 	if (!aid_src.innovation_rejected) {
 		// vx, vy
-		if (fuseVelPosHeight(aid_src.innovation[0], aid_src.innovation_variance[0], State::vel.idx)
-		    && fuseVelPosHeight(aid_src.innovation[1], aid_src.innovation_variance[1], State::vel.idx + 1)
-		   ) {
+		if (fuseVelPos(aid_src.innovation, aid_src.innovation_variance, aid_src.observation_variance, State::vel.idx)) {
 			aid_src.fused = true;
 			aid_src.time_last_fuse = _time_delayed_us;
 
@@ -152,10 +229,7 @@ void Ekf::fuseVelocity(estimator_aid_source3d_s &aid_src)
 {
 	if (!aid_src.innovation_rejected) {
 		// vx, vy, vz
-		if (fuseVelPosHeight(aid_src.innovation[0], aid_src.innovation_variance[0], State::vel.idx)
-		    && fuseVelPosHeight(aid_src.innovation[1], aid_src.innovation_variance[1], State::vel.idx + 1)
-		    && fuseVelPosHeight(aid_src.innovation[2], aid_src.innovation_variance[2], State::vel.idx + 2)
-		   ) {
+		if (fuseVelPos(aid_src.innovation, aid_src.innovation_variance, aid_src.observation_variance, State::vel.idx)) {
 			aid_src.fused = true;
 			aid_src.time_last_fuse = _time_delayed_us;
 
@@ -169,9 +243,7 @@ void Ekf::fuseHorizontalPosition(estimator_aid_source2d_s &aid_src)
 {
 	// x & y
 	if (!aid_src.innovation_rejected) {
-		if (fuseVelPosHeight(aid_src.innovation[0], aid_src.innovation_variance[0], State::pos.idx)
-		    && fuseVelPosHeight(aid_src.innovation[1], aid_src.innovation_variance[1], State::pos.idx + 1)
-		   ) {
+		if (fuseVelPos(aid_src.innovation, aid_src.innovation_variance, aid_src.observation_variance, State::pos.idx)) {
 			aid_src.fused = true;
 			aid_src.time_last_fuse = _time_delayed_us;
 
@@ -204,23 +276,16 @@ bool Ekf::fuseVelPosHeight(const float innov, const float innov_var, const int s
 
 	clearInhibitedStateKalmanGains(Kfusion);
 
-	SquareMatrixState KHP;
-
-	for (unsigned row = 0; row < State::size; row++) {
-		for (unsigned column = 0; column < State::size; column++) {
-			KHP(row, column) = Kfusion(row) * P(state_index, column);
-		}
-	}
-
-	const bool healthy = checkAndFixCovarianceUpdate(KHP);
+	// H selects a single state: KHP = K * P(state_index, :) = K * S * K'
+	const bool healthy = checkAndFixCovarianceUpdate(Kfusion, innov_var);
 
 	setVelPosStatus(state_index, healthy);
 
 	if (healthy) {
 		// apply the covariance corrections
-		P -= KHP;
+		P.rankOneUpdateSymmetric(Kfusion, -innov_var);
 
-		fixCovarianceErrors(true);
+		fixCovarianceErrors(false);
 
 		// apply the state corrections
 		fuse(Kfusion, innov);
@@ -232,6 +232,10 @@ EKF2::~EKF2()
 {
 	perf_free(_ekf_update_perf);
 	perf_free(_msg_missed_imu_perf);
+
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+	ImuFrontEnd::release(_imu_front_end);
+#endif // CONFIG_EKF2_MULTI_INSTANCE
 }
 
 #if defined(CONFIG_EKF2_MULTI_INSTANCE)
@@ -344,6 +348,14 @@ bool EKF2::multi_init(int imu, int mag)
 
 	bool changed_instance = _vehicle_imu_sub.ChangeInstance(imu);
 
+	// instances of the same IMU share the IMU pre-processing
+	ImuFrontEnd::release(_imu_front_end);
+	_imu_front_end = ImuFrontEnd::acquire(imu);
+
+	if (_imu_front_end == nullptr) {
+		changed_instance = false;
+	}
+
 #if defined(CONFIG_EKF2_MAGNETOMETER)
 
 	if (!_magnetometer_sub.ChangeInstance(mag)) {
@@ -381,6 +393,16 @@ int EKF2::print_status()
 	perf_print_counter(_ekf_update_perf);
 	perf_print_counter(_msg_missed_imu_perf);
 
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+
+	if (_imu_front_end) {
+		PX4_INFO_RAW("IMU %d front end: %d instances, %" PRIu32 " samples processed, %" PRIu32 " shared\n",
+			     _imu_front_end->imu_instance(), _imu_front_end->users(),
+			     _imu_front_end->samples_processed(), _imu_front_end->samples_shared());
+	}
+
+#endif // CONFIG_EKF2_MULTI_INSTANCE
+
 #if defined(DEBUG_BUILD)
 	_ekf.print_status();
 #endif // DEBUG_BUILD
@@ -540,6 +562,7 @@ void EKF2::Run()
 	hrt_abstime imu_dt = 0; // for tracking time slip later
 
 #if defined(CONFIG_EKF2_MULTI_INSTANCE)
+	ImuFrontEnd::Sample imu_front_end_sample{};
 
 	if (_multi_mode) {
 		const unsigned last_generation = _vehicle_imu_sub.get_last_generation();
@@ -551,17 +574,15 @@ void EKF2::Run()
 		}
 
 		if (imu_updated) {
-			imu_sample_new.time_us = imu.timestamp_sample;
-			imu_sample_new.delta_ang_dt = imu.delta_angle_dt * 1.e-6f;
-			imu_sample_new.delta_ang = Vector3f{imu.delta_angle};
-			imu_sample_new.delta_vel_dt = imu.delta_velocity_dt * 1.e-6f;
-			imu_sample_new.delta_vel = Vector3f{imu.delta_velocity};
-
-			if (imu.delta_velocity_clipping > 0) {
-				imu_sample_new.delta_vel_clipping[0] = imu.delta_velocity_clipping & vehicle_imu_s::CLIPPING_X;
-				imu_sample_new.delta_vel_clipping[1] = imu.delta_velocity_clipping & vehicle_imu_s::CLIPPING_Y;
-				imu_sample_new.delta_vel_clipping[2] = imu.delta_velocity_clipping & vehicle_imu_s::CLIPPING_Z;
+			// converted and down-sampled once for all instances using this IMU
+			if (!_imu_front_end->update(imu, _params->filter_update_interval_us, imu_front_end_sample)) {
+				imu_updated = false;
+				perf_count(_msg_missed_imu_perf);
 			}
+		}
+
+		if (imu_updated) {
+			imu_sample_new = imu_front_end_sample.imu;
 
 			imu_dt = imu.delta_angle_dt;
 
@@ -680,7 +701,17 @@ void EKF2::Run()
 		const hrt_abstime now = imu_sample_new.time_us;
 
 		// push imu data into estimator
-		_ekf.setIMUData(imu_sample_new);
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+
+		if (_multi_mode) {
+			_ekf.setIMUData(imu_sample_new, imu_front_end_sample.down_sampled ? &imu_front_end_sample.imu_down_sampled : nullptr);
+
+		} else
+#endif // CONFIG_EKF2_MULTI_INSTANCE
+		{
+			_ekf.setIMUData(imu_sample_new);
+		}
+
 		PublishAttitude(now); // publish attitude immediately (uses quaternion from output predictor)
 
 		// integrate time to monitor time slippage
@@ -2767,7 +2798,11 @@ int EKF2::task_spawn(int argc, char *argv[])
 					if ((vehicle_mag_sub.advertised() || mag == 0) && (vehicle_imu_sub.advertised())) {
 
 						if (!ekf2_instance_created[imu][mag]) {
+#if defined(CONFIG_EKF2_MULTI_INSTANCE_PARALLEL)
+							EKF2 *ekf2_inst = new EKF2(true, px4::ins_instance_to_wq(imu, mag), false);
+#else
 							EKF2 *ekf2_inst = new EKF2(true, px4::ins_instance_to_wq(imu), false);
+#endif // CONFIG_EKF2_MULTI_INSTANCE_PARALLEL
 
 							if (ekf2_inst && ekf2_inst->multi_init(imu, mag)) {
 								int actual_instance = ekf2_inst->instance(); // match uORB instance numbering
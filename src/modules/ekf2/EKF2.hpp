@@ -46,6 +46,10 @@
 
 #include "EKF2Selector.hpp"
 
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+# include "ImuFrontEnd.hpp"
+#endif // CONFIG_EKF2_MULTI_INSTANCE
+
 #include <float.h>
 
 #include <containers/LockGuard.hpp>
@@ -279,6 +283,10 @@ private:
 	perf_counter_t _ekf_update_perf{perf_alloc(PC_ELAPSED, MODULE_NAME": EKF update")};
 	perf_counter_t _msg_missed_imu_perf{perf_alloc(PC_COUNT, MODULE_NAME": IMU message missed")};
 
+#if defined(CONFIG_EKF2_MULTI_INSTANCE)
+	ImuFrontEnd *_imu_front_end{nullptr}; ///< IMU down-sampling shared with the other instances using the same IMU
+#endif // CONFIG_EKF2_MULTI_INSTANCE
+
 	InFlightCalibration _accel_cal{};
 	InFlightCalibration _gyro_cal{};
 
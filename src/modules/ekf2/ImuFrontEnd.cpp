@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ImuFrontEnd.hpp"
+
+ImuFrontEnd *ImuFrontEnd::_front_ends[ORB_MULTI_MAX_INSTANCES] {};
+
+ImuFrontEnd *ImuFrontEnd::acquire(uint8_t imu_instance)
+{
+	if (imu_instance >= ORB_MULTI_MAX_INSTANCES) {
+		return nullptr;
+	}
+
+	if (_front_ends[imu_instance] == nullptr) {
+		_front_ends[imu_instance] = new ImuFrontEnd(imu_instance);
+
+		if (_front_ends[imu_instance] == nullptr) {
+			return nullptr;
+		}
+	}
+
+	_front_ends[imu_instance]->_users++;
+
+	return _front_ends[imu_instance];
+}
+
+void ImuFrontEnd::release(ImuFrontEnd *front_end)
+{
+	if (front_end == nullptr) {
+		return;
+	}
+
+	if (--front_end->_users <= 0) {
+		_front_ends[front_end->_imu_instance] = nullptr;
+		delete front_end;
+	}
+}
+
+bool ImuFrontEnd::update(const vehicle_imu_s &imu, int32_t target_dt_us, Sample &sample_out)
+{
+	LockGuard lg{_mutex};
+
+	if (_newest >= 0) {
+		// already processed for another instance
+		for (int i = 0; i < kHistoryLength; i++) {
+			const Sample &sample = _history[(_newest + kHistoryLength - i) % kHistoryLength];
+
+			if ((sample.imu.time_us != 0) && (sample.imu.time_us == imu.timestamp_sample)) {
+				_samples_shared++;
+				sample_out = sample;
+				return true;
+			}
+		}
+
+		// the down-sampler state has already moved past this sample
+		if (imu.timestamp_sample < _history[_newest].imu.time_us) {
+			return false;
+		}
+	}
+
+	_newest = (_newest + 1) % kHistoryLength;
+	Sample &sample = _history[_newest];
+
+	sample.imu = {};
+	sample.imu.time_us = imu.timestamp_sample;
+	sample.imu.delta_ang_dt = imu.delta_angle_dt * 1.e-6f;
+	sample.imu.delta_ang = matrix::Vector3f{imu.delta_angle};
+	sample.imu.delta_vel_dt = imu.delta_velocity_dt * 1.e-6f;
+	sample.imu.delta_vel = matrix::Vector3f{imu.delta_velocity};
+
+	if (imu.delta_velocity_clipping > 0) {
+		sample.imu.delta_vel_clipping[0] = imu.delta_velocity_clipping & vehicle_imu_s::CLIPPING_X;
+		sample.imu.delta_vel_clipping[1] = imu.delta_velocity_clipping & vehicle_imu_s::CLIPPING_Y;
+		sample.imu.delta_vel_clipping[2] = imu.delta_velocity_clipping & vehicle_imu_s::CLIPPING_Z;
+	}
+
+	if (target_dt_us != _target_dt_us) {
+		// the down-sampler only applies the target interval on reset
+		_target_dt_us = target_dt_us;
+		_imu_down_sampler.reset();
+	}
+
+	sample.down_sampled = _imu_down_sampler.update(sample.imu);
+
+	if (sample.down_sampled) {
+		sample.imu_down_sampled = _imu_down_sampler.getDownSampledImuAndTriggerReset();
+	}
+
+	_samples_processed++;
+
+	sample_out = sample;
+	return true;
+}
@@ -0,0 +1,109 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file ImuFrontEnd.hpp
+ *
+ * IMU pre-processing (conversion and down-sampling) shared by all EKF2 instances using the same IMU.
+ *
+ * The first EKF2 instance processing a vehicle_imu sample converts and down-samples it, the others copy the result.
+ * The instances of an IMU can run on separate work queues (CONFIG_EKF2_MULTI_INSTANCE_PARALLEL).
+ */
+
+#pragma once
+
+#include "EKF/common.h"
+#include "EKF/imu_down_sampler.hpp"
+
+#include <containers/LockGuard.hpp>
+#include <pthread.h>
+#include <uORB/uORB.h>
+#include <uORB/topics/vehicle_imu.h>
+
+class ImuFrontEnd
+{
+public:
+	struct Sample {
+		imuSample imu{};              ///< IMU sample at the sensor rate
+		imuSample imu_down_sampled{}; ///< down-sampled IMU sample, only valid if down_sampled is set
+		bool down_sampled{false};
+	};
+
+	/**
+	 * Get the shared front end of an IMU instance, created on first use.
+	 * Not thread safe, only call when starting and stopping the EKF2 instances.
+	 */
+	static ImuFrontEnd *acquire(uint8_t imu_instance);
+
+	static void release(ImuFrontEnd *front_end);
+
+	/**
+	 * Process a vehicle_imu sample, it is only converted and down-sampled once for all users.
+	 * Thread safe, the users can run on different work queues.
+	 *
+	 * @param imu vehicle_imu sample
+	 * @param target_dt_us down-sampling target interval (EKF2_PREDICT_US)
+	 * @param sample processed sample
+	 * @return false if the sample is older than the recent history
+	 */
+	bool update(const vehicle_imu_s &imu, int32_t target_dt_us, Sample &sample);
+
+	uint8_t imu_instance() const { return _imu_instance; }
+	int users() const { return _users; }
+	uint32_t samples_processed() const { return _samples_processed; }
+	uint32_t samples_shared() const { return _samples_shared; }
+
+private:
+	explicit ImuFrontEnd(uint8_t imu_instance) : _imu_instance(imu_instance) { pthread_mutex_init(&_mutex, nullptr); }
+	~ImuFrontEnd() { pthread_mutex_destroy(&_mutex); }
+
+	// vehicle_imu has a queue length of 1, users scheduled by the same publication see the same sample and a
+	// short history covers users that were delayed by one or more samples
+	static constexpr int kHistoryLength = 4;
+
+	pthread_mutex_t _mutex{}; ///< protects the history, the down-sampler and the counters
+
+	Sample _history[kHistoryLength] {};
+	int _newest{-1};
+
+	int32_t _target_dt_us{0};
+	ImuDownSampler _imu_down_sampler{_target_dt_us};
+
+	const uint8_t _imu_instance;
+	int _users{0};
+
+	uint32_t _samples_processed{0};
+	uint32_t _samples_shared{0};
+
+	static ImuFrontEnd *_front_ends[ORB_MULTI_MAX_INSTANCES];
+};
@@ -210,6 +210,35 @@ TEST_F(EkfBasicsTest, accelBiasEstimation)
 			<< "gyro_bias = " << gyro_bias(0) << ", " << gyro_bias(1) << ", " << gyro_bias(2);
 }
 
+TEST_F(EkfBasicsTest, measurementUpdateCovariance)
+{
+	// GIVEN: initialized EKF and a direct observation of the north position
+	const unsigned state_index = State::pos.idx;
+	const Ekf::SquareMatrixState P_prior = _ekf->covariances();
+	const float innovation_variance = P_prior(state_index, state_index) + 0.1f;
+
+	Ekf::VectorState K;
+
+	for (unsigned row = 0; row < State::size; row++) {
+		K(row) = P_prior(row, state_index) / innovation_variance;
+	}
+
+	// WHEN: fusing it
+	EXPECT_TRUE(_ekf->measurementUpdate(K, innovation_variance, 0.f));
+
+	// THEN: the covariance correction is the full K * S * K' update
+	// and the covariance matrix stays symmetric
+	const Ekf::SquareMatrixState &P = _ekf->covariances();
+
+	for (unsigned row = 0; row < State::size; row++) {
+		for (unsigned col = 0; col < State::size; col++) {
+			EXPECT_NEAR(P(row, col), P_prior(row, col) - K(row) * innovation_variance * K(col), 1e-5f)
+					<< "P(" << row << ", " << col << ")";
+			EXPECT_EQ(P(row, col), P(col, row)) << "P(" << row << ", " << col << ")";
+		}
+	}
+}
+
 TEST_F(EkfBasicsTest, reset_ekf_global_origin_gps_initialized)
 {
 	_latitude_new  = 15.0000005;
@@ -217,3 +217,41 @@ TEST_F(EkfImuSamplingTest, gyroDownSampling)
 	EXPECT_TRUE(matrix::isEqual(ang_vel * 0.008f, output_sample.delta_ang, 1e-10f));
 	EXPECT_TRUE(matrix::isEqual(accel * 0.008f, output_sample.delta_vel, 1e-10f));
 }
+
+TEST_F(EkfImuSamplingTest, externallyDownSampledImu)
+{
+	// GIVEN: a second filter fed by an external down-sampler (e.g. shared between instances using the same IMU)
+	Ekf ekf_external{};
+	ekf_external.init(0);
+	int32_t target_dt_us = 10000;
+	ImuDownSampler sampler(target_dt_us);
+
+	imuSample imu_sample;
+	imu_sample.delta_ang_dt = 0.004f;
+	imu_sample.delta_ang = Vector3f{0.1f, -0.2f, 0.3f} * imu_sample.delta_ang_dt;
+	imu_sample.delta_vel_dt = 0.004f;
+	imu_sample.delta_vel = Vector3f{-0.46f, 0.87f, -9.7f} * imu_sample.delta_vel_dt;
+
+	// WHEN: both filters receive the same IMU data
+	for (int i = 0; i < 500; ++i) {
+		imu_sample.time_us = _t_us;
+		_ekf.setIMUData(imu_sample);
+		_ekf.update();
+
+		if (sampler.update(imu_sample)) {
+			const imuSample imu_sample_down_sampled = sampler.getDownSampledImuAndTriggerReset();
+			ekf_external.setIMUData(imu_sample, &imu_sample_down_sampled);
+
+		} else {
+			ekf_external.setIMUData(imu_sample, nullptr);
+		}
+
+		ekf_external.update();
+		_t_us += 4000;
+	}
+
+	// THEN: the states should be identical
+	EXPECT_EQ(_ekf.get_imu_sample_delayed().time_us, ekf_external.get_imu_sample_delayed().time_us);
+	EXPECT_TRUE(matrix::isEqual(_ekf.state().vector(), ekf_external.state().vector(), 0.f));
+	EXPECT_TRUE(matrix::isEqual(_ekf.getVelocity(), ekf_external.getVelocity(), 0.f));
+}
@@ -0,0 +1,208 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file test_EKF_vel_pos_block_fusion.cpp
+ *
+ * @brief Compares the block fusion of velocity and position measurements (CONFIG_EKF2_VEL_POS_BLOCK_FUSION)
+ * with the sequential fusion of the same measurements, one axis at a time.
+ */
+
+#include <gtest/gtest.h>
+#include "EKF/ekf.h"
+
+#if !defined(CONFIG_EKF2_VEL_POS_BLOCK_FUSION)
+# error "the block fusion of velocity and position has to be enabled for this test"
+#endif
+
+class EkfVelPosBlockFusionTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		// identical filters with a correlated covariance matrix, after a few seconds of covariance prediction
+		// (and fake position fusion, as there is no other aiding source)
+		_ekf_block.init(0);
+		_ekf_sequential.init(0);
+
+		const float dt = 0.004f;
+		const Vector3f accel{0.5f, -0.3f, -CONSTANTS_ONE_G};
+		const Vector3f gyro{0.01f, -0.02f, 0.03f};
+
+		for (int i = 1; i <= 1250; i++) {
+			imuSample imu_sample{};
+			imu_sample.time_us = i * 4000;
+			imu_sample.delta_ang = gyro * dt;
+			imu_sample.delta_vel = accel * dt;
+			imu_sample.delta_ang_dt = dt;
+			imu_sample.delta_vel_dt = dt;
+
+			_ekf_block.setIMUData(imu_sample);
+			_ekf_block.update();
+
+			_ekf_sequential.setIMUData(imu_sample);
+			_ekf_sequential.update();
+		}
+
+		ASSERT_EQ(_ekf_block.covariances(), _ekf_sequential.covariances());
+		ASSERT_EQ(_ekf_block.state().vector(), _ekf_sequential.state().vector());
+
+		// the observed states are correlated with the others, otherwise there is nothing to compare
+		ASSERT_NE(_ekf_block.stateCovariance(State::vel.idx, State::quat_nominal.idx), 0.f);
+		ASSERT_NE(_ekf_block.stateCovariance(State::pos.idx, State::vel.idx), 0.f);
+	}
+
+	// the observed states (StateSample::vel or StateSample::pos) start at state_index of the error state
+	template<size_t N>
+	void fuseBlock(const float (&obs)[N], const float (&obs_var)[N], Vector3f StateSample::*observed,
+		       const int state_index)
+	{
+		float innov[N];
+		float innov_var[N];
+
+		for (size_t i = 0; i < N; i++) {
+			innov[i] = (_ekf_block.state().*observed)(i) - obs[i];
+			innov_var[i] = _ekf_block.stateCovariance(state_index + i, state_index + i) + obs_var[i];
+		}
+
+		EXPECT_TRUE(_ekf_block.fuseVelPos(innov, innov_var, obs_var, state_index));
+	}
+
+	template<size_t N>
+	void fuseSequential(const float (&obs)[N], const float (&obs_var)[N], Vector3f StateSample::*observed,
+			    const int state_index)
+	{
+		// the innovation and its variance are updated after each axis, which makes the sequential fusion of
+		// measurements with independent errors equivalent to the block fusion
+		for (size_t i = 0; i < N; i++) {
+			const int index = state_index + i;
+			const float innov = (_ekf_sequential.state().*observed)(i) - obs[i];
+			const float innov_var = _ekf_sequential.stateCovariance(index, index) + obs_var[i];
+
+			EXPECT_TRUE(_ekf_sequential.fuseVelPosHeight(innov, innov_var, index));
+		}
+	}
+
+	void expectEqualFusionResult() const
+	{
+		const auto &P_block = _ekf_block.covariances();
+		const auto &P_sequential = _ekf_sequential.covariances();
+
+		for (unsigned row = 0; row < State::size; row++) {
+			for (unsigned col = 0; col < State::size; col++) {
+				// relative to the standard deviations of the two states
+				const float tolerance = 1e-4f * sqrtf(P_sequential(row, row) * P_sequential(col, col)) + 1e-12f;
+				EXPECT_NEAR(P_block(row, col), P_sequential(row, col), tolerance) << "P(" << row << ", " << col << ")";
+			}
+		}
+
+		// the sequential fusion applies the attitude corrections as separate rotations,
+		// which only differs from the rotation of the block fusion by a second order term
+		const Quatf q_error = _ekf_sequential.state().quat_nominal.inversed() * _ekf_block.state().quat_nominal;
+		EXPECT_LT(AxisAnglef(q_error).angle(), 1e-3f);
+
+		const auto &x_block = _ekf_block.state().vector();
+		const auto &x_sequential = _ekf_sequential.state().vector();
+
+		// the remaining states, after the quaternion
+		for (unsigned i = 4; i < sizeof(StateSample) / sizeof(float); i++) {
+			EXPECT_NEAR(x_block(i), x_sequential(i), 1e-5f * fmaxf(1.f, fabsf(x_sequential(i)))) << "state " << i;
+		}
+	}
+
+	Ekf _ekf_block{};
+	Ekf _ekf_sequential{};
+};
+
+TEST_F(EkfVelPosBlockFusionTest, horizontalVelocity)
+{
+	// GIVEN: a horizontal velocity measurement with different variances per axis
+	const float obs[2] {0.3f, -0.2f};
+	const float obs_var[2] {0.25f, 0.36f};
+
+	// WHEN: it is fused as a block and sequentially
+	fuseBlock(obs, obs_var, &StateSample::vel, State::vel.idx);
+	fuseSequential(obs, obs_var, &StateSample::vel, State::vel.idx);
+
+	// THEN: the covariance matrix and the state are the same
+	expectEqualFusionResult();
+}
+
+TEST_F(EkfVelPosBlockFusionTest, velocity3D)
+{
+	// GIVEN: a 3D velocity measurement
+	const float obs[3] {0.3f, -0.2f, 0.1f};
+	const float obs_var[3] {0.25f, 0.36f, 0.5f};
+
+	// WHEN: it is fused as a block and sequentially
+	fuseBlock(obs, obs_var, &StateSample::vel, State::vel.idx);
+	fuseSequential(obs, obs_var, &StateSample::vel, State::vel.idx);
+
+	// THEN: the covariance matrix and the state are the same
+	expectEqualFusionResult();
+}
+
+TEST_F(EkfVelPosBlockFusionTest, horizontalPosition)
+{
+	// GIVEN: a horizontal position measurement
+	const float obs[2] {1.f, -0.5f};
+	const float obs_var[2] {0.5f, 0.8f};
+
+	// WHEN: it is fused as a block and sequentially
+	fuseBlock(obs, obs_var, &StateSample::pos, State::pos.idx);
+	fuseSequential(obs, obs_var, &StateSample::pos, State::pos.idx);
+
+	// THEN: the covariance matrix and the state are the same
+	expectEqualFusionResult();
+}
+
+TEST_F(EkfVelPosBlockFusionTest, repeatedVelocityAndPosition)
+{
+	// GIVEN: a sequence of 3D velocity and horizontal position measurements
+	for (int i = 0; i < 10; i++) {
+		const float vel_obs[3] {0.1f * i, -0.05f * i, 0.02f * i};
+		const float vel_obs_var[3] {0.09f, 0.09f, 0.16f};
+		const float pos_obs[2] {0.2f * i, 0.1f * i};
+		const float pos_obs_var[2] {0.25f, 0.25f};
+
+		// WHEN: they are fused as blocks and sequentially
+		fuseBlock(vel_obs, vel_obs_var, &StateSample::vel, State::vel.idx);
+		fuseBlock(pos_obs, pos_obs_var, &StateSample::pos, State::pos.idx);
+
+		fuseSequential(vel_obs, vel_obs_var, &StateSample::vel, State::vel.idx);
+		fuseSequential(pos_obs, pos_obs_var, &StateSample::pos, State::pos.idx);
+	}
+
+	// THEN: the covariance matrix and the state are the same
+	expectEqualFusionResult();
+}
@@ -0,0 +1,268 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "ImuFrontEnd.hpp"
+
+class ImuFrontEndTest : public ::testing::Test
+{
+public:
+	void SetUp() override
+	{
+		_front_end = ImuFrontEnd::acquire(0);
+		ASSERT_NE(_front_end, nullptr);
+	}
+
+	void TearDown() override
+	{
+		ImuFrontEnd::release(_front_end);
+	}
+
+	vehicle_imu_s vehicleImu(uint64_t timestamp_sample)
+	{
+		vehicle_imu_s imu{};
+		imu.timestamp = timestamp_sample;
+		imu.timestamp_sample = timestamp_sample;
+		imu.delta_angle[0] = 0.001f;
+		imu.delta_angle[1] = -0.002f;
+		imu.delta_angle[2] = 0.003f;
+		imu.delta_velocity[0] = -0.002f;
+		imu.delta_velocity[1] = 0.004f;
+		imu.delta_velocity[2] = -0.039f;
+		imu.delta_angle_dt = 4000;
+		imu.delta_velocity_dt = 4000;
+		return imu;
+	}
+
+	ImuFrontEnd *_front_end{nullptr};
+
+	static constexpr int32_t kTargetDtUs{10000};
+};
+
+TEST_F(ImuFrontEndTest, sharedBetweenUsers)
+{
+	// GIVEN: a second user of the same IMU and a user of another IMU
+	ImuFrontEnd *front_end_same = ImuFrontEnd::acquire(0);
+	ImuFrontEnd *front_end_other = ImuFrontEnd::acquire(1);
+
+	// THEN: the users of the same IMU share the front end
+	EXPECT_EQ(front_end_same, _front_end);
+	EXPECT_NE(front_end_other, _front_end);
+	EXPECT_EQ(_front_end->users(), 2);
+	EXPECT_EQ(front_end_other->users(), 1);
+
+	// WHEN: both users process the same sample
+	const vehicle_imu_s imu = vehicleImu(4000);
+	ImuFrontEnd::Sample sample{};
+	ImuFrontEnd::Sample sample_same{};
+	ASSERT_TRUE(_front_end->update(imu, kTargetDtUs, sample));
+	ASSERT_TRUE(front_end_same->update(imu, kTargetDtUs, sample_same));
+
+	// THEN: it is only processed once
+	EXPECT_EQ(sample_same.imu.time_us, imu.timestamp_sample);
+	EXPECT_EQ(sample.imu.time_us, imu.timestamp_sample);
+	EXPECT_EQ(_front_end->samples_processed(), 1u);
+	EXPECT_EQ(_front_end->samples_shared(), 1u);
+
+	// WHEN: the users release the front ends
+	ImuFrontEnd::release(front_end_same);
+	ImuFrontEnd::release(front_end_other);
+
+	// THEN: the front end of the other IMU is deleted with its last user and created again on the next use
+	EXPECT_EQ(_front_end->users(), 1);
+	front_end_other = ImuFrontEnd::acquire(1);
+	ASSERT_NE(front_end_other, nullptr);
+	EXPECT_EQ(front_end_other->users(), 1);
+	EXPECT_EQ(front_end_other->samples_processed(), 0u);
+	ImuFrontEnd::release(front_end_other);
+}
+
+TEST_F(ImuFrontEndTest, conversion)
+{
+	// WHEN: a sample with clipping is processed
+	vehicle_imu_s imu = vehicleImu(4000);
+	imu.delta_velocity_clipping = vehicle_imu_s::CLIPPING_X | vehicle_imu_s::CLIPPING_Z;
+	ImuFrontEnd::Sample sample{};
+	ASSERT_TRUE(_front_end->update(imu, kTargetDtUs, sample));
+
+	// THEN: it is converted to the EKF IMU sample
+	EXPECT_EQ(sample.imu.time_us, imu.timestamp_sample);
+	EXPECT_FLOAT_EQ(sample.imu.delta_ang_dt, 0.004f);
+	EXPECT_FLOAT_EQ(sample.imu.delta_vel_dt, 0.004f);
+	EXPECT_TRUE(matrix::isEqual(sample.imu.delta_ang, matrix::Vector3f{imu.delta_angle}, 0.f));
+	EXPECT_TRUE(matrix::isEqual(sample.imu.delta_vel, matrix::Vector3f{imu.delta_velocity}, 0.f));
+	EXPECT_TRUE(sample.imu.delta_vel_clipping[0]);
+	EXPECT_FALSE(sample.imu.delta_vel_clipping[1]);
+	EXPECT_TRUE(sample.imu.delta_vel_clipping[2]);
+}
+
+TEST_F(ImuFrontEndTest, downSampling)
+{
+	// GIVEN: a local down-sampler as reference
+	int32_t target_dt_us = kTargetDtUs;
+	ImuDownSampler reference(target_dt_us);
+
+	for (int i = 1; i <= 100; i++) {
+		// WHEN: the same samples are processed by the front end and the reference
+		const vehicle_imu_s imu = vehicleImu(i * 4000);
+		ImuFrontEnd::Sample sample{};
+		ASSERT_TRUE(_front_end->update(imu, kTargetDtUs, sample));
+
+		// THEN: the down-sampled samples are identical
+		const bool down_sampled = reference.update(sample.imu);
+		ASSERT_EQ(sample.down_sampled, down_sampled);
+
+		if (down_sampled) {
+			const imuSample imu_down_sampled = reference.getDownSampledImuAndTriggerReset();
+			EXPECT_EQ(sample.imu_down_sampled.time_us, imu_down_sampled.time_us);
+			EXPECT_FLOAT_EQ(sample.imu_down_sampled.delta_ang_dt, imu_down_sampled.delta_ang_dt);
+			EXPECT_TRUE(matrix::isEqual(sample.imu_down_sampled.delta_ang, imu_down_sampled.delta_ang, 0.f));
+			EXPECT_TRUE(matrix::isEqual(sample.imu_down_sampled.delta_vel, imu_down_sampled.delta_vel, 0.f));
+		}
+	}
+
+	EXPECT_EQ(_front_end->samples_processed(), 100u);
+	EXPECT_EQ(_front_end->samples_shared(), 0u);
+}
+
+TEST_F(ImuFrontEndTest, delayedUserHistory)
+{
+	// GIVEN: a user that is ahead by 3 samples
+	ImuFrontEnd::Sample samples[4] {};
+
+	for (int i = 0; i < 4; i++) {
+		ASSERT_TRUE(_front_end->update(vehicleImu((i + 1) * 4000), kTargetDtUs, samples[i]));
+	}
+
+	// WHEN: the delayed user processes the same samples
+	for (int i = 0; i < 4; i++) {
+		ImuFrontEnd::Sample sample{};
+		ASSERT_TRUE(_front_end->update(vehicleImu((i + 1) * 4000), kTargetDtUs, sample));
+
+		// THEN: it gets the samples from the history, including their down-sampling result
+		EXPECT_EQ(sample.imu.time_us, (uint64_t)(i + 1) * 4000);
+		EXPECT_EQ(sample.down_sampled, samples[i].down_sampled);
+		EXPECT_EQ(sample.imu_down_sampled.time_us, samples[i].imu_down_sampled.time_us);
+	}
+
+	EXPECT_EQ(_front_end->samples_processed(), 4u);
+	EXPECT_EQ(_front_end->samples_shared(), 4u);
+}
+
+TEST_F(ImuFrontEndTest, staleSample)
+{
+	// GIVEN: more new samples than the history holds
+	ImuFrontEnd::Sample sample{};
+
+	for (int i = 1; i <= 5; i++) {
+		ASSERT_TRUE(_front_end->update(vehicleImu(i * 4000), kTargetDtUs, sample));
+	}
+
+	// WHEN: a user processes a sample that dropped out of the history
+	// THEN: it is rejected, the down-sampler state has already moved past it
+	EXPECT_FALSE(_front_end->update(vehicleImu(4000), kTargetDtUs, sample));
+	EXPECT_EQ(_front_end->samples_processed(), 5u);
+
+	// WHEN: a user processes a sample between the ones in the history (e.g. after a timestamp reset of the sensor)
+	// THEN: it is rejected as well
+	EXPECT_FALSE(_front_end->update(vehicleImu(4000 * 4 + 1000), kTargetDtUs, sample));
+
+	// WHEN: a new sample arrives
+	// THEN: it is processed
+	ASSERT_TRUE(_front_end->update(vehicleImu(6 * 4000), kTargetDtUs, sample));
+	EXPECT_EQ(sample.imu.time_us, 6u * 4000);
+	EXPECT_EQ(_front_end->samples_processed(), 6u);
+}
+
+TEST_F(ImuFrontEndTest, concurrentUsers)
+{
+	// GIVEN: the expected results of a single user
+	static constexpr int kSamples = 2000;
+	static constexpr int kUsers = 3;
+
+	ImuFrontEnd *front_end_reference = ImuFrontEnd::acquire(1);
+	ASSERT_NE(front_end_reference, nullptr);
+
+	std::vector<ImuFrontEnd::Sample> expected(kSamples);
+
+	for (int i = 0; i < kSamples; i++) {
+		ASSERT_TRUE(front_end_reference->update(vehicleImu((i + 1) * 4000), kTargetDtUs, expected[i]));
+	}
+
+	ImuFrontEnd::release(front_end_reference);
+
+	// WHEN: several users on different threads process the same samples, at most 2 samples apart
+	std::atomic<int> progress[kUsers] {};
+	std::atomic<int> mismatches{0};
+	std::vector<std::thread> users;
+
+	for (int user = 0; user < kUsers; user++) {
+		users.emplace_back([&, user]() {
+			for (int i = 0; i < kSamples; i++) {
+				for (int other = 0; other < kUsers; other++) {
+					while (progress[other].load() < i - 2) {
+						std::this_thread::yield();
+					}
+				}
+
+				ImuFrontEnd::Sample sample{};
+
+				if (!_front_end->update(vehicleImu((i + 1) * 4000), kTargetDtUs, sample)
+				    || (sample.imu.time_us != expected[i].imu.time_us)
+				    || (sample.down_sampled != expected[i].down_sampled)
+				    || (sample.down_sampled
+					&& ((sample.imu_down_sampled.time_us != expected[i].imu_down_sampled.time_us)
+					    || !matrix::isEqual(sample.imu_down_sampled.delta_vel, expected[i].imu_down_sampled.delta_vel, 0.f)))) {
+					mismatches++;
+				}
+
+				progress[user].store(i + 1);
+			}
+		});
+	}
+
+	for (auto &user : users) {
+		user.join();
+	}
+
+	// THEN: every user gets the results of a single user and every sample is processed once
+	EXPECT_EQ(mismatches.load(), 0);
+	EXPECT_EQ(_front_end->samples_processed(), (uint32_t)kSamples);
+	EXPECT_EQ(_front_end->samples_shared(), (uint32_t)(kSamples * (kUsers - 1)));
+}
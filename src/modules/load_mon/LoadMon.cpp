@@ -109,6 +109,10 @@ void LoadMon::Run()
 
 #endif
 
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+	work_item_status();
+#endif
+
 	if (should_exit()) {
 		ScheduleClear();
 #if defined (__PX4_LINUX)
@@ -244,6 +248,38 @@ void LoadMon::cpuload()
 #endif
 }
 
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+void LoadMon::work_item_status()
+{
+	// matches the queue length, so that subscribers don't miss any
+	static constexpr int ITEMS_PER_CYCLE = work_item_status_s::ORB_QUEUE_LENGTH;
+
+	for (int i = 0; i < ITEMS_PER_CYCLE; i++) {
+		px4::work_item_stats_t stats{};
+
+		if (!px4::WorkQueueManagerItemStats(_work_item_index, stats)) {
+			// start over in the next cycle
+			_work_item_index = 0;
+			return;
+		}
+
+		work_item_status_s status{};
+		strncpy(status.item_name, stats.item_name, sizeof(status.item_name) - 1);
+		strncpy(status.wq_name, stats.wq_name, sizeof(status.wq_name) - 1);
+		status.latency_p50 = stats.latency_p50;
+		status.latency_p99 = stats.latency_p99;
+		status.latency_max = stats.latency_max;
+		status.run_time_p50 = stats.run_time_p50;
+		status.run_time_p99 = stats.run_time_p99;
+		status.run_time_max = stats.run_time_max;
+		status.timestamp = hrt_absolute_time();
+		_work_item_status_pub.publish(status);
+
+		_work_item_index++;
+	}
+}
+#endif // CONFIG_WORK_QUEUE_HISTOGRAMS
+
 #if defined(__PX4_NUTTX)
 void LoadMon::stack_usage()
 {
@@ -310,7 +346,8 @@ int LoadMon::print_usage(const char *reason)
 		R"DESCR_STR(
 ### Description
 Background process running periodically on the low priority work queue to calculate the CPU load and RAM
-usage and publish the `cpuload` topic.
+usage and publish the `cpuload` topic. It also publishes the latency and run time statistics
+of the WorkItems as `work_item_status`.
 
 On NuttX it also checks the stack usage of each process and if it falls below 300 bytes, a warning is output,
 which will also appear in the log file.
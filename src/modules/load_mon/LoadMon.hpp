@@ -43,10 +43,12 @@
 #include <px4_platform_common/module.h>
 #include <px4_platform_common/module_params.h>
 #include <px4_platform_common/px4_work_queue/ScheduledWorkItem.hpp>
+#include <px4_platform_common/px4_work_queue/WorkQueueManager.hpp>
 #include <px4_platform/cpuload.h>
 #include <uORB/Publication.hpp>
 #include <uORB/topics/cpuload.h>
 #include <uORB/topics/task_stack_info.h>
+#include <uORB/topics/work_item_status.h>
 
 #if defined(__PX4_LINUX)
 #include <sys/times.h>
@@ -92,6 +94,15 @@ private:
 #endif
 	uORB::Publication<cpuload_s> _cpuload_pub {ORB_ID(cpuload)};
 
+#if defined(CONFIG_WORK_QUEUE_HISTOGRAMS)
+	/* Publish the latency and run time statistics of the next few WorkItems */
+	void work_item_status();
+
+	unsigned _work_item_index{0};
+
+	uORB::Publication<work_item_status_s> _work_item_status_pub{ORB_ID(work_item_status)};
+#endif
+
 #if defined(__PX4_LINUX)
 	FILE *_proc_fd = nullptr;
 	/* calculate usage directly from clock ticks on Linux */
@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "delta_encoder.h"
+#include "messages.h"
+
+#include <string.h>
+
+namespace px4
+{
+namespace logger
+{
+
+bool DeltaEncoder::init(int num_subscriptions)
+{
+	deinit();
+
+	if (num_subscriptions <= 0) {
+		return false;
+	}
+
+	_subscriptions = new Subscription[num_subscriptions];
+
+	if (!_subscriptions) {
+		return false;
+	}
+
+	_num_subscriptions = num_subscriptions;
+	return true;
+}
+
+void DeltaEncoder::deinit()
+{
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		delete[] _subscriptions[i].previous;
+	}
+
+	delete[] _subscriptions;
+	_subscriptions = nullptr;
+	_num_subscriptions = 0;
+
+	delete[] _buffer;
+	_buffer = nullptr;
+	_buffer_size = 0;
+}
+
+bool DeltaEncoder::enable(int sub_idx, uint16_t size)
+{
+	if (sub_idx >= _num_subscriptions || size == 0 || enabled(sub_idx)) {
+		return false;
+	}
+
+	const int buffer_size = sizeof(ulog_message_data_delta_s) + size;
+
+	if (buffer_size > _buffer_size) {
+		uint8_t *buffer = new uint8_t[buffer_size];
+
+		if (!buffer) {
+			return false;
+		}
+
+		delete[] _buffer;
+		_buffer = buffer;
+		_buffer_size = buffer_size;
+	}
+
+	Subscription &sub = _subscriptions[sub_idx];
+	sub.previous = new uint8_t[size];
+
+	if (!sub.previous) {
+		return false;
+	}
+
+	sub.size = size;
+	sub.valid = false;
+	return true;
+}
+
+void DeltaEncoder::reset()
+{
+	for (int i = 0; i < _num_subscriptions; ++i) {
+		_subscriptions[i].valid = false;
+	}
+}
+
+int DeltaEncoder::encode(int sub_idx, const uint8_t *data)
+{
+	const Subscription &sub = _subscriptions[sub_idx];
+
+	if (!sub.valid) {
+		return -1;
+	}
+
+	// only worth it if smaller than the full sample
+	return encode(data, sub.previous, sub.size, _buffer + sizeof(ulog_message_data_delta_s), sub.size - 1);
+}
+
+void DeltaEncoder::sample_written(int sub_idx, const uint8_t *data)
+{
+	if (enabled(sub_idx)) {
+		Subscription &sub = _subscriptions[sub_idx];
+		memcpy(sub.previous, data, sub.size);
+		sub.valid = true;
+	}
+}
+
+} //namespace logger
+} //namespace px4
@@ -0,0 +1,243 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class DeltaEncoder
+ * Delta encoding of the data messages of selected subscriptions (@see ulog_message_data_delta_s):
+ * each sample is XOR'ed with the previous sample written for the same subscription, and the result is packed
+ * as a sequence of [unchanged byte count, changed byte count, changed bytes] runs with varint lengths.
+ * Consecutive samples of high-rate topics typically only differ in a few bytes (timestamp, low mantissa bytes).
+ *
+ * The encoding and decoding functions are header-only, so that they can be used by log readers (replay).
+ */
+class DeltaEncoder
+{
+public:
+	DeltaEncoder() = default;
+	~DeltaEncoder() { deinit(); }
+
+	DeltaEncoder(const DeltaEncoder &) = delete;
+	DeltaEncoder &operator=(const DeltaEncoder &) = delete;
+
+	/**
+	 * Allocate the state for a number of subscriptions (delta encoding is not enabled for any of them yet)
+	 * @return false if the memory could not be allocated
+	 */
+	bool init(int num_subscriptions);
+
+	void deinit();
+
+	/**
+	 * Enable delta encoding for a subscription
+	 * @param sub_idx subscription index
+	 * @param size data size of the topic (without padding)
+	 * @return false if the memory could not be allocated
+	 */
+	bool enable(int sub_idx, uint16_t size);
+
+	/** true if delta encoding is enabled for at least one subscription */
+	bool enabled() const { return _buffer != nullptr; }
+
+	bool enabled(int sub_idx) const { return sub_idx < _num_subscriptions && _subscriptions[sub_idx].previous; }
+
+	/**
+	 * Invalidate the previous samples of all subscriptions, so that the next sample of each is written in full.
+	 * Called at the start of a log and after every SYNC message, so that readers can start decoding there.
+	 */
+	void reset();
+
+	/** invalidate the previous sample of a subscription (e.g. because a write failed) */
+	void invalidate(int sub_idx)
+	{
+		if (enabled(sub_idx)) {
+			_subscriptions[sub_idx].valid = false;
+		}
+	}
+
+	/**
+	 * Encode a sample of a subscription into message_buffer(), after the message header.
+	 * @param sub_idx subscription index (delta encoding must be enabled)
+	 * @param data sample
+	 * @return encoded data size, or -1 if the sample must be written in full (no previous sample, or the encoded
+	 *         sample would not be smaller)
+	 */
+	int encode(int sub_idx, const uint8_t *data);
+
+	/**
+	 * Called after a sample of a subscription has been written (in full or delta encoded)
+	 */
+	void sample_written(int sub_idx, const uint8_t *data);
+
+	/** message buffer for delta encoded messages, large enough for any enabled subscription */
+	uint8_t *message_buffer() { return _buffer; }
+
+	/**
+	 * XOR encode data with previous and pack it. Trailing unchanged bytes are omitted.
+	 * @param out output buffer
+	 * @param out_size output buffer size
+	 * @return encoded size, or -1 if it exceeds out_size
+	 */
+	static int encode(const uint8_t *data, const uint8_t *previous, int size, uint8_t *out, int out_size)
+	{
+		int out_len = 0;
+		int i = 0;
+
+		while (i < size) {
+			const int unchanged_start = i;
+
+			while (i < size && data[i] == previous[i]) {
+				++i;
+			}
+
+			if (i == size) {
+				break;
+			}
+
+			// a single unchanged byte is cheaper to store as part of the changed bytes than to start a new run
+			const int changed_start = i;
+
+			while (i < size && !(data[i] == previous[i] && (i + 1 == size || data[i + 1] == previous[i + 1]))) {
+				++i;
+			}
+
+			if (out_len + 2 * MAX_VARINT_SIZE + (i - changed_start) > out_size) {
+				return -1;
+			}
+
+			out_len += write_varint(out + out_len, changed_start - unchanged_start);
+			out_len += write_varint(out + out_len, i - changed_start);
+
+			for (int j = changed_start; j < i; ++j) {
+				out[out_len++] = data[j] ^ previous[j];
+			}
+		}
+
+		return out_len;
+	}
+
+	/**
+	 * Decode in place
+	 * @param in encoded data
+	 * @param in_size encoded size
+	 * @param data previous sample, replaced with the decoded sample
+	 * @param size data size
+	 * @return false if the encoded data is corrupt
+	 */
+	static bool decode(const uint8_t *in, int in_size, uint8_t *data, int size)
+	{
+		int in_pos = 0;
+		int pos = 0;
+
+		while (in_pos < in_size) {
+			uint32_t unchanged;
+			uint32_t changed;
+
+			if (!read_varint(in, in_size, in_pos, unchanged) || !read_varint(in, in_size, in_pos, changed)) {
+				return false;
+			}
+
+			if (pos + unchanged + changed > (uint32_t)size || in_pos + changed > (uint32_t)in_size) {
+				return false;
+			}
+
+			pos += unchanged;
+
+			for (uint32_t j = 0; j < changed; ++j) {
+				data[pos++] ^= in[in_pos++];
+			}
+		}
+
+		return true;
+	}
+
+private:
+	static constexpr int MAX_VARINT_SIZE = 3; ///< LEB128 for values up to 2^21 (data sizes are uint16)
+
+	static int write_varint(uint8_t *out, uint32_t value)
+	{
+		int len = 0;
+
+		while (value >= 0x80) {
+			out[len++] = (uint8_t)(value | 0x80);
+			value >>= 7;
+		}
+
+		out[len++] = (uint8_t)value;
+		return len;
+	}
+
+	static bool read_varint(const uint8_t *in, int in_size, int &in_pos, uint32_t &value)
+	{
+		value = 0;
+
+		for (int shift = 0; shift < 7 * MAX_VARINT_SIZE; shift += 7) {
+			if (in_pos >= in_size) {
+				return false;
+			}
+
+			const uint8_t byte = in[in_pos++];
+			value |= (uint32_t)(byte & 0x7f) << shift;
+
+			if ((byte & 0x80) == 0) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	struct Subscription {
+		uint8_t *previous{nullptr}; ///< previous sample written (nullptr if delta encoding is disabled)
+		uint16_t size{0};
+		bool valid{false};
+	};
+
+	Subscription *_subscriptions{nullptr};
+	int _num_subscriptions{0};
+
+	uint8_t *_buffer{nullptr};
+	int _buffer_size{0};
+};
+
+} //namespace logger
+} //namespace px4
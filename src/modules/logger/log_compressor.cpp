@@ -0,0 +1,112 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "log_compressor.h"
+
+#include <string.h>
+
+namespace px4
+{
+namespace logger
+{
+
+size_t LogCompressor::compress_frame(const uint8_t *data, size_t size, uint8_t *out)
+{
+	if (size > FRAME_SIZE) {
+		return 0;
+	}
+
+	heatshrink_encoder_reset(&_encoder);
+
+	size_t out_len = sizeof(ulog_compressed_frame_header_s);
+	size_t in_len = 0;
+
+	while (in_len < size) {
+		size_t sunk = 0;
+
+		if (heatshrink_encoder_sink(&_encoder, const_cast<uint8_t *>(data + in_len), size - in_len, &sunk) < 0) {
+			return 0;
+		}
+
+		in_len += sunk;
+
+		if (!poll(out, out_len)) {
+			return 0;
+		}
+	}
+
+	HSE_finish_res finish_res;
+
+	while ((finish_res = heatshrink_encoder_finish(&_encoder)) == HSER_FINISH_MORE) {
+		if (!poll(out, out_len)) {
+			return 0;
+		}
+	}
+
+	if (finish_res != HSER_FINISH_DONE) {
+		return 0;
+	}
+
+	ulog_compressed_frame_header_s header;
+	header.compressed_size = out_len - sizeof(header);
+	header.uncompressed_size = size;
+	memcpy(out, &header, sizeof(header));
+
+	return out_len;
+}
+
+bool LogCompressor::poll(uint8_t *out, size_t &out_len)
+{
+	HSE_poll_res poll_res;
+
+	do {
+		size_t polled = 0;
+		poll_res = heatshrink_encoder_poll(&_encoder, out + out_len, MAX_FRAME_OUTPUT_SIZE - out_len, &polled);
+
+		if (poll_res < 0) {
+			return false;
+		}
+
+		out_len += polled;
+
+		if (poll_res == HSER_POLL_MORE && out_len == MAX_FRAME_OUTPUT_SIZE) {
+			return false; // cannot happen, as the output size is bounded
+		}
+
+	} while (poll_res == HSER_POLL_MORE);
+
+	return true;
+}
+
+} //namespace logger
+} //namespace px4
@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "messages.h"
+
+#define HEATSHRINK_DYNAMIC_ALLOC 0
+#include <lib/heatshrink/heatshrink/heatshrink_encoder.h>
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class LogCompressor
+ * Compresses the log file data into independent heatshrink frames (@see ulog_compressed_frame_header_s).
+ * Every frame starts with a reset encoder, so a corrupted frame does not affect the following ones.
+ */
+class LogCompressor
+{
+public:
+	/** the file header and the flag bits message are written uncompressed */
+	static constexpr size_t UNCOMPRESSED_HEADER_SIZE = sizeof(ulog_file_header_s) + sizeof(ulog_message_flag_bits_s);
+
+	static constexpr size_t FRAME_SIZE = 2048; ///< maximum uncompressed size of a frame
+
+	/** worst case size of a frame: literals need 9 bits per byte */
+	static constexpr size_t MAX_FRAME_OUTPUT_SIZE = sizeof(ulog_compressed_frame_header_s) + FRAME_SIZE + FRAME_SIZE / 8 + 1;
+
+	static constexpr size_t OUTPUT_BUFFER_SIZE = 2 * MAX_FRAME_OUTPUT_SIZE;
+
+	LogCompressor() = default;
+	~LogCompressor() = default;
+
+	LogCompressor(const LogCompressor &) = delete;
+	LogCompressor &operator=(const LogCompressor &) = delete;
+
+	/**
+	 * Compress a frame into out
+	 * @param data uncompressed data
+	 * @param size uncompressed size (at most FRAME_SIZE)
+	 * @param out output, at least MAX_FRAME_OUTPUT_SIZE bytes
+	 * @return number of bytes written to out (including the frame header), or 0 on error
+	 */
+	size_t compress_frame(const uint8_t *data, size_t size, uint8_t *out);
+
+	uint8_t *output_buffer() { return _output_buffer; }
+
+private:
+	bool poll(uint8_t *out, size_t &out_len);
+
+	heatshrink_encoder _encoder;
+	uint8_t _output_buffer[OUTPUT_BUFFER_SIZE];
+};
+
+} //namespace logger
+} //namespace px4
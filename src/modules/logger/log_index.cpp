@@ -0,0 +1,99 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "log_index.h"
+
+#include <string.h>
+
+namespace px4
+{
+namespace logger
+{
+
+bool LogIndex::start(int num_msg_ids)
+{
+	reset();
+
+	if (num_msg_ids <= 0) {
+		return false;
+	}
+
+	_msg_ids = new MsgIdOffsets[num_msg_ids];
+
+	if (!_msg_ids) {
+		return false;
+	}
+
+	memset(_msg_ids, 0, num_msg_ids * sizeof(MsgIdOffsets));
+	_num_msg_ids = num_msg_ids;
+	return true;
+}
+
+void LogIndex::reset()
+{
+	delete[] _msg_ids;
+	_msg_ids = nullptr;
+	_num_msg_ids = 0;
+	_num_sync_points = 0;
+	_sync_interval = INITIAL_SYNC_INTERVAL;
+}
+
+void LogIndex::sync_written(uint64_t timestamp, uint64_t offset)
+{
+	if (!enabled()) {
+		return;
+	}
+
+	if (_num_sync_points > 0 && offset - _sync_points[_num_sync_points - 1].offset < _sync_interval) {
+		return;
+	}
+
+	if (_num_sync_points == MAX_SYNC_POINTS) {
+		// thin out: keep every other sync point and double the interval
+		for (int i = 1; i < MAX_SYNC_POINTS / 2; ++i) {
+			_sync_points[i] = _sync_points[2 * i];
+		}
+
+		_num_sync_points = MAX_SYNC_POINTS / 2;
+		_sync_interval *= 2;
+
+		if (offset - _sync_points[_num_sync_points - 1].offset < _sync_interval) {
+			return;
+		}
+	}
+
+	_sync_points[_num_sync_points++] = {timestamp, offset};
+}
+
+} //namespace logger
+} //namespace px4
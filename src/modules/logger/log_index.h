@@ -0,0 +1,139 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace px4
+{
+namespace logger
+{
+
+/**
+ * @class LogIndex
+ * Seek index of a (full) log file, collected while writing and appended to the log when it is closed:
+ * - sync points: file offset of a SYNC message with its timestamp, about every sync_interval bytes.
+ *   When the table is full, every other entry is dropped and the interval doubled, so the size is bounded
+ *   independently of the log length.
+ * - per msg_id: file offsets of the ADD_LOGGED_MSG message and of the first and last data message.
+ *
+ * The index is written as INFO_MULTIPLE messages 'uint64_t[2*n] index_sync' ([timestamp, offset] pairs) and
+ * 'uint64_t[4*n] index_msg_id' ([msg_id, add_logged_msg, first_data, last_data] tuples), followed by a fixed
+ * size INFO message 'uint64_t index_offset' at the very end of the file, pointing to the first index message.
+ * A reader can thus find the index by reading the last INDEX_TRAILER_SIZE bytes.
+ * Offsets are 0 if not available.
+ */
+class LogIndex
+{
+public:
+	static constexpr int MAX_SYNC_POINTS = 128;
+	static constexpr uint64_t INITIAL_SYNC_INTERVAL = 1024 * 1024; ///< [bytes]
+	static constexpr size_t INDEX_TRAILER_SIZE = 33; ///< size of the 'uint64_t index_offset' INFO message
+
+	struct SyncPoint {
+		uint64_t timestamp;
+		uint64_t offset;
+	};
+
+	struct MsgIdOffsets {
+		uint64_t add_logged_msg;
+		uint64_t first_data;
+		uint64_t last_data;
+	};
+
+	LogIndex() = default;
+	~LogIndex() { reset(); }
+
+	LogIndex(const LogIndex &) = delete;
+	LogIndex &operator=(const LogIndex &) = delete;
+
+	/**
+	 * Start collecting the index of a new log file.
+	 * @param num_msg_ids upper bound of the msg_id's used in the log
+	 * @return false if the memory could not be allocated (the index is disabled then)
+	 */
+	bool start(int num_msg_ids);
+
+	/**
+	 * Stop collecting and free the memory
+	 */
+	void reset();
+
+	bool enabled() const { return _msg_ids != nullptr; }
+
+	void add_logged_msg_written(uint16_t msg_id, uint64_t offset)
+	{
+		if (msg_id < _num_msg_ids && _msg_ids[msg_id].add_logged_msg == 0) {
+			_msg_ids[msg_id].add_logged_msg = offset;
+		}
+	}
+
+	void data_written(uint16_t msg_id, uint64_t offset)
+	{
+		if (msg_id < _num_msg_ids) {
+			MsgIdOffsets &msg = _msg_ids[msg_id];
+
+			if (msg.first_data == 0) {
+				msg.first_data = offset;
+			}
+
+			msg.last_data = offset;
+		}
+	}
+
+	/**
+	 * Called for every SYNC message written
+	 * @param timestamp time of the SYNC message
+	 * @param offset file offset of the SYNC message
+	 */
+	void sync_written(uint64_t timestamp, uint64_t offset);
+
+	int num_sync_points() const { return _num_sync_points; }
+	const SyncPoint &sync_point(int i) const { return _sync_points[i]; }
+
+	int num_msg_ids() const { return _num_msg_ids; }
+	const MsgIdOffsets &msg_id_offsets(int i) const { return _msg_ids[i]; }
+
+private:
+	SyncPoint _sync_points[MAX_SYNC_POINTS];
+	int _num_sync_points{0};
+	uint64_t _sync_interval{INITIAL_SYNC_INTERVAL};
+
+	MsgIdOffsets *_msg_ids{nullptr};
+	int _num_msg_ids{0};
+};
+
+} //namespace logger
+} //namespace px4
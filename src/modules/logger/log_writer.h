@@ -126,6 +126,13 @@ public:
 		return 0;
 	}
 
+	size_t get_write_offset_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_write_offset(type); }
+
+		return 0;
+	}
+
 	size_t get_buffer_size_file(LogType type) const
 	{
 		if (_log_writer_file) { return _log_writer_file->get_buffer_size(type); }
@@ -140,6 +147,46 @@ public:
 		return 0;
 	}
 
+	uint32_t get_write_latency_max_file(LogType type)
+	{
+		if (_log_writer_file) { return _log_writer_file->get_write_latency_max(type); }
+
+		return 0;
+	}
+
+	unsigned get_writes_in_flight_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_writes_in_flight(type); }
+
+		return 0;
+	}
+
+	size_t get_file_size_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->get_file_size(type); }
+
+		return 0;
+	}
+
+	bool is_compressed_file(LogType type) const
+	{
+		if (_log_writer_file) { return _log_writer_file->is_compressed(type); }
+
+		return false;
+	}
+
+	uint32_t get_compression_time_file(LogType type)
+	{
+		if (_log_writer_file) { return _log_writer_file->get_compression_time(type); }
+
+		return 0;
+	}
+
+	void set_compression_file(bool compress)
+	{
+		if (_log_writer_file) { _log_writer_file->set_compression(compress); }
+	}
+
 	pthread_t thread_id_file() const
 	{
 		if (_log_writer_file) { return _log_writer_file->thread_id(); }
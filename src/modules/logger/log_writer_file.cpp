@@ -35,8 +35,10 @@
 #include "messages.h"
 
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <unistd.h>
 
 #include <mathlib/mathlib.h>
 #include <px4_platform_common/posix.h>
@@ -60,7 +62,12 @@ LogWriterFile::LogWriterFile(size_t buffer_size)
 	//We always write larger chunks (orb messages) to the buffer, so the buffer
 	//needs to be larger than the minimum write chunk (300 is somewhat arbitrary)
 	{
+#if defined(LOG_WRITER_FILE_ASYNC)
+		// whole pages, so that the buffer can be written with direct I/O
+		(math::max(buffer_size, _min_write_chunk + 300) + _min_write_chunk - 1) / _min_write_chunk * _min_write_chunk,
+#else
 		math::max(buffer_size, _min_write_chunk + 300),
+#endif
 		perf_alloc(PC_ELAPSED, "logger_sd_write"), perf_alloc(PC_ELAPSED, "logger_sd_fsync")},
 
 	{
@@ -248,7 +255,33 @@ bool LogWriterFile::start_log(LogType type, const char *filename)
 
 #endif
 
-	if (_buffers[(int)type].start_log(filename)) {
+	bool async = false;
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+	// the mission log is small and written as soon as there is data
+	async = _async_writes && (type == LogType::Full);
+
+#if defined(PX4_CRYPTO)
+	// the encrypted data is written with blocking writes
+	async = async && (_algorithm == CRYPTO_NONE);
+#endif
+#endif
+
+	bool compress = false;
+
+#if defined(LOG_WRITER_FILE_COMPRESSION)
+	compress = _compression && (type == LogType::Full);
+
+#if defined(PX4_CRYPTO)
+	// encrypted data cannot be compressed
+	compress = compress && (_algorithm == CRYPTO_NONE);
+#endif
+
+	// the compressed frames are not page aligned
+	async = async && !compress;
+#endif
+
+	if (_buffers[(int)type].start_log(filename, async, compress)) {
 		PX4_INFO("Opened %s log file: %s", log_type_str(type), filename);
 		notify();
 		return true;
@@ -392,6 +425,21 @@ void LogWriterFile::run()
 				void *read_ptr;
 				bool is_part;
 				LogFileBuffer &buffer = _buffers[i];
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+
+				if (buffer.async()) {
+					run_async(buffer, call_fsync);
+
+					// once stopped, the remaining data is written below
+					if (buffer.async() || buffer.fd() < 0) {
+						--i;
+						continue;
+					}
+				}
+
+#endif
+
 				size_t available = buffer.get_read_ptr(&read_ptr, &is_part);
 
 #if defined(PX4_CRYPTO)
@@ -403,39 +451,51 @@ void LogWriterFile::run()
 				if (available >= min_available[i] || is_part || (!buffer._should_run && available > 0)) {
 					pthread_mutex_unlock(&_mtx);
 
+					int written;
+
+#if defined(LOG_WRITER_FILE_COMPRESSION)
+
+					if (buffer.compressed()) {
+						// no retry: a partially written frame cannot be completed
+						written = buffer.write_compressed(read_ptr, available, call_fsync);
+
+					} else
+#endif
+					{
 #if defined(PX4_CRYPTO)
-					/* This makes the following assumptions:
-					 * - the chipher size is always the
-					     same as the input size
-					 * - the encryption can be done in
-					     place. This is always taken care
-					     by the px4 crypto interfaces
-					 */
-
-					size_t out = available;
-
-					if (_algorithm != CRYPTO_NONE) {
-						_crypto.encrypt_data(
-							_key_idx,
-							(uint8_t *)read_ptr,
-							available,
-							(uint8_t *)read_ptr,
-							&out);
-
-						if (out != available) {
-							PX4_ERR("Encryption output size mismatch, logfile corrupted");
+						/* This makes the following assumptions:
+						 * - the chipher size is always the
+						     same as the input size
+						 * - the encryption can be done in
+						     place. This is always taken care
+						     by the px4 crypto interfaces
+						 */
+
+						size_t out = available;
+
+						if (_algorithm != CRYPTO_NONE) {
+							_crypto.encrypt_data(
+								_key_idx,
+								(uint8_t *)read_ptr,
+								available,
+								(uint8_t *)read_ptr,
+								&out);
+
+							if (out != available) {
+								PX4_ERR("Encryption output size mismatch, logfile corrupted");
+							}
 						}
-					}
 
 #endif
 
-					int written = buffer.write_to_file(read_ptr, available, call_fsync);
-
-					if (written < 0) {
-						// retry once
-						PX4_ERR("write failed errno:%i (%s), retrying", errno, strerror(errno));
-						px4_usleep(10000); // 10 milliseconds
 						written = buffer.write_to_file(read_ptr, available, call_fsync);
+
+						if (written < 0) {
+							// retry once
+							PX4_ERR("write failed errno:%i (%s), retrying", errno, strerror(errno));
+							px4_usleep(10000); // 10 milliseconds
+							written = buffer.write_to_file(read_ptr, available, call_fsync);
+						}
 					}
 
 					/* buffer.mark_read() requires _mtx to be locked */
@@ -454,13 +514,7 @@ void LogWriterFile::run()
 						}
 
 					} else {
-						PX4_ERR("write failed (%i)", errno);
-						buffer._had_write_error.store(true);
-						buffer._should_run = false;
-						pthread_mutex_unlock(&_mtx);
-						buffer.close_file();
-						pthread_mutex_lock(&_mtx);
-						buffer.reset();
+						write_failed(buffer);
 					}
 
 				} else if (call_fsync && buffer._should_run) {
@@ -500,7 +554,27 @@ void LogWriterFile::run()
 			 * If the logger was switched off in the meantime, do not wait for data, instead run this loop
 			 * once more to write remaining data and close the file. */
 			if (_buffers[0]._should_run || _buffers[1]._should_run) {
-				pthread_cond_wait(&_cv, &_mtx);
+#if defined(LOG_WRITER_FILE_ASYNC)
+
+				if (_buffers[0].writes_in_flight() > 0 || _buffers[1].writes_in_flight() > 0) {
+					// release the buffer space of completed writes without waiting for the next notify(),
+					// in real time as the writes complete independently of lockstep
+					timespec ts{};
+					clock_gettime(CLOCK_REALTIME, &ts);
+					ts.tv_nsec += ASYNC_REAP_INTERVAL_US * 1000;
+
+					if (ts.tv_nsec >= 1000000000) {
+						ts.tv_sec++;
+						ts.tv_nsec -= 1000000000;
+					}
+
+					pthread_cond_timedwait(&_cv, &_mtx, &ts);
+
+				} else
+#endif
+				{
+					pthread_cond_wait(&_cv, &_mtx);
+				}
 			}
 		}
 
@@ -509,6 +583,84 @@ void LogWriterFile::run()
 	}
 }
 
+void LogWriterFile::write_failed(LogFileBuffer &buffer)
+{
+	PX4_ERR("write failed (%i)", errno);
+	buffer._had_write_error.store(true);
+	buffer._should_run = false;
+	pthread_mutex_unlock(&_mtx);
+	buffer.close_file();
+	pthread_mutex_lock(&_mtx);
+	buffer.reset();
+}
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+void LogWriterFile::run_async(LogFileBuffer &buffer, bool call_fsync)
+{
+	// release the buffer space of completed writes
+	ssize_t completed = buffer.reap_writes(false);
+
+	if (completed < 0) {
+		write_failed(buffer);
+		return;
+	}
+
+	buffer.mark_completed(completed);
+
+	if (!buffer._should_run) {
+		// stopping: wait for the writes in flight, the remaining (unaligned) data is then written synchronously
+		pthread_mutex_unlock(&_mtx);
+		completed = buffer.finish_async();
+		pthread_mutex_lock(&_mtx);
+
+		if (completed < 0) {
+			write_failed(buffer);
+			return;
+		}
+
+		buffer.mark_completed(completed);
+		return;
+	}
+
+	// submit whole pages only, both parts if the data wraps around the end of the buffer
+	while (buffer.can_submit()) {
+		void *read_ptr;
+		bool is_part;
+		size_t available = buffer.get_read_ptr(&read_ptr, &is_part);
+		available -= available % _min_write_chunk;
+
+		if (available == 0) {
+			break;
+		}
+
+		// the data is not modified by the logger until mark_completed()
+		if (buffer.submit_write(read_ptr, available) != 0) {
+			write_failed(buffer);
+			return;
+		}
+	}
+
+	if (call_fsync) {
+		// fsync() does not cover writes in flight: wait for them first
+		pthread_mutex_unlock(&_mtx);
+		completed = buffer.reap_writes(true);
+
+		if (completed >= 0) {
+			buffer.fsync();
+		}
+
+		pthread_mutex_lock(&_mtx);
+
+		if (completed < 0) {
+			write_failed(buffer);
+			return;
+		}
+
+		buffer.mark_completed(completed);
+	}
+}
+#endif // LOG_WRITER_FILE_ASYNC
+
 int LogWriterFile::write_message(LogType type, void *ptr, size_t size, uint64_t dropout_start)
 {
 	if (_need_reliable_transfer) {
@@ -604,6 +756,10 @@ LogWriterFile::LogFileBuffer::~LogFileBuffer()
 
 	free(_buffer);
 
+#if defined(LOG_WRITER_FILE_COMPRESSION)
+	delete _compressor;
+#endif
+
 	perf_free(_perf_write);
 	perf_free(_perf_fsync);
 }
@@ -633,8 +789,13 @@ void LogWriterFile::LogFileBuffer::write_no_check(void *ptr, size_t size)
 
 size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 {
-	// bytes available to read
-	int read_ptr = _head - _count;
+	// bytes available to read (excluding the ones submitted for writing already)
+#if defined(LOG_WRITER_FILE_ASYNC)
+	const size_t count = _count - _submitted;
+#else
+	const size_t count = _count;
+#endif
+	int read_ptr = _head - count;
 
 	if (read_ptr < 0) {
 		read_ptr += _buffer_size;
@@ -645,13 +806,46 @@ size_t LogWriterFile::LogFileBuffer::get_read_ptr(void **ptr, bool *is_part)
 	} else {
 		*ptr = &_buffer[read_ptr];
 		*is_part = false;
-		return _count;
+		return count;
 	}
 }
 
-bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
+bool LogWriterFile::LogFileBuffer::start_log(const char *filename, bool async, bool compress)
 {
-	_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+#if defined(LOG_WRITER_FILE_COMPRESSION)
+
+	if (compress && _compressor == nullptr) {
+		_compressor = new LogCompressor();
+
+		if (_compressor == nullptr) {
+			PX4_ERR("Can't allocate log compressor, writing uncompressed");
+		}
+	}
+
+	_compressed = compress && _compressor != nullptr;
+#else
+	_compressed = false;
+#endif
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+	_async = async;
+	_submitted = 0;
+	_file_offset = 0;
+
+	if (_async) {
+		_fd = ::open(filename, O_CREAT | O_WRONLY | O_DIRECT, PX4_O_MODE_666);
+
+		if (_fd < 0 && errno == EINVAL) {
+			// file system without direct I/O support (e.g. tmpfs), still write asynchronously
+			_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+		}
+
+	} else
+#endif
+	{
+		_fd = ::open(filename, O_CREAT | O_WRONLY, PX4_O_MODE_666);
+	}
+
 	_had_write_error.store(false);
 
 	if (_fd < 0) {
@@ -660,7 +854,16 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 	}
 
 	if (_buffer == nullptr) {
+#if defined(LOG_WRITER_FILE_ASYNC)
+
+		// direct I/O requires page aligned memory
+		if (posix_memalign((void **)&_buffer, _min_write_chunk, _buffer_size) != 0) {
+			_buffer = nullptr;
+		}
+
+#else
 		_buffer = (uint8_t *) px4_cache_aligned_alloc(_buffer_size);
+#endif
 
 		if (_buffer == nullptr) {
 			PX4_ERR("Can't create log buffer");
@@ -674,6 +877,8 @@ bool LogWriterFile::LogFileBuffer::start_log(const char *filename)
 	_head = 0;
 	_count = 0;
 	_total_written = 0;
+	_file_size.store(0);
+	_compression_time.store(0);
 
 	_should_run = true;
 
@@ -687,10 +892,134 @@ void LogWriterFile::LogFileBuffer::fsync() const
 	perf_end(_perf_fsync);
 }
 
-ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync) const
+void LogWriterFile::LogFileBuffer::update_write_latency(hrt_abstime start)
+{
+	// only the writer thread raises the maximum, write_latency_max() resets it
+	const uint32_t latency = hrt_elapsed_time(&start);
+	uint32_t latency_max = _write_latency_max.load();
+
+	while (latency > latency_max && !_write_latency_max.compare_exchange(&latency_max, latency)) {}
+}
+
+uint32_t LogWriterFile::LogFileBuffer::write_latency_max()
+{
+	uint32_t latency_max = _write_latency_max.load();
+
+	while (!_write_latency_max.compare_exchange(&latency_max, 0)) {}
+
+	return latency_max;
+}
+
+uint32_t LogWriterFile::LogFileBuffer::compression_time()
+{
+	uint32_t compression_time = _compression_time.load();
+
+	while (!_compression_time.compare_exchange(&compression_time, 0)) {}
+
+	return compression_time;
+}
+
+unsigned LogWriterFile::LogFileBuffer::writes_in_flight() const
+{
+#if defined(LOG_WRITER_FILE_ASYNC)
+	return _aio_count.load();
+#else
+	return 0;
+#endif
+}
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+int LogWriterFile::LogFileBuffer::submit_write(const void *ptr, size_t size)
+{
+	const int slot = (_aio_first + _aio_count.load()) % MAX_WRITES_IN_FLIGHT;
+	struct aiocb &aio = _aio[slot];
+
+	memset(&aio, 0, sizeof(aio));
+	aio.aio_fildes = _fd;
+	aio.aio_buf = const_cast<void *>(ptr);
+	aio.aio_nbytes = size;
+	aio.aio_offset = _file_offset;
+	aio.aio_sigevent.sigev_notify = SIGEV_NONE;
+
+	_aio_start[slot] = hrt_absolute_time();
+
+	if (aio_write(&aio) != 0) {
+		return -1;
+	}
+
+	_file_offset += size;
+	_submitted += size;
+	_aio_count.fetch_add(1);
+
+	return 0;
+}
+
+ssize_t LogWriterFile::LogFileBuffer::reap_writes(bool wait)
+{
+	ssize_t completed = 0;
+
+	while (_aio_count.load() > 0) {
+		struct aiocb &aio = _aio[_aio_first];
+		int error = aio_error(&aio);
+
+		if (error == EINPROGRESS) {
+			if (!wait) {
+				break;
+			}
+
+			const struct aiocb *list[1] = {&aio};
+			aio_suspend(list, 1, nullptr);
+			continue;
+		}
+
+		const ssize_t written = aio_return(&aio);
+		update_write_latency(_aio_start[_aio_first]);
+
+		_aio_first = (_aio_first + 1) % MAX_WRITES_IN_FLIGHT;
+		_aio_count.fetch_sub(1);
+
+		if (error != 0 || written != (ssize_t)aio.aio_nbytes) {
+			// short writes only happen if the disk is full
+			errno = (error != 0) ? error : ENOSPC;
+
+			// the remaining writes cannot be used anymore either
+			reap_writes(true);
+			return -1;
+		}
+
+		completed += written;
+	}
+
+	return completed;
+}
+
+ssize_t LogWriterFile::LogFileBuffer::finish_async()
+{
+	ssize_t completed = reap_writes(true);
+
+	// the tail is not page aligned: continue with blocking writes, after the asynchronously written data
+	_async = false;
+
+	const int flags = fcntl(_fd, F_GETFL);
+
+	if (flags != -1) {
+		fcntl(_fd, F_SETFL, flags & ~O_DIRECT);
+	}
+
+	if (lseek(_fd, _file_offset, SEEK_SET) < 0) {
+		return -1;
+	}
+
+	return completed;
+}
+#endif // LOG_WRITER_FILE_ASYNC
+
+ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t size, bool call_fsync)
 {
 	perf_begin(_perf_write);
+	const hrt_abstime start = hrt_absolute_time();
 	ssize_t ret = ::write(_fd, buffer, size);
+	update_write_latency(start);
 	perf_end(_perf_write);
 
 	if (call_fsync) {
@@ -700,14 +1029,91 @@ ssize_t LogWriterFile::LogFileBuffer::write_to_file(const void *buffer, size_t s
 	return ret;
 }
 
+#if defined(LOG_WRITER_FILE_COMPRESSION)
+ssize_t LogWriterFile::LogFileBuffer::write_compressed(const void *buffer, size_t size, bool call_fsync)
+{
+	const uint8_t *data = static_cast<const uint8_t *>(buffer);
+	size_t consumed = 0;
+
+	// the file header and the flag bits are not compressed, so that readers can detect the compression
+	if (_total_written < LogCompressor::UNCOMPRESSED_HEADER_SIZE) {
+		consumed = math::min(size, LogCompressor::UNCOMPRESSED_HEADER_SIZE - _total_written);
+		const ssize_t ret = write_to_file(data, consumed, false);
+
+		if (ret != (ssize_t)consumed) {
+			if (ret >= 0) {
+				errno = ENOSPC;
+			}
+
+			return -1;
+		}
+
+		_file_size.fetch_add(consumed);
+	}
+
+	uint8_t *output = _compressor->output_buffer();
+
+	while (consumed < size) {
+		const hrt_abstime start = hrt_absolute_time();
+		size_t output_size = 0;
+
+		// fill the output buffer with as many frames as fit
+		while (consumed < size && output_size + LogCompressor::MAX_FRAME_OUTPUT_SIZE <= LogCompressor::OUTPUT_BUFFER_SIZE) {
+			const size_t frame_size = math::min(size - consumed, LogCompressor::FRAME_SIZE);
+			const size_t frame_output_size = _compressor->compress_frame(data + consumed, frame_size, output + output_size);
+
+			if (frame_output_size == 0) {
+				errno = EINVAL;
+				return -1;
+			}
+
+			output_size += frame_output_size;
+			consumed += frame_size;
+		}
+
+		_compression_time.fetch_add(hrt_elapsed_time(&start));
+
+		const ssize_t ret = write_to_file(output, output_size, false);
+
+		if (ret != (ssize_t)output_size) {
+			if (ret >= 0) {
+				errno = ENOSPC; // short writes only happen if the disk is full
+			}
+
+			return -1;
+		}
+
+		_file_size.fetch_add(output_size);
+	}
+
+	if (call_fsync) {
+		fsync();
+	}
+
+	return consumed;
+}
+#endif // LOG_WRITER_FILE_COMPRESSION
+
 void LogWriterFile::LogFileBuffer::close_file()
 {
 	if (_fd >= 0) {
+#if defined(LOG_WRITER_FILE_ASYNC)
+
+		// e.g. after a failed submit: the kernel must not access the file (and the buffer) anymore
+		if (_aio_count.load() > 0) {
+			reap_writes(true);
+		}
+
+#endif
+
 		int res = close(_fd);
 
 		if (res) {
 			PX4_WARN("closing log file failed (%i)", errno);
 
+		} else if (_compressed) {
+			PX4_INFO("closed logfile, bytes written: %zu (compressed: %zu)", _total_written, _file_size.load());
+
 		} else {
 			PX4_INFO("closed logfile, bytes written: %zu", _total_written);
 		}
@@ -719,6 +1125,10 @@ void LogWriterFile::LogFileBuffer::reset()
 	_head = 0;
 	_count = 0;
 	_fd = -1;
+#if defined(LOG_WRITER_FILE_ASYNC)
+	_async = false;
+	_submitted = 0;
+#endif
 }
 
 }
@@ -41,6 +41,16 @@
 #include <perf/perf_counter.h>
 #include <px4_platform_common/crypto.h>
 
+#if defined(CONFIG_LOGGER_ASYNC_DIRECT_IO) && defined(__PX4_LINUX)
+#define LOG_WRITER_FILE_ASYNC
+#include <aio.h>
+#endif
+
+#if defined(CONFIG_LOGGER_COMPRESSION)
+#define LOG_WRITER_FILE_COMPRESSION
+#include "log_compressor.h"
+#endif
+
 namespace px4
 {
 namespace logger
@@ -59,6 +69,13 @@ enum class LogType {
 
 const char *log_type_str(LogType type);
 
+#if defined(CONFIG_LOGGER_BENCH)
+/**
+ * Benchmark the file writer backends with synthetic ULog data at 1 - 20 MB/s (logger bench).
+ */
+int log_writer_file_bench(int argc, char *argv[]);
+#endif // CONFIG_LOGGER_BENCH
+
 /**
  * @class LogWriterFile
  * Writes logging data to a file
@@ -108,6 +125,14 @@ public:
 		return _buffers[(int)type].total_written();
 	}
 
+	/**
+	 * File offset at which the next message will be written (call with the lock held).
+	 */
+	size_t get_write_offset(LogType type) const
+	{
+		return _buffers[(int)type].total_written() + _buffers[(int)type].count();
+	}
+
 	size_t get_buffer_size(LogType type) const
 	{
 		return _buffers[(int)type].buffer_size();
@@ -118,6 +143,49 @@ public:
 		return _buffers[(int)type].count();
 	}
 
+	/**
+	 * Longest file write (from submission to completion) since the last call.
+	 */
+	uint32_t get_write_latency_max(LogType type)
+	{
+		return _buffers[(int)type].write_latency_max();
+	}
+
+	unsigned get_writes_in_flight(LogType type) const
+	{
+		return _buffers[(int)type].writes_in_flight();
+	}
+
+	/**
+	 * Number of bytes written to the file. This is less than get_total_written() if the file is compressed.
+	 */
+	size_t get_file_size(LogType type) const
+	{
+		return _buffers[(int)type].file_size();
+	}
+
+	bool is_compressed(LogType type) const { return _buffers[(int)type].compressed(); }
+
+	/**
+	 * Time spent compressing since the last call [us].
+	 */
+	uint32_t get_compression_time(LogType type)
+	{
+		return _buffers[(int)type].compression_time();
+	}
+
+	/**
+	 * Use asynchronous direct I/O for the full log (if available).
+	 * Takes effect with the next start_log().
+	 */
+	void set_async_writes(bool async) { _async_writes = async; }
+
+	/**
+	 * Compress the full log (if available, and not encrypted). This disables asynchronous writes.
+	 * Takes effect with the next start_log().
+	 */
+	void set_compression(bool compress) { _compression = compress; }
+
 	void set_need_reliable_transfer(bool need_reliable)
 	{
 		if (!need_reliable && _need_reliable_transfer) {
@@ -163,6 +231,23 @@ private:
 	 */
 	int write(LogType type, void *ptr, size_t size, uint64_t dropout_start);
 
+	class LogFileBuffer;
+
+	/**
+	 * Stop logging to the buffer after a failed write. Requires _mtx to be locked.
+	 */
+	void write_failed(LogFileBuffer &buffer);
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+	/**
+	 * Reap completed and submit new asynchronous writes. Requires _mtx to be locked.
+	 */
+	void run_async(LogFileBuffer &buffer, bool call_fsync);
+
+	/* maximum time between reaping completed writes while writes are in flight */
+	static constexpr unsigned ASYNC_REAP_INTERVAL_US = 2000;
+#endif
+
 	/* 512 didn't seem to work properly, 4096 should match the FAT cluster size */
 	static constexpr size_t	_min_write_chunk = 4096;
 
@@ -173,7 +258,11 @@ private:
 
 		~LogFileBuffer();
 
-		bool start_log(const char *filename);
+		/**
+		 * @param async use asynchronous direct I/O writes (LOG_WRITER_FILE_ASYNC), otherwise blocking writes
+		 * @param compress write compressed frames (LOG_WRITER_FILE_COMPRESSION)
+		 */
+		bool start_log(const char *filename, bool async = false, bool compress = false);
 
 		void close_file();
 
@@ -190,16 +279,60 @@ private:
 
 		int fd() const { return _fd; }
 
-		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync) const;
+		inline ssize_t write_to_file(const void *buffer, size_t size, bool call_fsync);
 
 		inline void fsync() const;
 
+#if defined(LOG_WRITER_FILE_COMPRESSION)
+		/**
+		 * Compress and write data to the file (the file header and flag bits are written uncompressed).
+		 * @return number of (uncompressed) bytes written, or -1 on error (errno is set)
+		 */
+		ssize_t write_compressed(const void *buffer, size_t size, bool call_fsync);
+#endif
+
+		bool compressed() const { return _compressed; }
+		size_t file_size() const { return _compressed ? _file_size.load() : _total_written; }
+		uint32_t compression_time();
+
 		void mark_read(size_t n) { _count -= n; _total_written += n; }
 
 		size_t total_written() const { return _total_written; }
 		size_t buffer_size() const { return _buffer_size; }
 		size_t count() const { return _count; }
 
+		uint32_t write_latency_max();
+		unsigned writes_in_flight() const;
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+		static constexpr int MAX_WRITES_IN_FLIGHT = 4;
+
+		bool async() const { return _async; }
+		bool can_submit() const { return _aio_count.load() < MAX_WRITES_IN_FLIGHT; }
+
+		/**
+		 * Submit an asynchronous write of the buffer data at ptr (page aligned, whole pages).
+		 * The data stays in the buffer until the write completes.
+		 * @return 0 on success, -1 otherwise (errno is set)
+		 */
+		int submit_write(const void *ptr, size_t size);
+
+		/**
+		 * Collect completed writes in submission order.
+		 * @param wait block until all writes in flight completed
+		 * @return number of bytes written, to be passed to mark_completed(), or -1 on error (errno is set)
+		 */
+		ssize_t reap_writes(bool wait);
+
+		void mark_completed(size_t n) { _submitted -= n; mark_read(n); }
+
+		/**
+		 * Wait for all writes in flight and switch to blocking writes (to write the unaligned tail).
+		 * @return @see reap_writes()
+		 */
+		ssize_t finish_async();
+#endif
+
 		bool _should_run = false;
 		px4::atomic_bool _had_write_error{false};
 	private:
@@ -211,6 +344,29 @@ private:
 		size_t _total_written = 0;
 		perf_counter_t _perf_write;
 		perf_counter_t _perf_fsync;
+
+		px4::atomic<uint32_t> _write_latency_max{0};
+
+		bool _compressed = false;
+		px4::atomic<size_t> _file_size{0};
+		px4::atomic<uint32_t> _compression_time{0};
+#if defined(LOG_WRITER_FILE_COMPRESSION)
+		LogCompressor *_compressor = nullptr;
+#endif
+
+		inline void update_write_latency(hrt_abstime start);
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+		bool _async = false;
+		size_t _submitted = 0; ///< number of bytes in _buffer submitted, but not yet written
+		off_t _file_offset = 0; ///< file offset of the next submitted write
+
+		// ring of writes in flight, in submission order
+		struct aiocb _aio[MAX_WRITES_IN_FLIGHT] {};
+		hrt_abstime _aio_start[MAX_WRITES_IN_FLIGHT] {};
+		int _aio_first = 0;
+		px4::atomic_int _aio_count{0};
+#endif
 	};
 
 	LogFileBuffer _buffers[(int)LogType::Count];
@@ -218,6 +374,8 @@ private:
 	px4::atomic_bool	_exit_thread{false};
 	bool			_need_reliable_transfer{false};
 	px4::atomic_bool	_want_fsync{false};
+	bool			_async_writes{true};
+	bool			_compression{false};
 	pthread_mutex_t		_mtx;
 	pthread_cond_t		_cv;
 	pthread_t _thread = 0;
@@ -0,0 +1,197 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file log_writer_file_bench.cpp
+ * Writes synthetic ULog data at fixed rates through LogWriterFile, to compare the blocking and the
+ * asynchronous direct I/O writer.
+ */
+
+#include "log_writer_file.h"
+#include "messages.h"
+
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <mathlib/mathlib.h>
+#include <px4_platform_common/getopt.h>
+#include <px4_platform_common/log.h>
+#include <px4_platform_common/posix.h>
+
+using namespace time_literals;
+
+namespace px4
+{
+namespace logger
+{
+
+static hrt_abstime real_time_us()
+{
+	timespec ts{};
+	system_clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1_s + ts.tv_nsec / 1000;
+}
+
+static void bench_run(const char *filename, size_t buffer_size, bool async, uint32_t rate_kb_s, uint32_t duration_s)
+{
+	LogWriterFile *writer = new LogWriterFile(buffer_size);
+
+	if (writer == nullptr) {
+		PX4_ERR("alloc failed");
+		return;
+	}
+
+	writer->set_async_writes(async);
+
+	if (writer->thread_start() != 0) {
+		PX4_ERR("thread start failed");
+		delete writer;
+		return;
+	}
+
+	unlink(filename);
+
+	if (!writer->start_log(LogType::Full, filename)) {
+		writer->thread_stop();
+		delete writer;
+		return;
+	}
+
+	// data messages of a typical topic size
+	uint8_t msg[200];
+	ulog_message_data_s header{};
+	header.msg_size = sizeof(msg) - ULOG_MSG_HEADER_LEN;
+
+	for (size_t i = 0; i < sizeof(msg); i++) {
+		msg[i] = i;
+	}
+
+	memcpy(msg, &header, sizeof(header));
+
+	// real time (instead of px4_usleep()/hrt, which stand still under lockstep while the simulator is not running),
+	// and at most one iteration per ms as an upper bound
+	const hrt_abstime start = real_time_us();
+	const uint32_t max_iterations = duration_s * 1000;
+	uint64_t generated = 0;
+	uint64_t dropped = 0;
+	uint32_t latency_max = 0;
+	hrt_abstime elapsed;
+
+	for (uint32_t iteration = 0; iteration < max_iterations && (elapsed = real_time_us() - start) < duration_s * 1_s;
+	     iteration++) {
+		// 1 kB/s = 1e-3 B/us
+		const uint64_t due = elapsed * rate_kb_s / 1000;
+
+		writer->lock();
+
+		while (generated + sizeof(msg) <= due) {
+			if (writer->write_message(LogType::Full, msg, sizeof(msg)) == -1) {
+				dropped += sizeof(msg);
+			}
+
+			generated += sizeof(msg);
+		}
+
+		writer->unlock();
+		writer->notify();
+
+		latency_max = math::max(latency_max, writer->get_write_latency_max(LogType::Full));
+
+		system_usleep(1000);
+	}
+
+	writer->stop_log(LogType::Full);
+	writer->thread_stop();
+
+	latency_max = math::max(latency_max, writer->get_write_latency_max(LogType::Full));
+
+	PX4_INFO_RAW("%-8s %8.1f %10.1f %9.2f %% %12" PRIu32 "\n", async ? "async" : "blocking", (double)(rate_kb_s / 1000.f),
+		     (double)(writer->get_total_written(LogType::Full) / 1e6f),
+		     (double)(generated > 0 ? 100.f * dropped / generated : 0.f), latency_max);
+
+	delete writer;
+	unlink(filename);
+}
+
+int log_writer_file_bench(int argc, char *argv[])
+{
+	const char *filename = PX4_STORAGEDIR "/logger_bench.ulg";
+	uint32_t duration_s = 5;
+	size_t buffer_size = 64 * 1024;
+
+	int myoptind = 1;
+	int ch;
+	const char *myoptarg = nullptr;
+
+	while ((ch = px4_getopt(argc, argv, "f:t:b:", &myoptind, &myoptarg)) != EOF) {
+		switch (ch) {
+		case 'f':
+			filename = myoptarg;
+			break;
+
+		case 't':
+			duration_s = strtoul(myoptarg, nullptr, 10);
+			break;
+
+		case 'b':
+			buffer_size = strtoul(myoptarg, nullptr, 10) * 1024;
+			break;
+
+		default:
+			return 1;
+		}
+	}
+
+	static constexpr uint32_t rates_kb_s[] {1000, 5000, 10000, 20000};
+
+#if defined(LOG_WRITER_FILE_ASYNC)
+	static constexpr bool backends[] {false, true};
+#else
+	static constexpr bool backends[] {false};
+#endif
+
+	PX4_INFO("writing %s for %" PRIu32 " s per rate, %zu KiB buffer", filename, duration_s, buffer_size / 1024);
+	PX4_INFO_RAW("backend  rate MB/s written MB   dropped  max write us\n");
+
+	for (bool async : backends) {
+		for (uint32_t rate_kb_s : rates_kb_s) {
+			bench_run(filename, buffer_size, async, rate_kb_s, duration_s);
+		}
+	}
+
+	return 0;
+}
+
+} // namespace logger
+} // namespace px4
@@ -132,6 +132,7 @@ void LoggedTopics::add_default_topics()
 	add_topic("vehicle_status");
 	add_optional_topic("vtol_vehicle_status", 200);
 	add_topic("wind", 1000);
+	add_optional_topic("work_item_status");
 
 	// multi topics
 	add_optional_topic_multi("actuator_outputs", 100, 3);
@@ -493,6 +494,7 @@ bool LoggedTopics::add_topic(const orb_metadata *topic, uint16_t interval_ms, ui
 	sub.interval_ms = interval_ms;
 	sub.instance = instance;
 	sub.id = static_cast<ORB_ID>(topic->o_id);
+	sub.delta_encoded = false;
 	return true;
 }
 
@@ -547,6 +549,35 @@ bool LoggedTopics::add_topic_multi(const char *name, uint16_t interval_ms, uint8
 	return true;
 }
 
+void LoggedTopics::set_delta_encoded(const char *name)
+{
+	for (int i = 0; i < _subscriptions.count; ++i) {
+		if (strcmp(name, get_orb_meta(_subscriptions.sub[i].id)->o_name) == 0) {
+			_subscriptions.sub[i].delta_encoded = true;
+		}
+	}
+}
+
+void LoggedTopics::select_delta_encoded_topics()
+{
+	set_delta_encoded("actuator_motors");
+	set_delta_encoded("actuator_outputs");
+	set_delta_encoded("estimator_innovation_test_ratios");
+	set_delta_encoded("estimator_innovation_variances");
+	set_delta_encoded("estimator_innovations");
+	set_delta_encoded("estimator_sensor_bias");
+	set_delta_encoded("estimator_states");
+	set_delta_encoded("estimator_status");
+	set_delta_encoded("sensor_combined");
+	set_delta_encoded("vehicle_acceleration");
+	set_delta_encoded("vehicle_angular_velocity");
+	set_delta_encoded("vehicle_attitude");
+	set_delta_encoded("vehicle_attitude_setpoint");
+	set_delta_encoded("vehicle_imu");
+	set_delta_encoded("vehicle_local_position");
+	set_delta_encoded("vehicle_rates_setpoint");
+}
+
 bool LoggedTopics::initialize_logged_topics(SDLogProfileMask profile)
 {
 	int ntopics = add_topics_from_file(PX4_STORAGEDIR "/etc/logging/logger_topics.txt");
@@ -558,6 +589,8 @@ bool LoggedTopics::initialize_logged_topics(SDLogProfileMask profile)
 		initialize_configured_topics(profile);
 	}
 
+	select_delta_encoded_topics();
+
 	return _subscriptions.count > 0;
 }
 
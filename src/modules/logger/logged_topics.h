@@ -83,6 +83,7 @@ public:
 		uint16_t interval_ms;
 		uint8_t instance;
 		ORB_ID id{ORB_ID::INVALID};
+		bool delta_encoded{false}; ///< write delta encoded data messages (@see ulog_message_data_delta_s)
 	};
 	struct RequestedSubscriptionArray {
 		RequestedSubscription sub[MAX_TOPICS_NUM];
@@ -143,6 +144,18 @@ private:
 		return add_topic_multi(name, interval_ms, max_num_instances, true);
 	}
 
+	/**
+	 * Select delta encoding for all added instances of a topic.
+	 * Delta encoding is used for topics logged at high rate, where consecutive samples only differ in few bytes.
+	 * @param name topic name
+	 */
+	void set_delta_encoded(const char *name);
+
+	/**
+	 * Select the delta encoded topics (called after all topics are added)
+	 */
+	void select_delta_encoded_topics();
+
 	/**
 	 * Parse a file containing a list of uORB topics to log, calling add_topic for each
 	 * @param fname name of file
@@ -144,6 +144,15 @@ constexpr const char *Logger::LOG_ROOT[(int)LogType::Count];
 
 int Logger::custom_command(int argc, char *argv[])
 {
+#if defined(CONFIG_LOGGER_BENCH)
+
+	// standalone, uses its own writer
+	if (!strcmp(argv[0], "bench")) {
+		return log_writer_file_bench(argc, argv);
+	}
+
+#endif // CONFIG_LOGGER_BENCH
+
 	if (!is_running()) {
 		print_usage("logger not running");
 		return 1;
@@ -478,6 +487,98 @@ bool Logger::copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe)
 	return updated;
 }
 
+void Logger::write_subscription_data(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time, uint32_t &total_bytes)
+{
+	LoggerSubscription &sub = _subscriptions[sub_idx];
+
+	/* if this topic has been updated, copy the new data into the message buffer
+	 * and write a message to the log
+	 */
+	if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
+		// each message consists of a header followed by an orb data object
+		const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
+		const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
+		const uint16_t write_msg_id = sub.msg_id;
+
+		//write one byte after another (necessary because of alignment)
+		_msg_buffer[0] = (uint8_t)write_msg_size;
+		_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
+		_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
+		_msg_buffer[3] = (uint8_t)write_msg_id;
+		_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+
+		// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+
+		// full log
+		uint8_t *full_msg = _msg_buffer;
+		size_t full_msg_size = msg_size;
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+		// the delta encoded messages are only written to the file (the mavlink stream has no incompat flag for them)
+		if (_delta_encoder.enabled(sub_idx) && !_writer.is_started(LogType::Full, LogWriter::BackendMavlink)) {
+			const int encoded_size = _delta_encoder.encode(sub_idx, _msg_buffer + sizeof(ulog_message_data_s));
+
+			if (encoded_size >= 0) {
+				uint8_t *delta_msg = _delta_encoder.message_buffer();
+				full_msg_size = sizeof(ulog_message_data_delta_s) + encoded_size;
+				const uint16_t write_delta_msg_size = static_cast<uint16_t>(full_msg_size - ULOG_MSG_HEADER_LEN);
+				delta_msg[0] = (uint8_t)write_delta_msg_size;
+				delta_msg[1] = (uint8_t)(write_delta_msg_size >> 8);
+				delta_msg[2] = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+				delta_msg[3] = (uint8_t)write_msg_id;
+				delta_msg[4] = (uint8_t)(write_msg_id >> 8);
+				full_msg = delta_msg;
+			}
+		}
+
+#endif
+
+		if (write_message(LogType::Full, full_msg, full_msg_size)) {
+
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+			_log_index.data_written(write_msg_id, _writer.get_write_offset_file(LogType::Full) - full_msg_size);
+#endif
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+			_delta_encoder.sample_written(sub_idx, _msg_buffer + sizeof(ulog_message_data_s));
+#endif
+
+#ifdef DBGPRINT
+			total_bytes += full_msg_size;
+#endif /* DBGPRINT */
+
+		} else {
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+			// the next sample cannot refer to this one
+			_delta_encoder.invalidate(sub_idx);
+#endif
+		}
+
+		// mission log
+		if (sub_idx < _num_mission_subs) {
+			if (_writer.is_started(LogType::Mission)) {
+				if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
+					unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+
+					if (delta_time > 0) {
+						_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
+					}
+
+					write_message(LogType::Mission, _msg_buffer, msg_size);
+				}
+			}
+		}
+
+#if defined(CONFIG_LOGGER_UPDATE_CALLBACKS)
+
+	} else if (sub.valid() && sub.get_interval_us() > 0 && sub.has_new_data()) {
+		// rate limited: check again in the next iteration, so that the last update is not lost
+		_updated_subscriptions.set(sub_idx);
+#endif
+	}
+}
+
 const char *Logger::configured_backend_mode() const
 {
 	switch (_writer.backend()) {
@@ -561,8 +662,27 @@ bool Logger::initialize_topics()
 		for (int i = 0; i < logged_topics.subscriptions().count; ++i) {
 			const LoggedTopics::RequestedSubscription &sub = logged_topics.subscriptions().sub[i];
 			_subscriptions[i] = LoggerSubscription(sub.id, sub.interval_ms, sub.instance);
+#if defined(CONFIG_LOGGER_UPDATE_CALLBACKS)
+			_subscriptions[i].set_updated_subscriptions(&_updated_subscriptions, i);
+#endif
 			_subscriptions[i].subscribe();
 		}
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+		if (_param_sdlog_delta.get() && _delta_encoder.init(logged_topics.subscriptions().count)) {
+			for (int i = 0; i < logged_topics.subscriptions().count; ++i) {
+				if (logged_topics.subscriptions().sub[i].delta_encoded) {
+					_delta_encoder.enable(i, _subscriptions[i].get_topic()->o_size_no_padding);
+				}
+			}
+
+			if (!_delta_encoder.enabled()) {
+				_delta_encoder.deinit();
+			}
+		}
+
+#endif
 	}
 
 	_num_subscriptions = logged_topics.subscriptions().count;
@@ -749,53 +869,54 @@ void Logger::run()
 			/* wait for lock on log buffer */
 			_writer.lock();
 
-			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
-				LoggerSubscription &sub = _subscriptions[sub_idx];
-				/* if this topic has been updated, copy the new data into the message buffer
-				 * and write a message to the log
-				 */
-				const bool try_to_subscribe = (sub_idx == next_subscribe_topic_index);
-
-				if (copy_if_updated(sub_idx, _msg_buffer + sizeof(ulog_message_data_s), try_to_subscribe)) {
-					// each message consists of a header followed by an orb data object
-					const size_t msg_size = sizeof(ulog_message_data_s) + sub.get_topic()->o_size_no_padding;
-					const uint16_t write_msg_size = static_cast<uint16_t>(msg_size - ULOG_MSG_HEADER_LEN);
-					const uint16_t write_msg_id = sub.msg_id;
-
-					//write one byte after another (necessary because of alignment)
-					_msg_buffer[0] = (uint8_t)write_msg_size;
-					_msg_buffer[1] = (uint8_t)(write_msg_size >> 8);
-					_msg_buffer[2] = static_cast<uint8_t>(ULogMessageType::DATA);
-					_msg_buffer[3] = (uint8_t)write_msg_id;
-					_msg_buffer[4] = (uint8_t)(write_msg_id >> 8);
+			const hrt_abstime check_start = hrt_absolute_time();
 
-					// PX4_INFO("topic: %s, size = %zu, out_size = %zu", sub.get_topic()->o_name, sub.get_topic()->o_size, msg_size);
+#if defined(CONFIG_LOGGER_UPDATE_CALLBACKS)
 
-					// full log
-					if (write_message(LogType::Full, _msg_buffer, msg_size)) {
+			if (!was_started) {
+				// write the current data of all topics at the start of the log
+				for (int word = 0; word < UpdatedSubscriptions::NUM_WORDS; ++word) {
+					_updated_subscriptions.take(word);
+				}
 
-#ifdef DBGPRINT
-						total_bytes += msg_size;
-#endif /* DBGPRINT */
-					}
+				for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+					write_subscription_data(sub_idx, sub_idx == next_subscribe_topic_index, loop_time, total_bytes);
+				}
 
-					// mission log
-					if (sub_idx < _num_mission_subs) {
-						if (_writer.is_started(LogType::Mission)) {
-							if (_mission_subscriptions[sub_idx].next_write_time < (loop_time / 100000)) {
-								unsigned delta_time = _mission_subscriptions[sub_idx].min_delta_ms;
+				_topics_checked += _num_subscriptions;
 
-								if (delta_time > 0) {
-									_mission_subscriptions[sub_idx].next_write_time = (loop_time / 100000) + delta_time / 100;
-								}
+			} else {
+				// only check the topics that have been published since the last iteration
+				for (int word = 0; word * 32 < _num_subscriptions; ++word) {
+					uint32_t updated = _updated_subscriptions.take(word);
 
-								write_message(LogType::Mission, _msg_buffer, msg_size);
-							}
+					if (next_subscribe_topic_index / 32 == word) {
+						updated |= 1u << (next_subscribe_topic_index % 32);
+					}
+
+					while (updated != 0) {
+						const int sub_idx = word * 32 + __builtin_ctz(updated);
+						updated &= updated - 1;
+
+						if (sub_idx < _num_subscriptions) {
+							write_subscription_data(sub_idx, sub_idx == next_subscribe_topic_index, loop_time, total_bytes);
+							++_topics_checked;
 						}
 					}
 				}
 			}
 
+#else
+
+			for (int sub_idx = 0; sub_idx < _num_subscriptions; ++sub_idx) {
+				write_subscription_data(sub_idx, sub_idx == next_subscribe_topic_index, loop_time, total_bytes);
+			}
+
+			_topics_checked += _num_subscriptions;
+#endif // CONFIG_LOGGER_UPDATE_CALLBACKS
+
+			_topics_check_time += hrt_elapsed_time(&check_start);
+
 			// check for new events
 			handle_event_updates(total_bytes);
 
@@ -837,7 +958,18 @@ void Logger::run()
 				_msg_buffer[9] = 0xBB;
 				_msg_buffer[10] = 0x12;
 
-				write_message(LogType::Full, _msg_buffer, write_msg_size + ULOG_MSG_HEADER_LEN);
+				if (write_message(LogType::Full, _msg_buffer, write_msg_size + ULOG_MSG_HEADER_LEN)) {
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+					_log_index.sync_written(loop_time, _writer.get_write_offset_file(LogType::Full) - write_msg_size
+								- ULOG_MSG_HEADER_LEN);
+#endif
+				}
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+				// readers can start decoding at any SYNC message
+				_delta_encoder.reset();
+#endif
+
 				_last_sync_time = loop_time;
 			}
 
@@ -1055,12 +1187,27 @@ void Logger::publish_logger_status()
 				status.message_gaps = _message_gaps;
 				status.buffer_used_bytes = buffer_fill_count_file;
 				status.buffer_size_bytes = _writer.get_buffer_size_file(log_type);
+				status.write_latency_max_us = _writer.get_write_latency_max_file(log_type);
+				status.writes_in_flight = _writer.get_writes_in_flight_file(log_type);
+				status.compression_time_us = _writer.get_compression_time_file(log_type);
+
+				if (_writer.is_compressed_file(log_type) && _writer.get_file_size_file(log_type) > 0) {
+					status.compression_ratio = (float)_writer.get_total_written_file(log_type) / _writer.get_file_size_file(log_type);
+
+				} else {
+					status.compression_ratio = 0.f;
+				}
+
 				status.num_messages = _num_subscriptions;
+				status.topics_checked = _topics_checked;
+				status.topics_check_time_us = _topics_check_time;
 				status.timestamp = hrt_absolute_time();
 				_logger_status_pub[i].publish(status);
 			}
 		}
 
+		_topics_checked = 0;
+		_topics_check_time = 0;
 		_logger_status_last = hrt_absolute_time();
 	}
 }
@@ -1418,11 +1565,30 @@ void Logger::start_log_file(LogType type)
 		_param_sdlog_crypto_exchange_key.get());
 #endif
 
+#if defined(CONFIG_LOGGER_COMPRESSION)
+	_writer.set_compression_file(_param_sdlog_compress.get());
+#endif
+
 	if (_writer.start_log_file(type, file_name)) {
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+		if (type == LogType::Full) {
+			_delta_encoder.reset();
+		}
+
+#endif
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+
+		// msg_id's are assigned once per subscription (including the event subscription)
+		if (type == LogType::Full && !_log_index.start(_num_subscriptions + 1)) {
+			PX4_WARN("failed to allocate log index");
+		}
+
+#endif
 		_writer.select_write_backend(LogWriter::BackendFile);
 		_writer.set_need_reliable_transfer(true);
 
-		write_header(type);
+		write_header(type, true);
 		write_version(type);
 		write_formats(type);
 
@@ -1459,12 +1625,72 @@ void Logger::stop_log_file(LogType type)
 	if (type == LogType::Full) {
 		_writer.set_need_reliable_transfer(true);
 		write_perf_data(PrintLoadReason::Postflight);
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+		write_log_index();
+#endif
 		_writer.set_need_reliable_transfer(false);
 	}
 
 	_writer.stop_log_file(type);
 }
 
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+void Logger::write_log_index()
+{
+	if (!_log_index.enabled()) {
+		return;
+	}
+
+	// the offsets are only valid for the file
+	_writer.select_write_backend(LogWriter::BackendFile);
+
+	_writer.lock();
+	const uint64_t index_offset = _writer.get_write_offset_file(LogType::Full);
+	_writer.unlock();
+
+	static constexpr int max_values = 128; // values per message
+	uint64_t values[max_values];
+	int num_values = 0;
+	bool is_continued = false;
+
+	for (int i = 0; i < _log_index.num_sync_points(); ++i) {
+		values[num_values++] = _log_index.sync_point(i).timestamp;
+		values[num_values++] = _log_index.sync_point(i).offset;
+
+		if (num_values == max_values || i == _log_index.num_sync_points() - 1) {
+			write_info_multiple(LogType::Full, "index_sync", values, num_values, is_continued);
+			num_values = 0;
+			is_continued = true;
+		}
+	}
+
+	is_continued = false;
+
+	for (int i = 0; i < _log_index.num_msg_ids(); ++i) {
+		const LogIndex::MsgIdOffsets &msg_id_offsets = _log_index.msg_id_offsets(i);
+
+		if (msg_id_offsets.add_logged_msg != 0) {
+			values[num_values++] = i;
+			values[num_values++] = msg_id_offsets.add_logged_msg;
+			values[num_values++] = msg_id_offsets.first_data;
+			values[num_values++] = msg_id_offsets.last_data;
+		}
+
+		if ((num_values == max_values || i == _log_index.num_msg_ids() - 1) && num_values > 0) {
+			write_info_multiple(LogType::Full, "index_msg_id", values, num_values, is_continued);
+			num_values = 0;
+			is_continued = true;
+		}
+	}
+
+	// fixed size trailer at the end of the file, so that readers can find the index
+	write_info(LogType::Full, "index_offset", index_offset);
+
+	_writer.unselect_write_backend();
+	_log_index.reset();
+}
+#endif
+
 void Logger::start_log_mavlink()
 {
 	if (!can_start_mavlink_log()) {
@@ -1483,7 +1709,7 @@ void Logger::start_log_mavlink()
 	_writer.start_log_mavlink();
 	_writer.select_write_backend(LogWriter::BackendMavlink);
 	_writer.set_need_reliable_transfer(true);
-	write_header(LogType::Full);
+	write_header(LogType::Full, false);
 	write_version(LogType::Full);
 	write_formats(LogType::Full);
 	write_parameters(LogType::Full);
@@ -1853,7 +2079,18 @@ void Logger::write_add_logged_msg(LogType type, LoggerSubscription &subscription
 
 	bool prev_reliable = _writer.need_reliable_transfer();
 	_writer.set_need_reliable_transfer(true);
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+	const size_t offset = _writer.get_write_offset_file(LogType::Full);
+#endif
 	write_message(type, &msg, msg_size);
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+
+	// only if it was written to the file (and not just to mavlink)
+	if (type == LogType::Full && _writer.get_write_offset_file(LogType::Full) >= offset + msg_size) {
+		_log_index.add_logged_msg_written(msg.msg_id, _writer.get_write_offset_file(LogType::Full) - msg_size);
+	}
+
+#endif
 	_writer.set_need_reliable_transfer(prev_reliable);
 }
 
@@ -1961,6 +2198,35 @@ void Logger::write_info_multiple(LogType type, const char *name, int fd)
 	}
 }
 
+void Logger::write_info_multiple(LogType type, const char *name, const uint64_t *values, int num_values,
+				 bool is_continued)
+{
+	_writer.lock();
+	ulog_message_info_multiple_s msg;
+	uint8_t *buffer = reinterpret_cast<uint8_t *>(&msg);
+	msg.msg_type = static_cast<uint8_t>(ULogMessageType::INFO_MULTIPLE);
+	msg.is_continued = is_continued;
+
+	/* construct format key (type and name) */
+	msg.key_len = snprintf(msg.key_value_str, sizeof(msg.key_value_str), "uint64_t[%i] %s", num_values, name);
+	size_t msg_size = sizeof(msg) - sizeof(msg.key_value_str) + msg.key_len;
+	const size_t values_size = num_values * sizeof(uint64_t);
+
+	if (values_size < (sizeof(msg) - msg_size)) {
+		memcpy(&buffer[msg_size], values, values_size);
+		msg_size += values_size;
+
+		msg.msg_size = msg_size - ULOG_MSG_HEADER_LEN;
+
+		write_message(type, buffer, msg_size);
+
+	} else {
+		PX4_ERR("info_multiple too long (%i values), key=%s", num_values, name);
+	}
+
+	_writer.unlock();
+}
+
 void Logger::write_info(LogType type, const char *name, int32_t value)
 {
 	write_info_template<int32_t>(type, name, value, "int32_t");
@@ -1971,6 +2237,11 @@ void Logger::write_info(LogType type, const char *name, uint32_t value)
 	write_info_template<uint32_t>(type, name, value, "uint32_t");
 }
 
+void Logger::write_info(LogType type, const char *name, uint64_t value)
+{
+	write_info_template<uint64_t>(type, name, value, "uint64_t");
+}
+
 
 template<typename T>
 void Logger::write_info_template(LogType type, const char *name, T value, const char *type_str)
@@ -2006,7 +2277,7 @@ void Logger::write_excluded_optional_topics(LogType type)
 	}
 }
 
-void Logger::write_header(LogType type)
+void Logger::write_header(LogType type, bool file_header)
 {
 	ulog_file_header_s header = {};
 	header.magic[0] = 'U';
@@ -2026,6 +2297,18 @@ void Logger::write_header(LogType type)
 
 	flag_bits.compat_flags[0] = ULOG_COMPAT_FLAG0_DEFAULT_PARAMETERS_MASK;
 
+	if (file_header && _writer.is_compressed_file(type)) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK;
+	}
+
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+
+	if (file_header && type == LogType::Full && _delta_encoder.enabled()) {
+		flag_bits.incompat_flags[0] |= ULOG_INCOMPAT_FLAG0_DELTA_DATA_MASK;
+	}
+
+#endif
+
 	flag_bits.msg_size = sizeof(flag_bits) - ULOG_MSG_HEADER_LEN;
 	flag_bits.msg_type = static_cast<uint8_t>(ULogMessageType::FLAG_BITS);
 
@@ -2434,6 +2717,12 @@ $ logger on
 	PRINT_MODULE_USAGE_PARAM_FLOAT('c', 1.0, 0.2, 2.0, "Log rate factor (higher is faster)", true);
 	PRINT_MODULE_USAGE_COMMAND_DESCR("on", "start logging now, override arming (logger must be running)");
 	PRINT_MODULE_USAGE_COMMAND_DESCR("off", "stop logging now, override arming (logger must be running)");
+#if defined(CONFIG_LOGGER_BENCH)
+	PRINT_MODULE_USAGE_COMMAND_DESCR("bench", "benchmark the file writer with synthetic data at 1-20 MB/s (logger not logging)");
+	PRINT_MODULE_USAGE_PARAM_STRING('f', nullptr, "<file>", "File to write (removed afterwards)", true);
+	PRINT_MODULE_USAGE_PARAM_INT('t', 5, 1, 60, "Duration per rate in seconds", true);
+	PRINT_MODULE_USAGE_PARAM_INT('b', 64, 4, 10000, "Write buffer size in KiB", true);
+#endif // CONFIG_LOGGER_BENCH
 #ifdef __PX4_NUTTX
 	PRINT_MODULE_USAGE_COMMAND_DESCR("trigger_watchdog", "manually trigger the watchdog now");
 #endif
@@ -33,6 +33,8 @@
 
 #pragma once
 
+#include "delta_encoder.h"
+#include "log_index.h"
 #include "log_writer.h"
 #include "logged_topics.h"
 #include "messages.h"
@@ -50,6 +52,10 @@
 #include <uORB/PublicationMulti.hpp>
 #include <uORB/Subscription.hpp>
 #include <uORB/SubscriptionInterval.hpp>
+#if defined(CONFIG_LOGGER_UPDATE_CALLBACKS)
+#include <px4_platform_common/atomic.h>
+#include <uORB/SubscriptionCallback.hpp>
+#endif
 #include <uORB/topics/logger_status.h>
 #include <uORB/topics/log_message.h>
 #include <uORB/topics/manual_control_setpoint.h>
@@ -71,6 +77,79 @@ namespace logger
 
 static constexpr uint8_t MSG_ID_INVALID = UINT8_MAX;
 
+#if defined(CONFIG_LOGGER_UPDATE_CALLBACKS)
+
+/**
+ * @class UpdatedSubscriptions
+ * Bitset of the subscriptions with new data. The bits are set from the publisher's context (uORB callback)
+ * and collected by the logger thread, so that it only needs to check the updated topics.
+ */
+class UpdatedSubscriptions
+{
+public:
+	static constexpr int NUM_WORDS = (LoggedTopics::MAX_TOPICS_NUM + 31) / 32;
+
+	void set(int index) { _words[index / 32].fetch_or(1u << (index % 32)); }
+
+	/** get and clear the bits of a word */
+	uint32_t take(int word) { return _words[word].fetch_and(0); }
+
+private:
+	px4::atomic<uint32_t> _words[NUM_WORDS] {};
+};
+
+struct LoggerSubscription : public uORB::SubscriptionCallback {
+	LoggerSubscription() : uORB::SubscriptionCallback(nullptr) {}
+
+	LoggerSubscription(ORB_ID id, uint32_t interval_ms = 0, uint8_t instance = 0) :
+		uORB::SubscriptionCallback(get_orb_meta(id), interval_ms * 1000, instance)
+	{}
+
+	/**
+	 * Set the bit index in updated_subscriptions on every publication (once subscribed)
+	 */
+	void set_updated_subscriptions(UpdatedSubscriptions *updated_subscriptions, uint8_t index)
+	{
+		_updated_subscriptions = updated_subscriptions;
+		_index = index;
+	}
+
+	/**
+	 * Subscribe, and register the update callback once the topic exists
+	 * (registerCallback() would otherwise create the topic)
+	 */
+	bool subscribe()
+	{
+		if (!uORB::SubscriptionCallback::subscribe()) {
+			return false;
+		}
+
+		if (_updated_subscriptions) {
+			registerCallback();
+		}
+
+		return true;
+	}
+
+	void call() override
+	{
+		if (_updated_subscriptions) {
+			_updated_subscriptions->set(_index);
+		}
+	}
+
+	/** check for new data, independent of the interval */
+	bool has_new_data() { return _subscription.updated(); }
+
+	uint8_t msg_id{MSG_ID_INVALID};
+
+private:
+	UpdatedSubscriptions *_updated_subscriptions{nullptr};
+	uint8_t _index{0};
+};
+
+#else
+
 struct LoggerSubscription : public uORB::SubscriptionInterval {
 	LoggerSubscription() = default;
 
@@ -81,6 +160,8 @@ struct LoggerSubscription : public uORB::SubscriptionInterval {
 	uint8_t msg_id{MSG_ID_INVALID};
 };
 
+#endif // CONFIG_LOGGER_UPDATE_CALLBACKS
+
 class Logger : public ModuleBase<Logger>, public ModuleParams
 {
 public:
@@ -233,8 +314,10 @@ private:
 
 	/**
 	 * write the file header with file magic and timestamp.
+	 * @param file_header true if written to the file backend only: the file specific incompat flags
+	 *                    (compression, delta encoded data) are only set in that case
 	 */
-	void write_header(LogType type);
+	void write_header(LogType type, bool file_header);
 
 	void write_formats(LogType type);
 
@@ -243,6 +326,13 @@ private:
 	 */
 	void write_perf_data(PrintLoadReason reason);
 
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+	/**
+	 * Append the seek index to the full log (before closing it)
+	 */
+	void write_log_index();
+#endif
+
 	/**
 	 * write bootup console output
 	 */
@@ -265,8 +355,10 @@ private:
 	void write_info(LogType type, const char *name, const char *value);
 	void write_info_multiple(LogType type, const char *name, const char *value, bool is_continued);
 	void write_info_multiple(LogType type, const char *name, int fd);
+	void write_info_multiple(LogType type, const char *name, const uint64_t *values, int num_values, bool is_continued);
 	void write_info(LogType type, const char *name, int32_t value);
 	void write_info(LogType type, const char *name, uint32_t value);
+	void write_info(LogType type, const char *name, uint64_t value);
 
 	/** generic common template method for write_info variants */
 	template<typename T>
@@ -280,6 +372,12 @@ private:
 
 	inline bool copy_if_updated(int sub_idx, void *buffer, bool try_to_subscribe);
 
+	/**
+	 * Write the data of a subscription to the log if it has been updated
+	 */
+	inline void write_subscription_data(int sub_idx, bool try_to_subscribe, hrt_abstime loop_time,
+					    uint32_t &total_bytes);
+
 	/**
 	 * Write exactly one ulog message to the logger and handle dropouts.
 	 * Must be called with _writer.lock() held.
@@ -354,6 +452,11 @@ private:
 
 	LoggerSubscription	 			*_subscriptions{nullptr}; ///< all subscriptions for full & mission log (in front)
 	int						_num_subscriptions{0};
+#if defined(CONFIG_LOGGER_UPDATE_CALLBACKS)
+	UpdatedSubscriptions				_updated_subscriptions;
+#endif
+	uint32_t					_topics_checked{0}; ///< number of topics checked for updates since the last status
+	uint32_t					_topics_check_time{0}; ///< time spent checking and writing topics since the last status [us]
 	MissionSubscription 				_mission_subscriptions[MAX_MISSION_TOPICS_NUM] {}; ///< additional data for mission subscriptions
 	int						_num_mission_subs{0};
 	LoggerSubscription				_event_subscription; ///< Subscription for the event topic (handled separately)
@@ -364,6 +467,12 @@ private:
 	int						_num_excluded_optional_topic_ids{0};
 
 	LogWriter					_writer;
+#if defined(CONFIG_LOGGER_SEEK_INDEX)
+	LogIndex					_log_index; ///< seek index of the full log file
+#endif
+#if defined(CONFIG_LOGGER_DELTA_ENCODING)
+	DeltaEncoder					_delta_encoder; ///< delta encoding of the full log file data
+#endif
 	uint32_t					_log_interval{0};
 	float						_rate_factor{1.0f};
 	const orb_metadata				*_polling_topic_meta{nullptr}; ///< if non-null, poll on this topic instead of sleeping
@@ -397,7 +506,9 @@ private:
 		(ParamInt<px4::params::SDLOG_PROFILE>) _param_sdlog_profile,
 		(ParamInt<px4::params::SDLOG_MISSION>) _param_sdlog_mission,
 		(ParamBool<px4::params::SDLOG_BOOT_BAT>) _param_sdlog_boot_bat,
-		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid
+		(ParamBool<px4::params::SDLOG_UUID>) _param_sdlog_uuid,
+		(ParamBool<px4::params::SDLOG_COMPRESS>) _param_sdlog_compress,
+		(ParamBool<px4::params::SDLOG_DELTA>) _param_sdlog_delta
 #if defined(PX4_CRYPTO)
 		, (ParamInt<px4::params::SDLOG_ALGORITHM>) _param_sdlog_crypto_algorithm,
 		(ParamInt<px4::params::SDLOG_KEY>) _param_sdlog_crypto_key,
@@ -49,6 +49,7 @@ enum class ULogMessageType : uint8_t {
 	LOGGING = 'L',
 	LOGGING_TAGGED = 'C',
 	FLAG_BITS = 'B',
+	DATA_DELTA = 'X',
 };
 
 
@@ -179,6 +180,21 @@ struct ulog_message_data_s {
 	uint16_t msg_id;
 };
 
+/**
+ * @brief Delta encoded Data Message (only if ULOG_INCOMPAT_FLAG0_DELTA_DATA_MASK is set)
+ *
+ * Same as ulog_message_data_s, but the data is the XOR with the previous data message of the same msg_id
+ * (DATA or DATA_DELTA), packed as a sequence of runs [unchanged byte count, changed byte count, changed bytes].
+ * The counts are unsigned LEB128 varints, trailing unchanged bytes are omitted (@see DeltaEncoder).
+ * The first data message of a msg_id and the first one after each SYNC message are always DATA messages.
+ */
+struct ulog_message_data_delta_s {
+	uint16_t msg_size; ///< size of message - ULOG_MSG_HEADER_LEN
+	uint8_t msg_type = static_cast<uint8_t>(ULogMessageType::DATA_DELTA);
+
+	uint16_t msg_id;
+};
+
 /**
  * @brief Information Message
  *
@@ -282,6 +298,8 @@ struct ulog_message_parameter_default_s {
 
 
 #define ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK (1<<0)
+#define ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK (1<<1) ///< data after the flag bits is stored in compressed frames
+#define ULOG_INCOMPAT_FLAG0_DELTA_DATA_MASK (1<<2) ///< the log contains DATA_DELTA messages
 
 #define ULOG_COMPAT_FLAG0_DEFAULT_PARAMETERS_MASK (1<<0)
 
@@ -294,4 +312,14 @@ struct ulog_message_flag_bits_s {
 	uint64_t appended_offsets[3]; ///< file offset(s) for appended data if ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK is set
 };
 
+/**
+ * Header of a compressed frame (if ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK is set).
+ * The file header and the flag bits message are stored uncompressed, followed by a sequence of frames,
+ * each compressed independently with heatshrink (window size 2^8, lookahead 2^4).
+ */
+struct ulog_compressed_frame_header_s {
+	uint16_t compressed_size; ///< size of the compressed data following the header
+	uint16_t uncompressed_size;
+};
+
 #pragma pack(pop)
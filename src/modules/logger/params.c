@@ -177,6 +177,34 @@ PARAM_DEFINE_INT32(SDLOG_DIRS_MAX, 0);
  */
 PARAM_DEFINE_INT32(SDLOG_UUID, 1);
 
+/**
+ * Log compression
+ *
+ * If enabled, the full log file is written in compressed frames, reducing the file size
+ * and the storage write rate at the cost of CPU time for compression. Compressed logs need to
+ * be decompressed (Tools/ulog_decompress.py) before they can be read by standard ULog tools.
+ * Encrypted logs are not compressed. Only has an effect if the logger is built with compression support.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_COMPRESS, 0);
+
+/**
+ * Log delta encoding
+ *
+ * If enabled, the data of selected high-rate topics is written to the full log file as the difference
+ * to the previous sample (DATA_DELTA messages), which reduces the log size. The log needs to be
+ * converted (Tools/ulog_decompress.py) before it can be read by standard ULog tools.
+ * Only has an effect if the logger is built with delta encoding support.
+ *
+ * @boolean
+ * @reboot_required true
+ * @group SD Logging
+ */
+PARAM_DEFINE_INT32(SDLOG_DELTA, 0);
+
 /**
  * Logfile Encryption algorithm
  *
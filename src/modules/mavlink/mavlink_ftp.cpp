@@ -60,12 +60,18 @@ MavlinkFTP::MavlinkFTP(Mavlink *mavlink) :
 {
 	// initialize session
 	_session_info.fd = -1;
+	_session_info.file_position = UINT32_MAX;
 }
 
 MavlinkFTP::~MavlinkFTP()
 {
+	_session_close();
+	_list_close();
+
 	delete[] _work_buffer1;
 	delete[] _work_buffer2;
+	delete[] _session_buffer;
+	delete[] _list_path;
 }
 
 unsigned
@@ -356,29 +362,44 @@ MavlinkFTP::_workList(PayloadHeader *payload)
 
 	ErrorCode errorCode = kErrNone;
 	unsigned offset = 0;
+	unsigned num_entries = 0;
+	DIR *dp = nullptr;
 
-	PX4_DEBUG("opendir: %s", _work_buffer1);
+	if (_list_dir && payload->offset == _list_offset && strcmp(_list_path, _work_buffer1) == 0) {
+		// continue where the previous List command of the same directory stopped
+		dp = _list_dir;
+		_list_dir = nullptr;
 
-	DIR *dp = opendir(_work_buffer1);
+	} else {
+		_list_close();
 
-	if (dp == nullptr) {
-		_our_errno = errno;
-		PX4_DEBUG("Dir open failed %s: %s", _work_buffer1, strerror(_our_errno));
-		return kErrFileNotFound;
-	}
+		PX4_DEBUG("opendir: %s", _work_buffer1);
 
-	PX4_DEBUG("FTP: list %s offset %" PRIu32, _work_buffer1, payload->offset);
+		dp = opendir(_work_buffer1);
 
-	struct dirent *result = nullptr;
+		if (dp == nullptr) {
+			_our_errno = errno;
+			PX4_DEBUG("Dir open failed %s: %s", _work_buffer1, strerror(_our_errno));
+			return kErrFileNotFound;
+		}
+
+		// move to the requested offset
+		int requested_offset = payload->offset;
 
-	// move to the requested offset
-	int requested_offset = payload->offset;
+		PX4_DEBUG("readdir with offset: %d", requested_offset);
+
+		while (requested_offset-- > 0 && readdir(dp)) {}
+	}
 
-	PX4_DEBUG("readdir with offset: %d", requested_offset);
+	PX4_DEBUG("FTP: list %s offset %" PRIu32, _work_buffer1, payload->offset);
 
-	while (requested_offset-- > 0 && readdir(dp)) {}
+	struct dirent *result = nullptr;
+	bool reply_full = false;
 
 	for (;;) {
+		// position of the entry, to go back to it if it does not fit into this reply anymore
+		const long entry_position = telldir(dp);
+
 		errno = 0;
 		result = readdir(dp);
 
@@ -481,6 +502,8 @@ MavlinkFTP::_workList(PayloadHeader *payload)
 
 		// Do we have room for the name, the one char directory identifier and the null terminator?
 		if ((offset + nameLen + 2) > kMaxDataLength) {
+			seekdir(dp, entry_position);
+			reply_full = true;
 			break;
 		}
 
@@ -489,14 +512,38 @@ MavlinkFTP::_workList(PayloadHeader *payload)
 		strcpy((char *)&payload->data[offset], _work_buffer2);
 		PX4_DEBUG("FTP: list %s %s", _work_buffer1, (char *)&payload->data[offset - 1]);
 		offset += nameLen + 1;
+		num_entries++;
+	}
+
+	if (reply_full && !_list_path) {
+		_list_path = new char[_work_buffer1_len];
+	}
+
+	if (reply_full && _list_path) {
+		// the GCS requests the next entries with the next List command: keep the directory open to avoid reading
+		// through all the previous entries again
+		_list_dir = dp;
+		_list_offset = payload->offset + num_entries;
+		strncpy(_list_path, _work_buffer1, _work_buffer1_len);
+
+	} else {
+		closedir(dp);
 	}
 
-	closedir(dp);
 	payload->size = offset;
 
 	return errorCode;
 }
 
+void
+MavlinkFTP::_list_close()
+{
+	if (_list_dir) {
+		closedir(_list_dir);
+		_list_dir = nullptr;
+	}
+}
+
 /// @brief Responds to an Open command
 MavlinkFTP::ErrorCode
 MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
@@ -542,7 +589,11 @@ MavlinkFTP::_workOpen(PayloadHeader *payload, int oflag)
 
 	_session_info.fd = fd;
 	_session_info.file_size = fileSize;
+	_session_info.file_position = 0;
 	_session_info.stream_download = false;
+	_session_info.buffer_fill = 0;
+	_session_info.buffer_dirty = false;
+	_session_info.write_errno = 0;
 
 	payload->session = 0;
 	payload->size = sizeof(uint32_t);
@@ -567,19 +618,10 @@ MavlinkFTP::_workRead(PayloadHeader *payload)
 		return kErrEOF;
 	}
 
-	PX4_DEBUG("lseek with offset: %ld", payload->offset);
-
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-		_our_errno = errno;
-		PX4_ERR("seek fail: %s", strerror(_our_errno));
-		return kErrFailErrno;
-	}
-
-	int bytes_read = ::read(_session_info.fd, &payload->data[0], payload->size);
+	int bytes_read = _session_read(payload->offset, &payload->data[0], payload->size);
 
 	if (bytes_read < 0) {
 		// Negative return indicates error other than eof
-		_our_errno = errno;
 		PX4_ERR("read fail %d, %s", bytes_read, strerror(_our_errno));
 		return kErrFailErrno;
 	}
@@ -603,6 +645,7 @@ MavlinkFTP::_workBurst(PayloadHeader *payload, uint8_t target_system_id, uint8_t
 	_session_info.stream_download = true;
 	_session_info.stream_offset = payload->offset;
 	_session_info.stream_chunk_transmitted = 0;
+	_session_info.stream_last_send = 0;
 	_session_info.stream_seq_number = payload->seq_number + 1;
 	_session_info.stream_target_system_id = target_system_id;
 	_session_info.stream_target_component_id = target_component_id;
@@ -623,22 +666,17 @@ MavlinkFTP::_workWrite(PayloadHeader *payload)
 		return kErrFailFileProtected;
 	}
 
-	if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-		// Unable to see to the specified location
-		PX4_ERR("seek fail");
-		return kErrFailErrno;
-	}
-
 	PX4_DEBUG("write %d bytes", payload->size);
-	int bytes_written = ::write(_session_info.fd, &payload->data[0], payload->size);
 
-	if (bytes_written < 0) {
-		// Negative return indicates error other than eof
-		_our_errno = errno;
-		PX4_ERR("write fail %d, %s", bytes_written, strerror(_our_errno));
-		return kErrFailErrno;
+	// Writes can be pipelined by the GCS: each one is acked individually (with its offset), and the data is
+	// collected and written in larger blocks.
+	ErrorCode error_code = _session_write(payload->offset, &payload->data[0], payload->size);
+
+	if (error_code != kErrNone) {
+		return error_code;
 	}
 
+	const uint32_t bytes_written = payload->size;
 	payload->size = sizeof(uint32_t);
 	std::memcpy(payload->data, &bytes_written, payload->size);
 
@@ -800,13 +838,13 @@ MavlinkFTP::_workTerminate(PayloadHeader *payload)
 	}
 
 	PX4_DEBUG("work terminate: close");
-	::close(_session_info.fd);
-	_session_info.fd = -1;
-	_session_info.stream_download = false;
+	// report errors of buffered writes
+	const ErrorCode error_code = _session_flush();
+	_session_close();
 
 	payload->size = 0;
 
-	return kErrNone;
+	return error_code;
 }
 
 /// @brief Responds to a Reset command
@@ -815,11 +853,8 @@ MavlinkFTP::_workReset(PayloadHeader *payload)
 {
 	PX4_DEBUG("work reset: close");
 
-	if (_session_info.fd != -1) {
-		::close(_session_info.fd);
-		_session_info.fd = -1;
-		_session_info.stream_download = false;
-	}
+	_session_close();
+	_list_close();
 
 	payload->size = 0;
 
@@ -1029,6 +1064,222 @@ MavlinkFTP::_copy_file(const char *src_path, const char *dst_path, size_t length
 	return (length > 0) ? -1 : 0;
 }
 
+bool
+MavlinkFTP::_session_seek(uint32_t offset)
+{
+	if (_session_info.file_position == offset) {
+		return true;
+	}
+
+	if (lseek(_session_info.fd, offset, SEEK_SET) < 0) {
+		_our_errno = errno;
+		_session_info.file_position = UINT32_MAX;
+		PX4_ERR("seek fail: %s", strerror(_our_errno));
+		return false;
+	}
+
+	_session_info.file_position = offset;
+	return true;
+}
+
+int
+MavlinkFTP::_session_read(uint32_t offset, uint8_t *data, unsigned size)
+{
+	if (_session_flush() != kErrNone) {
+		return -1;
+	}
+
+	if (!_session_buffer) {
+		_session_buffer = new uint8_t[_session_buffer_len];
+		_session_info.buffer_fill = 0;
+	}
+
+	if (!_session_buffer) {
+		// read directly
+		if (!_session_seek(offset)) {
+			return -1;
+		}
+
+		int bytes_read = ::read(_session_info.fd, data, size);
+
+		if (bytes_read < 0) {
+			_our_errno = errno;
+			_session_info.file_position = UINT32_MAX;
+			return -1;
+		}
+
+		_session_info.file_position += bytes_read;
+		return bytes_read;
+	}
+
+	const uint32_t buffer_end = _session_info.buffer_offset + _session_info.buffer_fill;
+
+	if (offset < _session_info.buffer_offset || offset >= buffer_end
+	    || (offset + size > buffer_end && !_session_info.buffer_eof)) {
+
+		// read ahead
+		_session_info.buffer_fill = 0;
+
+		if (!_session_seek(offset)) {
+			return -1;
+		}
+
+		int bytes_read = ::read(_session_info.fd, _session_buffer, _session_buffer_len);
+
+		if (bytes_read < 0) {
+			_our_errno = errno;
+			_session_info.file_position = UINT32_MAX;
+			return -1;
+		}
+
+		_session_info.file_position += bytes_read;
+		_session_info.buffer_offset = offset;
+		_session_info.buffer_fill = bytes_read;
+		_session_info.buffer_eof = (unsigned)bytes_read < _session_buffer_len;
+	}
+
+	const unsigned available = _session_info.buffer_offset + _session_info.buffer_fill - offset;
+	const unsigned bytes_read = (size < available) ? size : available;
+	memcpy(data, &_session_buffer[offset - _session_info.buffer_offset], bytes_read);
+
+	return bytes_read;
+}
+
+MavlinkFTP::ErrorCode
+MavlinkFTP::_session_write(uint32_t offset, const uint8_t *data, unsigned size)
+{
+	if (_session_info.write_errno != 0) {
+		_our_errno = _session_info.write_errno;
+		return kErrFailErrno;
+	}
+
+	if (!_session_buffer) {
+		_session_buffer = new uint8_t[_session_buffer_len];
+		_session_info.buffer_fill = 0;
+	}
+
+	const bool append = _session_info.buffer_dirty
+			    && (offset == _session_info.buffer_offset + _session_info.buffer_fill)
+			    && (_session_info.buffer_fill + size <= _session_buffer_len);
+
+	if (!append) {
+		// not consecutive (e.g. a resent write) or the buffer is full: write the pending data first
+		ErrorCode error_code = _session_flush();
+
+		if (error_code != kErrNone) {
+			return error_code;
+		}
+
+		if (!_session_buffer) {
+			// write directly
+			if (!_session_seek(offset)) {
+				return kErrFailErrno;
+			}
+
+			int bytes_written = ::write(_session_info.fd, data, size);
+
+			if (bytes_written < 0) {
+				_our_errno = errno;
+				_session_info.file_position = UINT32_MAX;
+				PX4_ERR("write fail %d, %s", bytes_written, strerror(_our_errno));
+				return kErrFailErrno;
+			}
+
+			_session_info.file_position += bytes_written;
+			return kErrNone;
+		}
+
+		_session_info.buffer_offset = offset;
+		_session_info.buffer_fill = 0;
+		_session_info.buffer_eof = false;
+		_session_info.buffer_dirty = true;
+	}
+
+	memcpy(&_session_buffer[_session_info.buffer_fill], data, size);
+	_session_info.buffer_fill += size;
+
+	if (_session_info.buffer_fill == _session_buffer_len) {
+		return _session_flush();
+	}
+
+	return kErrNone;
+}
+
+MavlinkFTP::ErrorCode
+MavlinkFTP::_session_flush()
+{
+	if (_session_info.buffer_dirty) {
+		_session_info.buffer_dirty = false;
+
+		int bytes_written = -1;
+
+		if (_session_seek(_session_info.buffer_offset)) {
+			bytes_written = ::write(_session_info.fd, _session_buffer, _session_info.buffer_fill);
+
+			if (bytes_written < 0) {
+				_our_errno = errno;
+
+			} else if (bytes_written != (int)_session_info.buffer_fill) {
+				_our_errno = ENOSPC;
+			}
+		}
+
+		if (bytes_written == (int)_session_info.buffer_fill) {
+			_session_info.file_position += bytes_written;
+
+		} else {
+			// the data of already acked writes is lost: fail all further writes of this session
+			PX4_ERR("write fail %d, %s", bytes_written, strerror(_our_errno));
+			_session_info.file_position = UINT32_MAX;
+			_session_info.write_errno = _our_errno;
+			_session_info.buffer_fill = 0;
+		}
+	}
+
+	if (_session_info.write_errno != 0) {
+		_our_errno = _session_info.write_errno;
+		return kErrFailErrno;
+	}
+
+	return kErrNone;
+}
+
+void
+MavlinkFTP::_session_close()
+{
+	if (_session_info.fd < 0) {
+		return;
+	}
+
+	_session_flush();
+	::close(_session_info.fd);
+	_session_info.fd = -1;
+	_session_info.file_position = UINT32_MAX;
+	_session_info.stream_download = false;
+	_session_info.buffer_fill = 0;
+	_session_info.buffer_dirty = false;
+	_session_info.write_errno = 0;
+}
+
+unsigned
+MavlinkFTP::_burst_window_size()
+{
+	/* perform transfers in 35K chunks - this is determined empirical */
+	unsigned window_size = 35000;
+
+#ifndef MAVLINK_FTP_UNIT_TEST
+	// on fast links, use bursts of 100 ms of data to reduce the number of round trips to request the next burst
+	const unsigned data_rate_window_size = _mavlink->get_data_rate() / 10;
+
+	if (data_rate_window_size > window_size) {
+		window_size = data_rate_window_size;
+	}
+
+#endif
+
+	return window_size;
+}
+
 void MavlinkFTP::send()
 {
 
@@ -1044,14 +1295,21 @@ void MavlinkFTP::send()
 				delete[] _work_buffer2;
 				_work_buffer2 = nullptr;
 			}
+
+			if (_session_buffer && !_session_info.stream_download) {
+				_session_flush();
+				delete[] _session_buffer;
+				_session_buffer = nullptr;
+				_session_info.buffer_fill = 0;
+			}
+
+			_list_close();
 		}
 
 	} else if (_session_info.fd != -1) {
 		// close session without activity
 		if (hrt_elapsed_time(&_last_work_buffer_access) > 10_s) {
-			::close(_session_info.fd);
-			_session_info.fd = -1;
-			_session_info.stream_download = false;
+			_session_close();
 			_last_reply_valid = false;
 			PX4_WARN("Session was closed without activity");
 		}
@@ -1067,6 +1325,28 @@ void MavlinkFTP::send()
 	unsigned max_bytes_to_send = _mavlink->get_free_tx_buf();
 	PX4_DEBUG("MavlinkFTP::send max_bytes_to_send(%u) get_free_tx_buf(%u)", max_bytes_to_send, _mavlink->get_free_tx_buf());
 
+#if defined(MAVLINK_UDP)
+
+	if (_mavlink->get_protocol() == Protocol::UDP) {
+		// there is no tx buffer feedback on UDP: pace the burst with the configured data rate instead
+		const hrt_abstime now = hrt_absolute_time();
+		hrt_abstime dt = (_session_info.stream_last_send == 0) ? 10_ms : now - _session_info.stream_last_send;
+
+		if (dt > 20_ms) {
+			dt = 20_ms;
+		}
+
+		const unsigned rate_bytes_to_send = (uint64_t)_mavlink->get_data_rate() * dt / 1_s;
+
+		if (rate_bytes_to_send > max_bytes_to_send) {
+			max_bytes_to_send = rate_bytes_to_send;
+		}
+
+		_session_info.stream_last_send = now;
+	}
+
+#endif // MAVLINK_UDP
+
 	if (max_bytes_to_send < get_size()) {
 		return;
 	}
@@ -1101,14 +1381,7 @@ void MavlinkFTP::send()
 		}
 
 		if (error_code == kErrNone) {
-			if (lseek(_session_info.fd, payload->offset, SEEK_SET) < 0) {
-				error_code = kErrFailErrno;
-				PX4_WARN("stream download: seek fail");
-			}
-		}
-
-		if (error_code == kErrNone) {
-			int bytes_read = ::read(_session_info.fd, &payload->data[0], kMaxDataLength);
+			int bytes_read = _session_read(payload->offset, &payload->data[0], kMaxDataLength);
 
 			if (bytes_read < 0) {
 				// Negative return indicates error other than eof
@@ -1141,8 +1414,7 @@ void MavlinkFTP::send()
 			if (max_bytes_to_send < (get_size() * 2)) {
 				more_data = false;
 
-				/* perform transfers in 35K chunks - this is determined empirical */
-				if (_session_info.stream_chunk_transmitted > 35000) {
+				if (_session_info.stream_chunk_transmitted > _burst_window_size()) {
 					payload->burst_complete = true;
 					_session_info.stream_download = false;
 					_session_info.stream_chunk_transmitted = 0;
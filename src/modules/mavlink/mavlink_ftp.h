@@ -151,6 +151,42 @@ private:
 	ErrorCode	_workRename(PayloadHeader *payload);
 	ErrorCode	_workCalcFileCRC32(PayloadHeader *payload);
 
+	/**
+	 * Read from the session file, through the read-ahead buffer if available
+	 * @return number of bytes read, or <0 on error (errno in _our_errno)
+	 */
+	int		_session_read(uint32_t offset, uint8_t *data, unsigned size);
+
+	/**
+	 * Write to the session file. Consecutive writes are collected in the session buffer (if available) and
+	 * written in larger blocks.
+	 * @return kErrNone on success (the data might not be written yet)
+	 */
+	ErrorCode	_session_write(uint32_t offset, const uint8_t *data, unsigned size);
+
+	/**
+	 * Write pending data of the session buffer to the file
+	 * @return kErrNone on success, or the error of this or a previous buffered write
+	 */
+	ErrorCode	_session_flush();
+
+	/**
+	 * Seek the session file to offset, if not already there
+	 * @return true on success
+	 */
+	bool		_session_seek(uint32_t offset);
+
+	/// Close the session file (pending writes are flushed)
+	void		_session_close();
+
+	/// Close the directory kept open between List commands
+	void		_list_close();
+
+	/**
+	 * @return number of bytes after which a burst is completed and the GCS needs to request the next one
+	 */
+	unsigned	_burst_window_size();
+
 	uint8_t _getServerSystemId(void);
 	uint8_t _getServerComponentId(void);
 	uint8_t _getServerChannel(void);
@@ -173,12 +209,19 @@ private:
 	struct SessionInfo {
 		int		fd;
 		uint32_t	file_size;
+		uint32_t	file_position;		///< current position of fd, UINT32_MAX if unknown
 		bool		stream_download;
 		uint32_t	stream_offset;
 		uint16_t	stream_seq_number;
 		uint8_t		stream_target_system_id;
 		uint8_t         stream_target_component_id;
 		unsigned	stream_chunk_transmitted;
+		hrt_abstime	stream_last_send;	///< time of the last burst send, for pacing
+		uint32_t	buffer_offset;		///< file offset of the session buffer data
+		unsigned	buffer_fill;		///< number of valid bytes in the session buffer
+		bool		buffer_dirty;		///< session buffer contains data not written yet
+		bool		buffer_eof;		///< session buffer was filled up to the end of the file
+		int		write_errno;		///< error of a buffered write, reported on the next write or terminate
 	};
 	struct SessionInfo _session_info {};	///< Session info, fd=-1 for no active session
 
@@ -198,6 +241,19 @@ private:
 	static constexpr int _work_buffer2_len = 256;
 	hrt_abstime _last_work_buffer_access{0}; ///< timestamp when the buffers were last accessed
 
+	/* session buffer: read-ahead for Read/BurstRead and write-behind for Write, allocated on the first use */
+	uint8_t *_session_buffer{nullptr};
+#if defined(__PX4_NUTTX)
+	static constexpr unsigned _session_buffer_len = 4 * kMaxDataLength;
+#else
+	static constexpr unsigned _session_buffer_len = 64 * kMaxDataLength;
+#endif
+
+	/* directory of the last List command that did not fit into one reply, continued by the next List command */
+	DIR *_list_dir{nullptr};
+	char *_list_path{nullptr};
+	uint32_t _list_offset{0}; ///< entry offset at which _list_dir continues
+
 	// prepend a root directory to each file/dir access to avoid enumerating the full FS tree (e.g. on Linux).
 	// Note that requests can still fall outside of the root dir by using ../..
 #ifdef MAVLINK_FTP_UNIT_TEST
@@ -762,11 +762,30 @@ void Mavlink::send_finish()
 		return;
 	}
 
+#if defined(MAVLINK_TX_BATCHING)
+
+	if (_tx_batching) {
+		if (_tx_batch_num_packets == TX_BATCH_MAX_PACKETS || _tx_batch_fill + _buf_fill > sizeof(_tx_batch_buf)) {
+			send_batch();
+		}
+
+		memcpy(&_tx_batch_buf[_tx_batch_fill], _buf, _buf_fill);
+		_tx_batch_packet_len[_tx_batch_num_packets++] = _buf_fill;
+		_tx_batch_fill += _buf_fill;
+		_buf_fill = 0;
+
+		pthread_mutex_unlock(&_send_mutex);
+		return;
+	}
+
+#endif // MAVLINK_TX_BATCHING
+
 	int ret = -1;
 
 	// send message to UART
 	if (get_protocol() == Protocol::SERIAL) {
 		ret = ::write(_uart_fd, _buf, _buf_fill);
+		_tx_syscalls++;
 	}
 
 #if defined(MAVLINK_UDP)
@@ -778,6 +797,7 @@ void Mavlink::send_finish()
 		if (_src_addr_initialized) {
 # endif // CONFIG_NET
 			ret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_src_addr, sizeof(_src_addr));
+			_tx_syscalls++;
 # if defined(CONFIG_NET)
 		}
 
@@ -793,6 +813,7 @@ void Mavlink::send_finish()
 			if (_broadcast_address_found && _buf_fill > 0) {
 
 				int bret = sendto(_socket_fd, _buf, _buf_fill, 0, (struct sockaddr *)&_bcast_addr, sizeof(_bcast_addr));
+				_tx_syscalls++;
 
 				if (bret <= 0) {
 					if (!_broadcast_failed_warned) {
@@ -823,6 +844,149 @@ void Mavlink::send_finish()
 	pthread_mutex_unlock(&_send_mutex);
 }
 
+#if defined(MAVLINK_TX_BATCHING)
+void Mavlink::send_batch()
+{
+	if (_tx_batch_num_packets == 0) {
+		return;
+	}
+
+	iovec *iov = _tx_batch_iov;
+	unsigned offset = 0;
+
+	for (int i = 0; i < _tx_batch_num_packets; ++i) {
+		iov[i].iov_base = &_tx_batch_buf[offset];
+		iov[i].iov_len = _tx_batch_packet_len[i];
+		offset += _tx_batch_packet_len[i];
+	}
+
+	int num_packets_sent = 0; // number of packets (from the start) completely sent
+
+	// send all packets to UART
+	if (get_protocol() == Protocol::SERIAL) {
+		ssize_t ret = ::writev(_uart_fd, iov, _tx_batch_num_packets);
+		_tx_syscalls++;
+
+		while (ret > 0 && num_packets_sent < _tx_batch_num_packets
+		       && (size_t)ret >= iov[num_packets_sent].iov_len) {
+			ret -= iov[num_packets_sent++].iov_len;
+		}
+	}
+
+#if defined(MAVLINK_UDP)
+
+	else if (get_protocol() == Protocol::UDP) {
+		// one datagram per packet and destination, as without batching
+		mmsghdr *msgs = _tx_batch_msgs;
+		int8_t *msg_packet = _tx_batch_msg_packet;
+		int num_msgs = 0;
+
+		bool send_to_src = true;
+# if defined(CONFIG_NET)
+		send_to_src = _src_addr_initialized;
+# endif // CONFIG_NET
+
+		bool send_to_bcast = false;
+
+		if ((_mode != MAVLINK_MODE_ONBOARD) && broadcast_enabled() &&
+		    (!get_client_source_initialized() || !is_gcs_connected())) {
+
+			if (!_broadcast_address_found) {
+				find_broadcast_address();
+			}
+
+			send_to_bcast = _broadcast_address_found;
+		}
+
+		for (int i = 0; i < _tx_batch_num_packets; ++i) {
+			if (send_to_src) {
+				msgs[num_msgs].msg_hdr.msg_name = &_src_addr;
+				msgs[num_msgs].msg_hdr.msg_namelen = sizeof(_src_addr);
+				msgs[num_msgs].msg_hdr.msg_iov = &iov[i];
+				msgs[num_msgs].msg_hdr.msg_iovlen = 1;
+				msg_packet[num_msgs++] = i;
+			}
+
+			if (send_to_bcast) {
+				msgs[num_msgs].msg_hdr.msg_name = &_bcast_addr;
+				msgs[num_msgs].msg_hdr.msg_namelen = sizeof(_bcast_addr);
+				msgs[num_msgs].msg_hdr.msg_iov = &iov[i];
+				msgs[num_msgs].msg_hdr.msg_iovlen = 1;
+				msg_packet[num_msgs++] = -1;
+			}
+		}
+
+		for (int i = 0; i < num_msgs; ++i) {
+			msgs[i].msg_len = 0;
+		}
+
+		int num_msgs_sent = 0;
+		int broadcast_errno = 0;
+
+		while (num_msgs_sent < num_msgs) {
+			int ret = sendmmsg(_socket_fd, &msgs[num_msgs_sent], num_msgs - num_msgs_sent, 0);
+			_tx_syscalls++;
+
+			if (ret <= 0) {
+				// sendmmsg() stops at the first datagram that fails: skip it (msg_len stays 0) and
+				// continue with the next one, so that e.g. an unreachable broadcast address does not
+				// drop the following packets to the source address
+				if (msg_packet[num_msgs_sent] < 0) {
+					broadcast_errno = errno;
+				}
+
+				num_msgs_sent++;
+
+			} else {
+				num_msgs_sent += ret;
+			}
+		}
+
+		bool broadcast_failed = false;
+
+		for (int i = 0; i < num_msgs; ++i) {
+			if (msg_packet[i] >= 0) {
+				if (msgs[i].msg_len == iov[msg_packet[i]].iov_len && msg_packet[i] == num_packets_sent) {
+					num_packets_sent++;
+				}
+
+			} else if (msgs[i].msg_len == 0) {
+				broadcast_failed = true;
+			}
+		}
+
+		if (broadcast_failed) {
+			if (!_broadcast_failed_warned) {
+				PX4_ERR("sending broadcast failed, errno: %d: %s", broadcast_errno, strerror(broadcast_errno));
+				_broadcast_failed_warned = true;
+			}
+
+		} else if (send_to_bcast) {
+			_broadcast_failed_warned = false;
+		}
+	}
+
+#endif // MAVLINK_UDP
+
+	for (int i = 0; i < _tx_batch_num_packets; ++i) {
+		if (i < num_packets_sent) {
+			_tstatus.tx_message_count++;
+			count_txbytes(_tx_batch_packet_len[i]);
+
+		} else {
+			count_txerrbytes(_tx_batch_packet_len[i]);
+		}
+	}
+
+	if (num_packets_sent > 0) {
+		_last_write_success_time = _last_write_try_time;
+	}
+
+	_tx_batch_num_packets = 0;
+	_tx_batch_fill = 0;
+}
+#endif // MAVLINK_TX_BATCHING
+
 void Mavlink::send_bytes(const uint8_t *buf, unsigned packet_len)
 {
 	if (!_tx_buffer_low) {
@@ -1849,7 +2013,7 @@ Mavlink::task_main(int argc, char *argv[])
 	int temp_int_arg;
 #endif
 
-	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:fswxzZp", &myoptind, &myoptarg)) != EOF) {
+	while ((ch = px4_getopt(argc, argv, "b:r:d:n:u:o:m:t:c:fswxzZpB", &myoptind, &myoptarg)) != EOF) {
 		switch (ch) {
 		case 'b':
 			if (px4_get_parameter_value(myoptarg, _baudrate) != 0) {
@@ -2061,6 +2225,14 @@ Mavlink::task_main(int argc, char *argv[])
 			_flow_control = FLOW_CONTROL_OFF;
 			break;
 
+		case 'B':
+#if defined(MAVLINK_TX_BATCHING)
+			_tx_batching = true;
+#else
+			PX4_WARN("transmit batching not supported on this platform");
+#endif // MAVLINK_TX_BATCHING
+			break;
+
 		default:
 			err_flag = true;
 			break;
@@ -2241,12 +2413,15 @@ Mavlink::task_main(int argc, char *argv[])
 
 	_task_running.store(true);
 
+	unsigned loop_delay = _main_loop_delay;
+
 	while (!should_exit()) {
 		/* main loop */
-		px4_usleep(_main_loop_delay);
+		px4_usleep(loop_delay);
 
 		if (!should_transmit()) {
 			check_requested_subscriptions();
+			loop_delay = _main_loop_delay;
 			continue;
 		}
 
@@ -2257,6 +2432,15 @@ Mavlink::task_main(int argc, char *argv[])
 
 		update_rate_mult();
 
+		// the stream deadlines are based on the scaled intervals: reschedule all streams if they got shorter
+		if (_rate_mult > _stream_schedule_rate_mult) {
+			for (const auto &stream : _streams) {
+				stream->reset_next_update();
+			}
+		}
+
+		_stream_schedule_rate_mult = _rate_mult;
+
 		// check for parameter updates
 		if (_parameter_update_sub.updated()) {
 			// clear update
@@ -2438,22 +2622,28 @@ Mavlink::task_main(int argc, char *argv[])
 
 		check_requested_subscriptions();
 
-		/* update streams */
+		/* update the streams that are due */
+		hrt_abstime next_stream_update = UINT64_MAX;
+
 		for (const auto &stream : _streams) {
-			stream->update(t);
+			if (t >= stream->next_update()) {
+				stream->update(t);
 
-			if (!_first_heartbeat_sent) {
-				if (_mode == MAVLINK_MODE_IRIDIUM) {
-					if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
-						_first_heartbeat_sent = stream->first_message_sent();
-					}
+				if (!_first_heartbeat_sent) {
+					if (_mode == MAVLINK_MODE_IRIDIUM) {
+						if (stream->get_id() == MAVLINK_MSG_ID_HIGH_LATENCY2) {
+							_first_heartbeat_sent = stream->first_message_sent();
+						}
 
-				} else {
-					if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
-						_first_heartbeat_sent = stream->first_message_sent();
+					} else {
+						if (stream->get_id() == MAVLINK_MSG_ID_HEARTBEAT) {
+							_first_heartbeat_sent = stream->first_message_sent();
+						}
 					}
 				}
 			}
+
+			next_stream_update = math::min(next_stream_update, stream->next_update());
 		}
 
 		/* check for ulog streaming messages */
@@ -2509,6 +2699,8 @@ Mavlink::task_main(int argc, char *argv[])
 		_events.update(t);
 
 		/* pass messages from other instances */
+		bool forwarded = false;
+
 		if (get_forwarding_on()) {
 
 			mavlink_message_t msg;
@@ -2524,9 +2716,21 @@ Mavlink::task_main(int argc, char *argv[])
 
 			if (available_bytes > 0) {
 				resend_message(&msg);
+				forwarded = true;
 			}
 		}
 
+#if defined(MAVLINK_TX_BATCHING)
+
+		/* send the packets of this iteration */
+		if (_tx_batching) {
+			pthread_mutex_lock(&_send_mutex);
+			send_batch();
+			pthread_mutex_unlock(&_send_mutex);
+		}
+
+#endif // MAVLINK_TX_BATCHING
+
 		/* update TX/RX rates*/
 		if (t > _bytes_timestamp + 1_s) {
 			if (_bytes_timestamp != 0) {
@@ -2535,10 +2739,12 @@ Mavlink::task_main(int argc, char *argv[])
 				_tstatus.tx_rate_avg = _bytes_tx / dt;
 				_tstatus.tx_error_rate_avg = _bytes_txerr / dt;
 				_tstatus.rx_rate_avg = _bytes_rx / dt;
+				_tx_syscall_rate_avg = _tx_syscalls / dt;
 
 				_bytes_tx = 0;
 				_bytes_txerr = 0;
 				_bytes_rx = 0;
+				_tx_syscalls = 0;
 			}
 
 			_bytes_timestamp = t;
@@ -2549,6 +2755,19 @@ Mavlink::task_main(int argc, char *argv[])
 			publish_telemetry_status();
 		}
 
+		// Sleep until the next stream is due, but at most MAVLINK_MAX_INTERVAL to keep handling command acks and
+		// events. Forwarding, ulog streaming and the shell only handle a limited amount of data per iteration and
+		// keep the main loop rate while active.
+		loop_delay = _main_loop_delay;
+
+		if (!forwarded && !_mavlink_ulog && !(_mavlink_shell && _mavlink_shell->available() > 0)) {
+			const hrt_abstime now = hrt_absolute_time();
+
+			if (next_stream_update > now + _main_loop_delay) {
+				loop_delay = math::min(next_stream_update - now, (hrt_abstime)MAVLINK_MAX_INTERVAL);
+			}
+		}
+
 		perf_end(_loop_perf);
 	}
 
@@ -2870,6 +3089,11 @@ Mavlink::display_status()
 	printf("\trates:\n");
 	printf("\t  tx: %.1f B/s\n", (double)_tstatus.tx_rate_avg);
 	printf("\t  txerr: %.1f B/s\n", (double)_tstatus.tx_error_rate_avg);
+#if defined(MAVLINK_TX_BATCHING)
+	printf("\t  tx syscalls: %.1f 1/s%s\n", (double)_tx_syscall_rate_avg, _tx_batching ? " (batched)" : "");
+#else
+	printf("\t  tx syscalls: %.1f 1/s\n", (double)_tx_syscall_rate_avg);
+#endif // MAVLINK_TX_BATCHING
 	printf("\t  tx rate mult: %.3f\n", (double)_rate_mult);
 	printf("\t  tx rate max: %i B/s\n", _datarate);
 	printf("\t  rx: %.1f B/s\n", (double)_tstatus.rx_rate_avg);
@@ -3273,6 +3497,7 @@ $ mavlink stream -u 14556 -s HIGHRES_IMU -r 50
 	PRINT_MODULE_USAGE_PARAM_FLAG('x', "Enable FTP", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('z', "Force hardware flow control always on", true);
 	PRINT_MODULE_USAGE_PARAM_FLAG('Z', "Force hardware flow control always off", true);
+	PRINT_MODULE_USAGE_PARAM_FLAG('B', "Send the packets of a loop iteration in one system call (Linux only)", true);
 
 	PRINT_MODULE_USAGE_COMMAND_DESCR("stop-all", "Stop all instances");
 
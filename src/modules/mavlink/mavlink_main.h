@@ -96,6 +96,11 @@
 # define DEFAULT_REMOTE_PORT_UDP 14550 ///< GCS port per MAVLink spec
 #endif // CONFIG_NET || __PX4_POSIX
 
+#if defined(__PX4_LINUX)
+# define MAVLINK_TX_BATCHING ///< sendmmsg() and writev() are available
+# include <sys/uio.h>
+#endif // __PX4_LINUX
+
 enum class Protocol {
 	SERIAL = 0,
 #if defined(MAVLINK_UDP)
@@ -584,6 +589,7 @@ private:
 	int			_baudrate{57600};
 	int			_datarate{1000};		///< data rate for normal streams (attitude, position, etc.)
 	float			_rate_mult{1.0f};
+	float			_stream_schedule_rate_mult{1.0f};	///< rate multiplier of the current stream deadlines
 
 	bool			_radio_status_available{false};
 	bool			_radio_status_critical{false};
@@ -634,6 +640,24 @@ private:
 	uint8_t			_buf[MAVLINK_MAX_PACKET_LEN] {};
 	unsigned		_buf_fill{0};
 
+#if defined(MAVLINK_TX_BATCHING)
+	static constexpr int	TX_BATCH_MAX_PACKETS{64};
+
+	bool			_tx_batching{false}; ///< accumulate the packets and send them once per loop iteration
+	uint8_t			_tx_batch_buf[TX_BATCH_MAX_PACKETS * MAVLINK_MAX_PACKET_LEN] {};
+	uint16_t		_tx_batch_packet_len[TX_BATCH_MAX_PACKETS] {};
+	int			_tx_batch_num_packets{0};
+	unsigned		_tx_batch_fill{0};
+	iovec			_tx_batch_iov[TX_BATCH_MAX_PACKETS] {};
+# if defined(MAVLINK_UDP)
+	mmsghdr			_tx_batch_msgs[2 * TX_BATCH_MAX_PACKETS] {}; ///< one datagram per packet and destination
+	int8_t			_tx_batch_msg_packet[2 * TX_BATCH_MAX_PACKETS] {}; ///< packet index of a datagram, -1 for broadcast
+# endif // MAVLINK_UDP
+#endif // MAVLINK_TX_BATCHING
+
+	unsigned		_tx_syscalls{0}; ///< number of write/send system calls since _bytes_timestamp
+	float			_tx_syscall_rate_avg{0.f};
+
 	bool			_tx_buffer_low{false};
 
 	const char 		*_interface_name{nullptr};
@@ -726,6 +750,14 @@ private:
 	void init_udp();
 #endif // MAVLINK_UDP
 
+#if defined(MAVLINK_TX_BATCHING)
+	/**
+	 * Send the packets accumulated in batching mode: one sendmmsg() (UDP) or writev() (serial) call for all of them.
+	 * Must be called with _send_mutex locked.
+	 */
+	void send_batch();
+#endif // MAVLINK_TX_BATCHING
+
 
 	bool set_channel();
 
@@ -139,7 +139,7 @@ MavlinkMissionManager::load_safepoint_stats()
 /**
  * Publish mission topic to notify navigator about changes.
  */
-void
+int
 MavlinkMissionManager::update_active_mission(dm_item_t dataman_id, uint16_t count, int32_t seq, uint32_t crc32,
 		bool write_to_dataman)
 {
@@ -161,16 +161,37 @@ MavlinkMissionManager::update_active_mission(dm_item_t dataman_id, uint16_t coun
 	mission.land_start_index = _land_start_marker;
 	mission.land_index = _land_marker;
 
+	int ret = PX4_OK;
+
 	if (write_to_dataman) {
 		bool success = _dataman_client.writeSync(DM_KEY_MISSION_STATE, 0, reinterpret_cast<uint8_t *>(&mission),
 				sizeof(mission_s));
 
 		if (!success) {
 			PX4_ERR("Can't update mission state in Dataman");
+			ret = PX4_ERROR;
 		}
 	}
 
 	_offboard_mission_pub.publish(mission);
+	return ret;
+}
+
+int
+MavlinkMissionManager::flush_mission_storage()
+{
+	/* dataman buffers the item writes, an error writing them is only reported by the flush */
+	if (_dataman_client.flushSync()) {
+		return PX4_OK;
+	}
+
+	if (_filesystem_errcount++ < FILESYSTEM_ERRCOUNT_NOTIFY_LIMIT) {
+		_mavlink->send_statustext_critical("Mission storage: Unable to write to microSD\t");
+		events::send(events::ID("mavlink_mission_storage_write_failure4"), events::Log::Critical,
+			     "Mission: Unable to write to storage");
+	}
+
+	return PX4_ERROR;
 }
 
 int
@@ -1198,26 +1219,30 @@ MavlinkMissionManager::handle_mission_item_both(const mavlink_message_t *msg)
 			PX4_DEBUG("WPM: MISSION_ITEM got all %u items, current_seq=%ld, changing state to MAVLINK_WPM_STATE_IDLE",
 				  _transfer_count, _transfer_current_seq);
 
-			ret = 0;
+			/* don't activate the new items if they did not make it to the storage */
+			ret = flush_mission_storage();
 
-			switch (_mission_type) {
-			case MAV_MISSION_TYPE_MISSION:
-				_land_start_marker = _transfer_land_start_marker;
-				_land_marker = _transfer_land_marker;
-				update_active_mission(_transfer_dataman_id, _transfer_count, _transfer_current_seq, _transfer_current_crc32);
-				break;
+			if (ret == PX4_OK) {
+				switch (_mission_type) {
+				case MAV_MISSION_TYPE_MISSION:
+					_land_start_marker = _transfer_land_start_marker;
+					_land_marker = _transfer_land_marker;
+					ret = update_active_mission(_transfer_dataman_id, _transfer_count, _transfer_current_seq,
+								    _transfer_current_crc32);
+					break;
 
-			case MAV_MISSION_TYPE_FENCE:
-				ret = update_geofence_count(_transfer_count, _transfer_current_crc32);
-				break;
+				case MAV_MISSION_TYPE_FENCE:
+					ret = update_geofence_count(_transfer_count, _transfer_current_crc32);
+					break;
 
-			case MAV_MISSION_TYPE_RALLY:
-				ret = update_safepoint_count(_transfer_count, _transfer_current_crc32);
-				break;
+				case MAV_MISSION_TYPE_RALLY:
+					ret = update_safepoint_count(_transfer_count, _transfer_current_crc32);
+					break;
 
-			default:
-				PX4_ERR("mission type %u not handled", _mission_type);
-				break;
+				default:
+					PX4_ERR("mission type %u not handled", _mission_type);
+					break;
+				}
 			}
 
 			// Note: the switch to idle needs to happen after update_geofence_count is called, for proper unlocking order
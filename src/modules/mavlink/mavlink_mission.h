@@ -168,8 +168,11 @@ private:
 
 	void init_offboard_mission(const mission_s &mission_state);
 
-	void update_active_mission(dm_item_t dataman_id, uint16_t count, int32_t seq, uint32_t crc32,
-				   bool write_to_dataman = true);
+	int update_active_mission(dm_item_t dataman_id, uint16_t count, int32_t seq, uint32_t crc32,
+				  bool write_to_dataman = true);
+
+	/** make the uploaded items persistent before the upload is acknowledged */
+	int flush_mission_storage();
 
 	/** store the geofence count to dataman */
 	int update_geofence_count(unsigned count, uint32_t crc32);
@@ -58,6 +58,24 @@ MavlinkStream::update(const hrt_abstime &t)
 {
 	update_data();
 
+	int interval = _interval;
+
+	if (!const_rate()) {
+		interval /= _mavlink->get_rate_mult();
+	}
+
+	const hrt_abstime last_sent = _last_sent;
+
+	const int ret = send_if_due(t, interval);
+
+	schedule_next_update(t, interval, _last_sent != last_sent);
+
+	return ret;
+}
+
+int
+MavlinkStream::send_if_due(const hrt_abstime &t, int interval)
+{
 	// If the message has never been sent before we want
 	// to send it immediately and can return right away
 	if (_last_sent == 0) {
@@ -82,11 +100,6 @@ MavlinkStream::update(const hrt_abstime &t)
 	}
 
 	int64_t dt = t - _last_sent;
-	int interval = _interval;
-
-	if (!const_rate()) {
-		interval /= _mavlink->get_rate_mult();
-	}
 
 	// We don't need to send anything if the inverval is 0. send() will be called manually.
 	if (interval == 0) {
@@ -128,3 +141,42 @@ MavlinkStream::update(const hrt_abstime &t)
 
 	return -1;
 }
+
+void
+MavlinkStream::schedule_next_update(const hrt_abstime &t, int interval, bool sent)
+{
+	if (interval < 0) {
+		// unlimited rate: every iteration while there is data
+		_next_update = sent ? 0 : poll_time(t, 0);
+
+	} else if (interval == 0) {
+		// only sent on request
+		_next_update = update_data_required() ? poll_time(t, 0) : UINT64_MAX;
+
+	} else {
+		// first time at which the send condition in send_if_due() holds
+		const int64_t next_update = (int64_t)_last_sent + interval - (_mavlink->get_main_loop_delay() / 10) * 3 + 1;
+
+		if (!sent && ((_last_sent == 0) || (next_update <= (int64_t)t))) {
+			// due, but send() had no data: poll again after a fraction of the interval instead of at every
+			// iteration, so that streams without data do not keep the main loop at its maximum rate
+			_next_update = (interval > 2 * POLL_INTERVAL_MAX) ? poll_time(t, interval / 4)
+				       : t + math::max(interval / 4, (int)_mavlink->get_main_loop_delay());
+
+		} else {
+			_next_update = next_update;
+		}
+
+		if (update_data_required()) {
+			_next_update = math::min(_next_update, poll_time(t, 0));
+		}
+	}
+}
+
+hrt_abstime
+MavlinkStream::poll_time(const hrt_abstime &t, int delay)
+{
+	// the first multiple of POLL_INTERVAL_MAX after t + delay, so that the streams without data are polled in the
+	// same iteration
+	return ((t + delay) / POLL_INTERVAL_MAX + 1) * POLL_INTERVAL_MAX;
+}
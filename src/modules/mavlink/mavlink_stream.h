@@ -66,7 +66,7 @@ public:
 	 *
 	 * @param interval the interval in microseconds (us) between messages
 	 */
-	void set_interval(const int interval) { _interval = interval; }
+	void set_interval(const int interval) { _interval = interval; _next_update = 0; }
 
 	/**
 	 * Get the interval
@@ -120,7 +120,18 @@ public:
 	 * Reset the time of last sent to 0. Can be used if a message over this
 	 * stream needs to be sent immediately.
 	 */
-	void reset_last_sent() { _last_sent = 0; }
+	void reset_last_sent() { _last_sent = 0; _next_update = 0; }
+
+	/**
+	 * Earliest time at which update() needs to be called again, 0 if it needs to be called at every iteration.
+	 * Calling update() earlier is allowed (it just returns without sending).
+	 */
+	hrt_abstime next_update() const { return _next_update; }
+
+	/**
+	 * Force update() to be called at the next iteration, e.g. after the rate multiplier increased.
+	 */
+	void reset_next_update() { _next_update = 0; }
 
 protected:
 	Mavlink      *const _mavlink;
@@ -132,12 +143,42 @@ protected:
 	 * Function to collect/update data for the streams at a high rate independent of
 	 * actual stream rate.
 	 *
-	 * This function is called at every iteration of the mavlink module.
+	 * This function is called at least every POLL_INTERVAL_MAX if update_data_required() returns true.
 	 */
 	virtual void update_data() { }
 
+	/**
+	 * @return true if update_data() is overridden and needs to be called at least every POLL_INTERVAL_MAX,
+	 * regardless of the stream interval
+	 */
+	virtual bool update_data_required() const { return false; }
+
 private:
+	static constexpr int POLL_INTERVAL_MAX{10000}; ///< [us] polling interval of streams without data
+
+	/**
+	 * Send the message if it is due
+	 * @param interval interval scaled by the rate multiplier
+	 * @return 0 if updated / sent, -1 if unchanged
+	 */
+	int send_if_due(const hrt_abstime &t, int interval);
+
+	/**
+	 * Update the time at which the message is due next
+	 * @param t time of the current update
+	 * @param interval interval scaled by the rate multiplier
+	 * @param sent true if the message was sent by this update
+	 */
+	void schedule_next_update(const hrt_abstime &t, int interval, bool sent);
+
+	/**
+	 * Time to poll a stream without data again
+	 * @param delay minimum delay [us]
+	 */
+	static hrt_abstime poll_time(const hrt_abstime &t, int delay);
+
 	hrt_abstime _last_sent{0};
+	hrt_abstime _next_update{0};
 	bool _first_message_sent{false};
 };
 
@@ -856,6 +856,87 @@ bool MavlinkFtpTest::_removefile_test()
 	return true;
 }
 
+/// @brief Tests writing a file with Write commands that arrive out of order (pipelined writes)
+bool MavlinkFtpTest::_write_test()
+{
+	MavlinkFTP::PayloadHeader		payload {};
+	const MavlinkFTP::PayloadHeader		*reply;
+
+	// 4 packets, written in the order 1, 0, 3, 2
+	static constexpr uint32_t file_size = 3 * MAX_DATA_LEN + 10;
+	static constexpr uint32_t packet_order[] = { 1, 0, 3, 2 };
+	uint8_t bytes[file_size];
+
+	for (uint32_t i = 0; i < file_size; ++i) {
+		bytes[i] = (uint8_t)(i * 7);
+	}
+
+	ut_compare("mkdir failed", ::mkdir(_unittest_microsd_dir, S_IRWXU | S_IRWXG | S_IRWXO), 0);
+
+	payload.opcode = MavlinkFTP::kCmdCreateFile;
+	payload.offset = 0;
+	payload.size = strlen(_unittest_microsd_file) + 1;
+
+	bool success = _send_receive_msg(&payload,		// FTP payload header
+					 (uint8_t *)_unittest_microsd_file,	// Data to start into FTP message payload
+					 payload.size,	// size in bytes of data
+					 &reply);		// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	const uint8_t session = reply->session;
+
+	for (uint32_t packet : packet_order) {
+		payload.opcode = MavlinkFTP::kCmdWriteFile;
+		payload.session = session;
+		payload.offset = packet * MAX_DATA_LEN;
+		payload.size = file_size - payload.offset > MAX_DATA_LEN ? MAX_DATA_LEN : file_size - payload.offset;
+
+		success = _send_receive_msg(&payload,	// FTP payload header
+					    &bytes[payload.offset],	// Data to start into FTP message payload
+					    payload.size,	// size in bytes of data
+					    &reply);	// Payload inside FTP message response
+
+		if (!success) {
+			return false;
+		}
+
+		ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+		ut_compare("Offset incorrect", reply->offset, packet * MAX_DATA_LEN);
+	}
+
+	// the written data must be complete after terminating the session
+	payload.opcode = MavlinkFTP::kCmdTerminateSession;
+	payload.session = session;
+	payload.size = 0;
+
+	success = _send_receive_msg(&payload,	// FTP payload header
+				    nullptr,	// Data to start into FTP message payload
+				    0,		// size in bytes of data
+				    &reply);	// Payload inside FTP message response
+
+	if (!success) {
+		return false;
+	}
+
+	ut_compare("Didn't get Ack back", reply->opcode, MavlinkFTP::kRspAck);
+
+	uint8_t file_bytes[file_size + 1];
+	int fd = ::open(_unittest_microsd_file, O_RDONLY);
+	ut_assert("open failed", fd != -1);
+	int bytes_read = ::read(fd, file_bytes, sizeof(file_bytes));
+	::close(fd);
+
+	ut_compare("File size incorrect", bytes_read, file_size);
+	ut_compare("File contents differ", memcmp(file_bytes, bytes, file_size), 0);
+
+	return true;
+}
+
 /// Static method used as callback from MavlinkFTP for generic use. This method will be called by MavlinkFTP when
 /// it needs to send a message out on Mavlink.
 void MavlinkFtpTest::receive_message_handler_generic(const mavlink_file_transfer_protocol_t *ftp_req, void *worker_data)
@@ -1020,6 +1101,7 @@ bool MavlinkFtpTest::run_tests()
 	ut_run_test(_removedirectory_test);
 	ut_run_test(_createdirectory_test);
 	ut_run_test(_removefile_test);
+	ut_run_test(_write_test);
 
 	return (_tests_failed == 0);
 
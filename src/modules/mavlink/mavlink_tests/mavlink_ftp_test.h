@@ -96,6 +96,7 @@ private:
 	bool _removedirectory_test(void);
 	bool _createdirectory_test(void);
 	bool _removefile_test(void);
+	bool _write_test(void);
 
 	void _receive_message_handler_generic(const mavlink_file_transfer_protocol_t *ftp_req);
 	bool _setup_ftp_msg(const MavlinkFTP::PayloadHeader *payload_header,
@@ -0,0 +1,515 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "GeofenceIndex.hpp"
+
+#include <float.h>
+#include <math.h>
+
+#include <lib/mathlib/mathlib.h>
+
+GeofenceIndex::~GeofenceIndex()
+{
+	freeIndex();
+	delete[] _shapes;
+	delete[] _vertices;
+}
+
+void GeofenceIndex::freeIndex()
+{
+	delete[] _band_start;
+	delete[] _band_edges;
+	delete[] _inclusion_shapes;
+	delete[] _cell_start;
+	delete[] _cell_shapes;
+
+	_band_start = nullptr;
+	_band_edges = nullptr;
+	_inclusion_shapes = nullptr;
+	_cell_start = nullptr;
+	_cell_shapes = nullptr;
+
+	_num_inclusion_shapes = 0;
+	_grid_size_x = 0;
+	_grid_size_y = 0;
+}
+
+bool GeofenceIndex::reset(int max_shapes, int max_vertices)
+{
+	freeIndex();
+
+	_num_shapes = 0;
+	_num_vertices = 0;
+	_projection = MapProjection{};
+
+	max_shapes = math::constrain(max_shapes, 0, (int)UINT16_MAX);
+	max_vertices = math::max(max_vertices, 0);
+
+	if (max_shapes != _max_shapes) {
+		delete[] _shapes;
+		_shapes = (max_shapes > 0) ? new Shape[max_shapes] : nullptr;
+		_max_shapes = (_shapes != nullptr) ? max_shapes : 0;
+	}
+
+	if ((uint32_t)max_vertices != _max_vertices) {
+		delete[] _vertices;
+		_vertices = (max_vertices > 0) ? new Vertex[max_vertices] : nullptr;
+		_max_vertices = (_vertices != nullptr) ? max_vertices : 0;
+	}
+
+	return (_max_shapes == max_shapes) && (_max_vertices == (uint32_t)max_vertices);
+}
+
+bool GeofenceIndex::addShape(ShapeType type, float circle_radius)
+{
+	if (_num_shapes >= _max_shapes) {
+		return false;
+	}
+
+	Shape &shape = _shapes[_num_shapes++];
+	shape = {};
+	shape.type = type;
+	shape.enabled = true;
+	shape.first_vertex = _num_vertices;
+	shape.circle_radius = circle_radius;
+
+	return true;
+}
+
+bool GeofenceIndex::addVertex(double lat, double lon)
+{
+	if (_num_shapes == 0 || _num_vertices >= _max_vertices) {
+		return false;
+	}
+
+	Shape &shape = _shapes[_num_shapes - 1];
+
+	if ((isCircle(shape.type) && shape.vertex_count > 0) || shape.vertex_count >= UINT16_MAX) {
+		return false;
+	}
+
+	if (!_projection.isInitialized()) {
+		_projection.initReference(lat, lon);
+	}
+
+	Vertex &vertex = _vertices[_num_vertices++];
+	_projection.project(lat, lon, vertex.x, vertex.y);
+	shape.vertex_count++;
+
+	return true;
+}
+
+void GeofenceIndex::invalidateShape()
+{
+	if (_num_shapes > 0) {
+		Shape &shape = _shapes[_num_shapes - 1];
+		_num_vertices = shape.first_vertex;
+		shape.vertex_count = 0;
+	}
+}
+
+void GeofenceIndex::computeBounds(Shape &shape) const
+{
+	shape.min_x = FLT_MAX;
+	shape.min_y = FLT_MAX;
+	shape.max_x = -FLT_MAX;
+	shape.max_y = -FLT_MAX;
+
+	for (uint32_t i = shape.first_vertex; i < shape.first_vertex + shape.vertex_count; ++i) {
+		shape.min_x = math::min(shape.min_x, _vertices[i].x);
+		shape.min_y = math::min(shape.min_y, _vertices[i].y);
+		shape.max_x = math::max(shape.max_x, _vertices[i].x);
+		shape.max_y = math::max(shape.max_y, _vertices[i].y);
+	}
+
+	if (isCircle(shape.type) && shape.vertex_count > 0) {
+		shape.min_x -= shape.circle_radius;
+		shape.min_y -= shape.circle_radius;
+		shape.max_x += shape.circle_radius;
+		shape.max_y += shape.circle_radius;
+	}
+}
+
+int GeofenceIndex::band(const Shape &shape, float y) const
+{
+	// monotonic in y: an edge straddling y is always stored in the band of y
+	return math::constrain((int)((y - shape.min_y) * shape.band_scale), 0, shape.num_bands - 1);
+}
+
+uint32_t GeofenceIndex::countBandEntries(Shape &shape, int num_bands) const
+{
+	const float height = shape.max_y - shape.min_y;
+	shape.num_bands = num_bands;
+	shape.band_scale = (height > FLT_EPSILON) ? num_bands / height : 0.f;
+
+	uint32_t count = 0;
+
+	for (uint32_t i = 0, j = shape.vertex_count - 1; i < shape.vertex_count; j = i++) {
+		const Vertex &vertex_i = _vertices[shape.first_vertex + i];
+		const Vertex &vertex_j = _vertices[shape.first_vertex + j];
+		count += band(shape, math::max(vertex_i.y, vertex_j.y)) - band(shape, math::min(vertex_i.y, vertex_j.y)) + 1;
+	}
+
+	return count;
+}
+
+void GeofenceIndex::fillBands(const Shape &shape)
+{
+	uint32_t *start = &_band_start[shape.first_band];
+
+	// count the edges per band (start[b + 1]), turn into start indices, then use start[b] as insert position
+	for (int b = 1; b <= shape.num_bands; ++b) {
+		start[b] = 0;
+	}
+
+	for (uint32_t i = 0, j = shape.vertex_count - 1; i < shape.vertex_count; j = i++) {
+		const Vertex &vertex_i = _vertices[shape.first_vertex + i];
+		const Vertex &vertex_j = _vertices[shape.first_vertex + j];
+		const int band_max = band(shape, math::max(vertex_i.y, vertex_j.y));
+
+		for (int b = band(shape, math::min(vertex_i.y, vertex_j.y)); b <= band_max; ++b) {
+			start[b + 1]++;
+		}
+	}
+
+	for (int b = 1; b <= shape.num_bands; ++b) {
+		start[b] += start[b - 1];
+	}
+
+	const uint32_t first = start[0];
+
+	for (uint32_t i = 0, j = shape.vertex_count - 1; i < shape.vertex_count; j = i++) {
+		const Vertex &vertex_i = _vertices[shape.first_vertex + i];
+		const Vertex &vertex_j = _vertices[shape.first_vertex + j];
+		const int band_max = band(shape, math::max(vertex_i.y, vertex_j.y));
+
+		for (int b = band(shape, math::min(vertex_i.y, vertex_j.y)); b <= band_max; ++b) {
+			_band_edges[start[b]++] = i;
+		}
+	}
+
+	// start[b] is now the end of band b
+	for (int b = shape.num_bands; b > 0; --b) {
+		start[b] = start[b - 1];
+	}
+
+	start[0] = first;
+}
+
+void GeofenceIndex::cell(float x, float y, int &cell_x, int &cell_y) const
+{
+	cell_x = math::constrain((int)((x - _grid_min_x) * _grid_scale_x), 0, _grid_size_x - 1);
+	cell_y = math::constrain((int)((y - _grid_min_y) * _grid_scale_y), 0, _grid_size_y - 1);
+}
+
+uint32_t GeofenceIndex::countCellEntries() const
+{
+	uint32_t count = 0;
+
+	for (int s = 0; s < _num_shapes; ++s) {
+		const Shape &shape = _shapes[s];
+
+		if (!isInclusion(shape.type) && shape.vertex_count > 0) {
+			int x0, y0, x1, y1;
+			cell(shape.min_x, shape.min_y, x0, y0);
+			cell(shape.max_x, shape.max_y, x1, y1);
+			count += (x1 - x0 + 1) * (y1 - y0 + 1);
+		}
+	}
+
+	return count;
+}
+
+void GeofenceIndex::fillCells()
+{
+	const int num_cells = _grid_size_x * _grid_size_y;
+
+	for (int c = 0; c <= num_cells; ++c) {
+		_cell_start[c] = 0;
+	}
+
+	for (int pass = 0; pass < 2; ++pass) {
+		for (int s = 0; s < _num_shapes; ++s) {
+			const Shape &shape = _shapes[s];
+
+			if (isInclusion(shape.type) || shape.vertex_count == 0) {
+				continue;
+			}
+
+			int x0, y0, x1, y1;
+			cell(shape.min_x, shape.min_y, x0, y0);
+			cell(shape.max_x, shape.max_y, x1, y1);
+
+			for (int cell_x = x0; cell_x <= x1; ++cell_x) {
+				for (int cell_y = y0; cell_y <= y1; ++cell_y) {
+					const int c = cell_x * _grid_size_y + cell_y;
+
+					if (pass == 0) {
+						_cell_start[c + 1]++;
+
+					} else {
+						_cell_shapes[_cell_start[c]++] = s;
+					}
+				}
+			}
+		}
+
+		if (pass == 0) {
+			for (int c = 1; c <= num_cells; ++c) {
+				_cell_start[c] += _cell_start[c - 1];
+			}
+		}
+	}
+
+	// _cell_start[c] is now the end of cell c
+	for (int c = num_cells; c > 0; --c) {
+		_cell_start[c] = _cell_start[c - 1];
+	}
+
+	_cell_start[0] = 0;
+}
+
+bool GeofenceIndex::build()
+{
+	freeIndex();
+
+	// polygon edge bands, with about 2 edges per band and a bounded number of entries
+	uint32_t num_bands = 0;
+	uint32_t num_band_entries = 0;
+	int num_inclusion_shapes = 0;
+	int num_exclusion_shapes = 0;
+
+	for (int s = 0; s < _num_shapes; ++s) {
+		Shape &shape = _shapes[s];
+		computeBounds(shape);
+		shape.first_band = num_bands;
+		shape.num_bands = 0;
+
+		if (isInclusion(shape.type)) {
+			num_inclusion_shapes++;
+
+		} else if (shape.vertex_count > 0) {
+			num_exclusion_shapes++;
+		}
+
+		if (!isCircle(shape.type) && shape.vertex_count > 0) {
+			int bands = math::constrain((int)shape.vertex_count / 2, 1, kMaxBands);
+			uint32_t count = countBandEntries(shape, bands);
+
+			while (bands > 1 && count > kMaxEntriesPerItem * shape.vertex_count) {
+				bands /= 2;
+				count = countBandEntries(shape, bands);
+			}
+
+			num_bands += bands;
+			num_band_entries += count;
+		}
+	}
+
+	if (num_bands > 0) {
+		_band_start = new uint32_t[num_bands + 1];
+		_band_edges = new uint16_t[num_band_entries];
+
+		if (_band_start == nullptr || _band_edges == nullptr) {
+			freeIndex();
+			return false;
+		}
+
+		_band_start[0] = 0;
+
+		for (int s = 0; s < _num_shapes; ++s) {
+			if (_shapes[s].num_bands > 0) {
+				fillBands(_shapes[s]);
+			}
+		}
+	}
+
+	// the inclusion shapes are checked for every point
+	if (num_inclusion_shapes > 0) {
+		_inclusion_shapes = new uint16_t[num_inclusion_shapes];
+
+		if (_inclusion_shapes == nullptr) {
+			freeIndex();
+			return false;
+		}
+
+		for (int s = 0; s < _num_shapes; ++s) {
+			if (isInclusion(_shapes[s].type)) {
+				_inclusion_shapes[_num_inclusion_shapes++] = s;
+			}
+		}
+	}
+
+	// grid of the exclusion shapes, with about one shape per cell
+	if (num_exclusion_shapes > 0) {
+		_grid_min_x = FLT_MAX;
+		_grid_min_y = FLT_MAX;
+		_grid_max_x = -FLT_MAX;
+		_grid_max_y = -FLT_MAX;
+
+		for (int s = 0; s < _num_shapes; ++s) {
+			const Shape &shape = _shapes[s];
+
+			if (!isInclusion(shape.type) && shape.vertex_count > 0) {
+				_grid_min_x = math::min(_grid_min_x, shape.min_x);
+				_grid_min_y = math::min(_grid_min_y, shape.min_y);
+				_grid_max_x = math::max(_grid_max_x, shape.max_x);
+				_grid_max_y = math::max(_grid_max_y, shape.max_y);
+			}
+		}
+
+		const float width = math::max(_grid_max_x - _grid_min_x, 1.f);
+		const float height = math::max(_grid_max_y - _grid_min_y, 1.f);
+
+		_grid_size_x = math::constrain((int)ceilf(sqrtf(num_exclusion_shapes * width / height)), 1, kMaxGridSize);
+		_grid_size_y = math::constrain((num_exclusion_shapes + _grid_size_x - 1) / _grid_size_x, 1, kMaxGridSize);
+
+		uint32_t count = 0;
+
+		for (;;) {
+			_grid_scale_x = _grid_size_x / width;
+			_grid_scale_y = _grid_size_y / height;
+			count = countCellEntries();
+
+			if ((_grid_size_x == 1 && _grid_size_y == 1)
+			    || count <= kMaxEntriesPerItem * num_exclusion_shapes + _grid_size_x * _grid_size_y) {
+				break;
+			}
+
+			_grid_size_x = math::max(_grid_size_x / 2, 1);
+			_grid_size_y = math::max(_grid_size_y / 2, 1);
+		}
+
+		_cell_start = new uint32_t[_grid_size_x * _grid_size_y + 1];
+		_cell_shapes = new uint16_t[count];
+
+		if (_cell_start == nullptr || _cell_shapes == nullptr) {
+			freeIndex();
+			return false;
+		}
+
+		fillCells();
+	}
+
+	return true;
+}
+
+bool GeofenceIndex::contains(const Shape &shape, float x, float y) const
+{
+	if (x < shape.min_x || x > shape.max_x || y < shape.min_y || y > shape.max_y) {
+		return false;
+	}
+
+	if (isCircle(shape.type)) {
+		const Vertex &center = _vertices[shape.first_vertex];
+		const float dx = x - center.x;
+		const float dy = y - center.y;
+		return dx * dx + dy * dy < shape.circle_radius * shape.circle_radius;
+	}
+
+	/**
+	 * Adaptation of algorithm originally presented as
+	 * PNPOLY - Point Inclusion in Polygon Test
+	 * W. Randolph Franklin (WRF)
+	 * Only supports non-complex polygons (not self intersecting)
+	 * Only the edges of the band of the point can cross the ray along x.
+	 */
+	const Vertex *vertices = &_vertices[shape.first_vertex];
+	const int b = shape.first_band + band(shape, y);
+	bool c = false;
+
+	for (uint32_t k = _band_start[b]; k < _band_start[b + 1]; ++k) {
+		const uint32_t i = _band_edges[k];
+		const uint32_t j = (i == 0) ? shape.vertex_count - 1 : i - 1;
+
+		if ((vertices[i].y >= y) != (vertices[j].y >= y) &&
+		    (x <= (vertices[j].x - vertices[i].x) * (y - vertices[i].y) / (vertices[j].y - vertices[i].y)
+		     + vertices[i].x)) {
+			c = !c;
+		}
+	}
+
+	return c;
+}
+
+bool GeofenceIndex::checkShape(int shape, double lat, double lon) const
+{
+	if (shape < 0 || shape >= _num_shapes) {
+		return true;
+	}
+
+	// without any vertex there is no reference, but then no shape contains a point anyway
+	float x = 0.f;
+	float y = 0.f;
+
+	if (_projection.isInitialized()) {
+		_projection.project(lat, lon, x, y);
+	}
+
+	const bool inside = contains(_shapes[shape], x, y);
+	return isInclusion(_shapes[shape].type) ? inside : !inside;
+}
+
+bool GeofenceIndex::check(double lat, double lon) const
+{
+	float x = 0.f;
+	float y = 0.f;
+
+	if (_projection.isInitialized()) {
+		_projection.project(lat, lon, x, y);
+	}
+
+	for (int i = 0; i < _num_inclusion_shapes; ++i) {
+		const Shape &shape = _shapes[_inclusion_shapes[i]];
+
+		if (shape.enabled && !contains(shape, x, y)) {
+			return false;
+		}
+	}
+
+	if (_grid_size_x > 0 && x >= _grid_min_x && x <= _grid_max_x && y >= _grid_min_y && y <= _grid_max_y) {
+		int cell_x, cell_y;
+		cell(x, y, cell_x, cell_y);
+		const int c = cell_x * _grid_size_y + cell_y;
+
+		for (uint32_t k = _cell_start[c]; k < _cell_start[c + 1]; ++k) {
+			const Shape &shape = _shapes[_cell_shapes[k]];
+
+			if (shape.enabled && contains(shape, x, y)) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
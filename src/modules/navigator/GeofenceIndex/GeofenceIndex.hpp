@@ -0,0 +1,193 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/**
+ * @file GeofenceIndex.hpp
+ *
+ * In-memory geofence polygons and circles with a spatial index.
+ *
+ * The vertices are projected to local coordinates [m] once when the fence is loaded. Every shape has a bounding box,
+ * the edges of every polygon are sorted into bands along the y axis (east), so the ray casting test only considers
+ * the edges close to the point, and the exclusion shapes are sorted into a uniform grid of buckets.
+ * Queries do not allocate memory.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <lib/geo/geo.h>
+
+class GeofenceIndex
+{
+public:
+	enum class ShapeType : uint8_t {
+		PolygonInclusion,
+		PolygonExclusion,
+		CircleInclusion,
+		CircleExclusion
+	};
+
+	GeofenceIndex() = default;
+	~GeofenceIndex();
+
+	GeofenceIndex(const GeofenceIndex &) = delete;
+	GeofenceIndex &operator=(const GeofenceIndex &) = delete;
+
+	/**
+	 * Clear the fence and allocate the storage for a new one.
+	 * @return false if the allocation failed
+	 */
+	bool reset(int max_shapes, int max_vertices);
+
+	/**
+	 * Add a shape, its vertices (or the circle center) are added with addVertex().
+	 * @return false if the storage is full
+	 */
+	bool addShape(ShapeType type, float circle_radius = 0.f);
+
+	/**
+	 * Add a vertex to the last shape. The first vertex of the fence is used as projection reference.
+	 * @return false if the storage is full
+	 */
+	bool addVertex(double lat, double lon);
+
+	/**
+	 * Remove the vertices of the last shape, e.g. if one of them cannot be used. A shape without vertices never
+	 * contains a point.
+	 */
+	void invalidateShape();
+
+	/**
+	 * Build the spatial index, must be called after adding all shapes and before the checks.
+	 * @return false if the allocation failed
+	 */
+	bool build();
+
+	/**
+	 * Exclude a shape from check(), e.g. if it does not contain Home.
+	 */
+	void disableShape(int shape) { _shapes[shape].enabled = false; }
+
+	/**
+	 * Check a point against a single shape (enabled or not).
+	 * @return true if the point is inside an inclusion or outside an exclusion shape
+	 */
+	bool checkShape(int shape, double lat, double lon) const;
+
+	/**
+	 * Check a point against all enabled shapes.
+	 * @return true if the point is inside all inclusion and outside all exclusion shapes
+	 */
+	bool check(double lat, double lon) const;
+
+	int numShapes() const { return _num_shapes; }
+	bool shapeEnabled(int shape) const { return _shapes[shape].enabled; }
+	ShapeType shapeType(int shape) const { return _shapes[shape].type; }
+	int shapeVertexCount(int shape) const { return _shapes[shape].vertex_count; }
+
+	static bool isInclusion(ShapeType type)
+	{
+		return type == ShapeType::PolygonInclusion || type == ShapeType::CircleInclusion;
+	}
+
+	static bool isCircle(ShapeType type)
+	{
+		return type == ShapeType::CircleInclusion || type == ShapeType::CircleExclusion;
+	}
+
+private:
+	struct Vertex {
+		float x; ///< north [m]
+		float y; ///< east [m]
+	};
+
+	struct Shape {
+		ShapeType type;
+		bool enabled;
+		uint16_t num_bands;
+		uint32_t first_vertex;
+		uint32_t vertex_count;
+		uint32_t first_band; ///< index of the first band in _band_start
+		float circle_radius;
+		float band_scale; ///< bands per meter along y
+		float min_x, min_y, max_x, max_y; ///< bounding box
+	};
+
+	static constexpr int kMaxBands = 256; ///< maximum number of edge bands per polygon
+	static constexpr int kMaxGridSize = 128; ///< maximum number of grid cells along an axis
+	static constexpr uint32_t kMaxEntriesPerItem = 8; ///< bound of the band/cell entries per edge/shape
+
+	bool contains(const Shape &shape, float x, float y) const;
+
+	void computeBounds(Shape &shape) const;
+	int band(const Shape &shape, float y) const;
+	uint32_t countBandEntries(Shape &shape, int num_bands) const;
+	void fillBands(const Shape &shape);
+
+	void cell(float x, float y, int &cell_x, int &cell_y) const;
+	uint32_t countCellEntries() const;
+	void fillCells();
+
+	void freeIndex();
+
+	MapProjection _projection{};
+
+	Shape *_shapes{nullptr};
+	Vertex *_vertices{nullptr};
+	int _max_shapes{0};
+	uint32_t _max_vertices{0};
+	int _num_shapes{0};
+	uint32_t _num_vertices{0};
+
+	// polygon edge bands: the edges of band b of a shape are _band_edges[_band_start[first_band + b] ...
+	// _band_start[first_band + b + 1]), stored as vertex index i (within the polygon) of the edge (i - 1, i)
+	uint32_t *_band_start{nullptr};
+	uint16_t *_band_edges{nullptr};
+
+	// shapes to check for every point
+	uint16_t *_inclusion_shapes{nullptr};
+	int _num_inclusion_shapes{0};
+
+	// grid of the exclusion shapes: cell (i, j) contains the shapes whose bounding box overlaps the cell
+	uint32_t *_cell_start{nullptr};
+	uint16_t *_cell_shapes{nullptr};
+	int _grid_size_x{0};
+	int _grid_size_y{0};
+	float _grid_min_x{0.f};
+	float _grid_min_y{0.f};
+	float _grid_max_x{-1.f};
+	float _grid_max_y{-1.f};
+	float _grid_scale_x{0.f};
+	float _grid_scale_y{0.f};
+};
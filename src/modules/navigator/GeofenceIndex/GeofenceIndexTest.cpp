@@ -0,0 +1,337 @@
+/****************************************************************************
+ *
+ *   Copyright (c) 2024 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <lib/mathlib/mathlib.h>
+
+#include "GeofenceIndex.hpp"
+
+using ShapeType = GeofenceIndex::ShapeType;
+
+static constexpr double kLat0 = 47.3977;
+static constexpr double kLon0 = 8.5456;
+
+// local [m] to global, around (kLat0, kLon0)
+static void toGlobal(float x, float y, double &lat, double &lon)
+{
+	MapProjection projection{kLat0, kLon0};
+	projection.reproject(x, y, lat, lon);
+}
+
+static void addLocalShape(GeofenceIndex &index, ShapeType type, const std::vector<std::pair<float, float>> &vertices,
+			  float circle_radius = 0.f)
+{
+	ASSERT_TRUE(index.addShape(type, circle_radius));
+
+	for (const auto &vertex : vertices) {
+		double lat, lon;
+		toGlobal(vertex.first, vertex.second, lat, lon);
+		ASSERT_TRUE(index.addVertex(lat, lon));
+	}
+}
+
+static bool checkLocal(const GeofenceIndex &index, float x, float y)
+{
+	double lat, lon;
+	toGlobal(x, y, lat, lon);
+	return index.check(lat, lon);
+}
+
+// star shaped (non self-intersecting) polygon with random radii
+static std::vector<std::pair<float, float>> randomPolygon(std::mt19937 &gen, float center_x, float center_y,
+		float radius, int vertex_count)
+{
+	std::uniform_real_distribution<float> radius_scale(0.3f, 1.f);
+	std::vector<std::pair<float, float>> vertices;
+
+	for (int i = 0; i < vertex_count; ++i) {
+		const float angle = 2.f * M_PI_F * i / vertex_count;
+		const float r = radius * radius_scale(gen);
+		vertices.emplace_back(center_x + r * cosf(angle), center_y + r * sinf(angle));
+	}
+
+	return vertices;
+}
+
+/**
+ * Reference: every shape checked with all its edges (as the dataman based implementation), using the same projection
+ */
+class BruteForceGeofence
+{
+public:
+	void add(ShapeType type, const std::vector<std::pair<float, float>> &vertices, float circle_radius = 0.f)
+	{
+		Shape shape{type, circle_radius, {}};
+
+		for (const auto &vertex : vertices) {
+			double lat, lon;
+			toGlobal(vertex.first, vertex.second, lat, lon);
+
+			if (!_projection.isInitialized()) {
+				_projection.initReference(lat, lon);
+			}
+
+			float x, y;
+			_projection.project(lat, lon, x, y);
+			shape.vertices.emplace_back(x, y);
+		}
+
+		_shapes.push_back(shape);
+	}
+
+	bool check(double lat, double lon) const
+	{
+		float x, y;
+		_projection.project(lat, lon, x, y);
+		bool pass = true;
+
+		for (const Shape &shape : _shapes) {
+			const bool inside = contains(shape, x, y);
+			pass &= GeofenceIndex::isInclusion(shape.type) ? inside : !inside;
+		}
+
+		return pass;
+	}
+
+private:
+	struct Shape {
+		ShapeType type;
+		float circle_radius;
+		std::vector<std::pair<float, float>> vertices;
+	};
+
+	static bool contains(const Shape &shape, float x, float y)
+	{
+		const auto &v = shape.vertices;
+
+		if (GeofenceIndex::isCircle(shape.type)) {
+			const float dx = x - v[0].first;
+			const float dy = y - v[0].second;
+			return dx * dx + dy * dy < shape.circle_radius * shape.circle_radius;
+		}
+
+		bool c = false;
+
+		for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+			if ((v[i].second >= y) != (v[j].second >= y) &&
+			    (x <= (v[j].first - v[i].first) * (y - v[i].second) / (v[j].second - v[i].second) + v[i].first)) {
+				c = !c;
+			}
+		}
+
+		return c;
+	}
+
+	MapProjection _projection{};
+	std::vector<Shape> _shapes;
+};
+
+TEST(GeofenceIndexTest, emptyFence)
+{
+	GeofenceIndex index;
+	ASSERT_TRUE(index.reset(0, 0));
+	ASSERT_TRUE(index.build());
+	EXPECT_EQ(index.numShapes(), 0);
+	EXPECT_TRUE(checkLocal(index, 0.f, 0.f));
+}
+
+TEST(GeofenceIndexTest, inclusionPolygon)
+{
+	// GIVEN: a concave (U shaped) inclusion polygon
+	GeofenceIndex index;
+	ASSERT_TRUE(index.reset(1, 8));
+	addLocalShape(index, ShapeType::PolygonInclusion, {
+		{0.f, 0.f}, {0.f, 300.f}, {300.f, 300.f}, {300.f, 200.f}, {100.f, 200.f}, {100.f, 100.f}, {300.f, 100.f}, {300.f, 0.f}
+	});
+	ASSERT_TRUE(index.build());
+
+	// THEN: only points inside the polygon pass
+	EXPECT_TRUE(checkLocal(index, 50.f, 150.f));
+	EXPECT_TRUE(checkLocal(index, 200.f, 50.f));
+	EXPECT_TRUE(checkLocal(index, 200.f, 250.f));
+	EXPECT_FALSE(checkLocal(index, 200.f, 150.f)); // in the notch
+	EXPECT_FALSE(checkLocal(index, -50.f, 150.f));
+	EXPECT_FALSE(checkLocal(index, 50.f, 350.f));
+	EXPECT_FALSE(checkLocal(index, 5000.f, 5000.f));
+}
+
+TEST(GeofenceIndexTest, exclusionShapes)
+{
+	// GIVEN: an exclusion polygon and an exclusion circle
+	GeofenceIndex index;
+	ASSERT_TRUE(index.reset(2, 5));
+	addLocalShape(index, ShapeType::PolygonExclusion, {{0.f, 0.f}, {0.f, 100.f}, {100.f, 100.f}, {100.f, 0.f}});
+	addLocalShape(index, ShapeType::CircleExclusion, {{500.f, 500.f}}, 50.f);
+	ASSERT_TRUE(index.build());
+
+	// THEN: points inside any of them fail
+	EXPECT_FALSE(checkLocal(index, 50.f, 50.f));
+	EXPECT_FALSE(checkLocal(index, 530.f, 470.f));
+	EXPECT_TRUE(checkLocal(index, 150.f, 50.f));
+	EXPECT_TRUE(checkLocal(index, 540.f, 540.f));
+	EXPECT_TRUE(checkLocal(index, 300.f, 300.f));
+	EXPECT_TRUE(checkLocal(index, -1000.f, 0.f));
+
+	// WHEN: the circle is disabled
+	index.disableShape(1);
+
+	// THEN: it is ignored by the fence check, but still checked on its own
+	EXPECT_TRUE(checkLocal(index, 530.f, 470.f));
+	double lat, lon;
+	toGlobal(530.f, 470.f, lat, lon);
+	EXPECT_FALSE(index.checkShape(1, lat, lon));
+}
+
+TEST(GeofenceIndexTest, invalidShape)
+{
+	// GIVEN: an inclusion polygon without usable vertices
+	GeofenceIndex index;
+	ASSERT_TRUE(index.reset(2, 4));
+	addLocalShape(index, ShapeType::PolygonInclusion, {{0.f, 0.f}, {0.f, 100.f}, {100.f, 100.f}, {100.f, 0.f}});
+	index.invalidateShape();
+	ASSERT_TRUE(index.build());
+
+	// THEN: it never contains a point
+	EXPECT_EQ(index.shapeVertexCount(0), 0);
+	EXPECT_FALSE(checkLocal(index, 50.f, 50.f));
+}
+
+TEST(GeofenceIndexTest, storageLimits)
+{
+	GeofenceIndex index;
+	ASSERT_TRUE(index.reset(1, 3));
+	EXPECT_FALSE(index.addVertex(kLat0, kLon0)); // no shape
+	EXPECT_TRUE(index.addShape(ShapeType::PolygonInclusion));
+	EXPECT_FALSE(index.addShape(ShapeType::PolygonExclusion));
+	EXPECT_TRUE(index.addVertex(kLat0, kLon0));
+	EXPECT_TRUE(index.addVertex(kLat0 + 0.001, kLon0));
+	EXPECT_TRUE(index.addVertex(kLat0, kLon0 + 0.001));
+	EXPECT_FALSE(index.addVertex(kLat0 + 0.001, kLon0 + 0.001));
+}
+
+TEST(GeofenceIndexTest, denseNoFlyZones)
+{
+	// GIVEN: a 200 vertex inclusion polygon containing thousands of small exclusion polygons and circles
+	// (survey area of 20 km x 20 km)
+	std::mt19937 gen(42);
+	std::uniform_real_distribution<float> position(-9000.f, 9000.f);
+	std::uniform_int_distribution<int> vertex_count(3, 40);
+
+	static constexpr int kNumPolygons = 3000;
+	static constexpr int kNumCircles = 500;
+	static constexpr int kMaxVertices = 200 + kNumPolygons * 40 + kNumCircles;
+
+	GeofenceIndex index;
+	BruteForceGeofence reference;
+	ASSERT_TRUE(index.reset(1 + kNumPolygons + kNumCircles, kMaxVertices));
+
+	const auto inclusion = randomPolygon(gen, 0.f, 0.f, 14000.f, 200);
+	addLocalShape(index, ShapeType::PolygonInclusion, inclusion);
+	reference.add(ShapeType::PolygonInclusion, inclusion);
+	int num_vertices = inclusion.size();
+
+	for (int i = 0; i < kNumPolygons; ++i) {
+		const auto polygon = randomPolygon(gen, position(gen), position(gen), 150.f, vertex_count(gen));
+		addLocalShape(index, ShapeType::PolygonExclusion, polygon);
+		reference.add(ShapeType::PolygonExclusion, polygon);
+		num_vertices += polygon.size();
+	}
+
+	for (int i = 0; i < kNumCircles; ++i) {
+		const std::vector<std::pair<float, float>> center{{position(gen), position(gen)}};
+		addLocalShape(index, ShapeType::CircleExclusion, center, 100.f);
+		reference.add(ShapeType::CircleExclusion, center, 100.f);
+		num_vertices++;
+	}
+
+	const auto build_start = std::chrono::steady_clock::now();
+	ASSERT_TRUE(index.build());
+	const auto build_end = std::chrono::steady_clock::now();
+
+	std::vector<std::pair<double, double>> points;
+	std::uniform_real_distribution<float> point_position(-12000.f, 12000.f);
+
+	for (int i = 0; i < 5000; ++i) {
+		double lat, lon;
+		toGlobal(point_position(gen), point_position(gen), lat, lon);
+		points.emplace_back(lat, lon);
+	}
+
+	// WHEN: checking random points
+	// THEN: the index gives the same result as checking all edges
+	int num_inside = 0;
+	int num_mismatch = 0;
+
+	const auto reference_start = std::chrono::steady_clock::now();
+
+	for (const auto &point : points) {
+		num_inside += reference.check(point.first, point.second);
+	}
+
+	const auto reference_end = std::chrono::steady_clock::now();
+
+	int num_inside_index = 0;
+	static constexpr int kRepetitions = 20;
+
+	const auto index_start = std::chrono::steady_clock::now();
+
+	for (int r = 0; r < kRepetitions; ++r) {
+		for (const auto &point : points) {
+			num_inside_index += index.check(point.first, point.second);
+		}
+	}
+
+	const auto index_end = std::chrono::steady_clock::now();
+
+	for (const auto &point : points) {
+		num_mismatch += index.check(point.first, point.second) != reference.check(point.first, point.second);
+	}
+
+	EXPECT_EQ(num_mismatch, 0);
+	EXPECT_EQ(num_inside_index, kRepetitions * num_inside);
+	EXPECT_GT(num_inside, 0);
+	EXPECT_LT(num_inside, (int)points.size());
+
+	const double reference_ns = std::chrono::duration<double, std::nano>(reference_end - reference_start).count()
+				    / points.size();
+	const double index_ns = std::chrono::duration<double, std::nano>(index_end - index_start).count()
+				/ (points.size() * kRepetitions);
+	printf("%d shapes, %d vertices: build %.1f ms, check %.0f ns (all edges: %.0f ns)\n",
+	       index.numShapes(), num_vertices,
+	       std::chrono::duration<double, std::milli>(build_end - build_start).count(), index_ns, reference_ns);
+}
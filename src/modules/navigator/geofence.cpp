@@ -85,9 +85,6 @@ Geofence::Geofence(Navigator *navigator) :
 
 Geofence::~Geofence()
 {
-	if (_polygons) {
-		delete[](_polygons);
-	}
 }
 
 void Geofence::run()
@@ -183,10 +180,16 @@ void Geofence::updateFence()
 void Geofence::_updateFence()
 {
 	mission_fence_point_s mission_fence_point;
-	bool is_circle_area = false;
 
-	// iterate over all polygons and store their starting vertices
+	// load all polygons and circles into the fence index once, the checks then do not need dataman anymore
 	_num_polygons = 0;
+
+	if (!_fence_index.reset(_dataman_cache.size(), _dataman_cache.size())) {
+		_fence_index.reset(0, 0);
+		PX4_ERR("alloc failed");
+		return;
+	}
+
 	int current_seq = 1;
 
 	while (current_seq <= _dataman_cache.size()) {
@@ -208,81 +211,118 @@ void Geofence::_updateFence()
 
 		case NAV_CMD_FENCE_CIRCLE_INCLUSION:
 		case NAV_CMD_FENCE_CIRCLE_EXCLUSION:
-			is_circle_area = true;
-
-		/* FALLTHROUGH */
 		case NAV_CMD_FENCE_POLYGON_VERTEX_EXCLUSION:
 		case NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION:
-			if (!is_circle_area && mission_fence_point.vertex_count == 0) {
-				++current_seq; // avoid endless loop
-				PX4_ERR("Polygon with 0 vertices. Skipping");
+			current_seq += addPolygonCircle(current_seq, mission_fence_point);
+			break;
 
-			} else {
-				if (_polygons) {
-					// resize: this is somewhat inefficient, but we do not expect there to be many polygons
-					PolygonInfo *new_polygons = new PolygonInfo[_num_polygons + 1];
+		default:
+			PX4_ERR("unhandled Fence command: %i", (int)mission_fence_point.nav_cmd);
+			++current_seq;
+			break;
+		}
+	}
 
-					if (new_polygons) {
-						memcpy(new_polygons, _polygons, sizeof(PolygonInfo) * _num_polygons);
-					}
+	if (!_fence_index.build()) {
+		_fence_index.reset(0, 0);
+		PX4_ERR("alloc failed");
+		return;
+	}
 
-					delete[](_polygons);
-					_polygons = new_polygons;
+	for (int polygon = 0; polygon < _fence_index.numShapes(); ++polygon) {
+		// check if requiremetns for Home location are met
+		const bool home_check_okay = checkHomeRequirementsForGeofence(polygon);
 
-				} else {
-					_polygons = new PolygonInfo[1];
-				}
+		// check if current position is inside the fence and vehicle is armed
+		const bool current_position_check_okay = checkCurrentPositionRequirementsForGeofence(polygon);
 
-				if (!_polygons) {
-					_num_polygons = 0;
-					PX4_ERR("alloc failed");
-					return;
-				}
+		// discard the polygon if at least one check fails
+		if (home_check_okay && current_position_check_okay) {
+			++_num_polygons;
 
-				PolygonInfo &polygon = _polygons[_num_polygons];
-				polygon.dataman_index = current_seq;
-				polygon.fence_type = mission_fence_point.nav_cmd;
+		} else {
+			_fence_index.disableShape(polygon);
+		}
+	}
 
-				if (is_circle_area) {
-					polygon.circle_radius = mission_fence_point.circle_radius;
-					current_seq += 1;
+	// the fence points are not needed anymore, they are reloaded when the fence changes
+	_dataman_cache.resize(0);
+}
 
-				} else {
-					polygon.vertex_count = mission_fence_point.vertex_count;
-					current_seq += mission_fence_point.vertex_count;
-				}
+int Geofence::addPolygonCircle(int seq, const mission_fence_point_s &first_fence_point)
+{
+	GeofenceIndex::ShapeType type;
+	float circle_radius = 0.f;
+	int num_items = 1;
+
+	switch (first_fence_point.nav_cmd) {
+	case NAV_CMD_FENCE_CIRCLE_INCLUSION:
+		type = GeofenceIndex::ShapeType::CircleInclusion;
+		circle_radius = first_fence_point.circle_radius;
+		break;
 
-				// check if requiremetns for Home location are met
-				const bool home_check_okay = checkHomeRequirementsForGeofence(polygon);
+	case NAV_CMD_FENCE_CIRCLE_EXCLUSION:
+		type = GeofenceIndex::ShapeType::CircleExclusion;
+		circle_radius = first_fence_point.circle_radius;
+		break;
 
-				// check if current position is inside the fence and vehicle is armed
-				const bool current_position_check_okay = checkCurrentPositionRequirementsForGeofence(polygon);
+	case NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION:
+		type = GeofenceIndex::ShapeType::PolygonInclusion;
+		num_items = first_fence_point.vertex_count;
+		break;
 
-				// discard the polygon if at least one check fails by not incrementing the counter in that case
-				if (home_check_okay && current_position_check_okay) {
-					++_num_polygons;
+	default:
+		type = GeofenceIndex::ShapeType::PolygonExclusion;
+		num_items = first_fence_point.vertex_count;
+		break;
+	}
 
-				}
-			}
+	if (num_items == 0) {
+		PX4_ERR("Polygon with 0 vertices. Skipping");
+		return 1; // avoid endless loop
+	}
 
+	if (!_fence_index.addShape(type, circle_radius)) {
+		PX4_ERR("Too many fence shapes, seq: %i skipped", seq);
+		return num_items;
+	}
+
+	mission_fence_point_s fence_point = first_fence_point;
+
+	for (int i = 0; i < num_items; ++i) {
+		if (i > 0 && !_dataman_cache.loadWait(DM_KEY_FENCE_POINTS, seq + i, reinterpret_cast<uint8_t *>(&fence_point),
+						      sizeof(mission_fence_point_s))) {
+			PX4_ERR("loadWait failed, seq: %i", seq + i);
+			_fence_index.invalidateShape();
 			break;
+		}
 
-		default:
-			PX4_ERR("unhandled Fence command: %i", (int)mission_fence_point.nav_cmd);
-			++current_seq;
+		if (fence_point.frame != NAV_FRAME_GLOBAL && fence_point.frame != NAV_FRAME_GLOBAL_INT
+		    && fence_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
+		    && fence_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
+			// TODO: handle different frames
+			PX4_ERR("Frame type %i not supported", (int)fence_point.frame);
+			_fence_index.invalidateShape();
+			break;
+		}
+
+		if (!_fence_index.addVertex(fence_point.lat, fence_point.lon)) {
+			PX4_ERR("Too many fence vertices, seq: %i", seq + i);
+			_fence_index.invalidateShape();
 			break;
 		}
 	}
+
+	return num_items;
 }
 
-bool Geofence::checkHomeRequirementsForGeofence(const PolygonInfo &polygon)
+bool Geofence::checkHomeRequirementsForGeofence(int polygon)
 {
 	bool checks_pass = true;
 
 	if (_navigator->home_global_position_valid()) {
-		checks_pass = checkPointAgainstPolygonCircle(polygon, _navigator->get_home_position()->lat,
-				_navigator->get_home_position()->lon,
-				_navigator->get_home_position()->alt);
+		checks_pass = _fence_index.checkShape(polygon, _navigator->get_home_position()->lat,
+						      _navigator->get_home_position()->lon);
 	}
 
 
@@ -295,14 +335,14 @@ bool Geofence::checkHomeRequirementsForGeofence(const PolygonInfo &polygon)
 	return checks_pass;
 }
 
-bool Geofence::checkCurrentPositionRequirementsForGeofence(const PolygonInfo &polygon)
+bool Geofence::checkCurrentPositionRequirementsForGeofence(int polygon)
 {
 	bool checks_pass = true;
 
 	// do not allow upload of geofence if vehicle is flying and current geofence would be immediately violated
 	if (getGeofenceAction() != geofence_result_s::GF_ACTION_NONE && !_navigator->get_land_detected()->landed) {
-		checks_pass = checkPointAgainstPolygonCircle(polygon, _navigator->get_global_position()->lat,
-				_navigator->get_global_position()->lon, _navigator->get_global_position()->alt);
+		checks_pass = _fence_index.checkShape(polygon, _navigator->get_global_position()->lat,
+						      _navigator->get_global_position()->lon);
 	}
 
 	if (!checks_pass) {
@@ -367,112 +407,8 @@ bool Geofence::isInsidePolygonOrCircle(double lat, double lon, float altitude)
 		}
 	}
 
-	/* Horizontal check: iterate all polygons & circles */
-	bool checksPass = true;
-
-	for (int polygon_index = 0; polygon_index < _num_polygons; ++polygon_index) {
-		checksPass &= checkPointAgainstPolygonCircle(_polygons[polygon_index], lat, lon, altitude);
-	}
-
-	return checksPass;
-}
-
-bool Geofence::checkPointAgainstPolygonCircle(const PolygonInfo &polygon, double lat, double lon, float altitude)
-{
-	bool checksPass = true;
-
-	if (polygon.fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION) {
-		checksPass &= insideCircle(polygon, lat, lon, altitude);
-
-	} else if (polygon.fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION) {
-		checksPass &= !insideCircle(polygon, lat, lon, altitude);
-
-	} else if (polygon.fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION) {
-		checksPass &= insidePolygon(polygon, lat, lon, altitude);
-
-	} else if (polygon.fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_EXCLUSION) {
-		checksPass &= !insidePolygon(polygon, lat, lon, altitude);
-	}
-
-	return checksPass;
-}
-
-bool Geofence::insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude)
-{
-	/**
-	 * Adaptation of algorithm originally presented as
-	 * PNPOLY - Point Inclusion in Polygon Test
-	 * W. Randolph Franklin (WRF)
-	 * Only supports non-complex polygons (not self intersecting)
-	 */
-
-	mission_fence_point_s temp_vertex_i{};
-	mission_fence_point_s temp_vertex_j{};
-	bool c = false;
-
-	for (unsigned i = 0, j = polygon.vertex_count - 1; i < polygon.vertex_count; j = i++) {
-
-		bool success = _dataman_cache.loadWait(DM_KEY_FENCE_POINTS, polygon.dataman_index + i,
-						       reinterpret_cast<uint8_t *>(&temp_vertex_i), sizeof(mission_fence_point_s));
-
-		if (!success) {
-			break;
-		}
-
-		success = _dataman_cache.loadWait(DM_KEY_FENCE_POINTS, polygon.dataman_index + j,
-						  reinterpret_cast<uint8_t *>(&temp_vertex_j), sizeof(mission_fence_point_s));
-
-		if (!success) {
-			break;
-		}
-
-		if (temp_vertex_i.frame != NAV_FRAME_GLOBAL && temp_vertex_i.frame != NAV_FRAME_GLOBAL_INT
-		    && temp_vertex_i.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
-		    && temp_vertex_i.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-			// TODO: handle different frames
-			PX4_ERR("Frame type %i not supported", (int)temp_vertex_i.frame);
-			break;
-		}
-
-		if (((double)temp_vertex_i.lon >= lon) != ((double)temp_vertex_j.lon >= lon) &&
-		    (lat <= (double)(temp_vertex_j.lat - temp_vertex_i.lat) * (lon - (double)temp_vertex_i.lon) /
-		     (double)(temp_vertex_j.lon - temp_vertex_i.lon) + (double)temp_vertex_i.lat)) {
-			c = !c;
-		}
-	}
-
-	return c;
-}
-
-bool Geofence::insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude)
-{
-
-	mission_fence_point_s circle_point{};
-	bool success = _dataman_cache.loadWait(DM_KEY_FENCE_POINTS, polygon.dataman_index,
-					       reinterpret_cast<uint8_t *>(&circle_point), sizeof(mission_fence_point_s));
-
-	if (!success) {
-		PX4_ERR("dm_read failed");
-		return false;
-	}
-
-	if (circle_point.frame != NAV_FRAME_GLOBAL && circle_point.frame != NAV_FRAME_GLOBAL_INT
-	    && circle_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT
-	    && circle_point.frame != NAV_FRAME_GLOBAL_RELATIVE_ALT_INT) {
-		// TODO: handle different frames
-		PX4_ERR("Frame type %i not supported", (int)circle_point.frame);
-		return false;
-	}
-
-	if (!_projection_reference.isInitialized()) {
-		_projection_reference.initReference(lat, lon);
-	}
-
-	float x1, y1, x2, y2;
-	_projection_reference.project(lat, lon, x1, y1);
-	_projection_reference.project(circle_point.lat, circle_point.lon, x2, y2);
-	float dx = x1 - x2, dy = y1 - y2;
-	return dx * dx + dy * dy < circle_point.circle_radius * circle_point.circle_radius;
+	/* Horizontal check: all polygons & circles */
+	return _fence_index.check(lat, lon);
 }
 
 bool
@@ -643,23 +579,29 @@ void Geofence::printStatus()
 	int num_inclusion_polygons = 0, num_exclusion_polygons = 0, total_num_vertices = 0;
 	int num_inclusion_circles = 0, num_exclusion_circles = 0;
 
-	for (int i = 0; i < _num_polygons; ++i) {
-		total_num_vertices += _polygons[i].vertex_count;
+	for (int i = 0; i < _fence_index.numShapes(); ++i) {
+		if (!_fence_index.shapeEnabled(i)) {
+			continue;
+		}
 
-		if (_polygons[i].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_INCLUSION) {
+		switch (_fence_index.shapeType(i)) {
+		case GeofenceIndex::ShapeType::PolygonInclusion:
+			total_num_vertices += _fence_index.shapeVertexCount(i);
 			++num_inclusion_polygons;
-		}
+			break;
 
-		if (_polygons[i].fence_type == NAV_CMD_FENCE_POLYGON_VERTEX_EXCLUSION) {
+		case GeofenceIndex::ShapeType::PolygonExclusion:
+			total_num_vertices += _fence_index.shapeVertexCount(i);
 			++num_exclusion_polygons;
-		}
+			break;
 
-		if (_polygons[i].fence_type == NAV_CMD_FENCE_CIRCLE_INCLUSION) {
+		case GeofenceIndex::ShapeType::CircleInclusion:
 			++num_inclusion_circles;
-		}
+			break;
 
-		if (_polygons[i].fence_type == NAV_CMD_FENCE_CIRCLE_EXCLUSION) {
+		case GeofenceIndex::ShapeType::CircleExclusion:
 			++num_exclusion_circles;
+			break;
 		}
 	}
 
@@ -53,6 +53,8 @@
 #include <uORB/topics/vehicle_global_position.h>
 #include <uORB/topics/sensor_gps.h>
 
+#include "GeofenceIndex/GeofenceIndex.hpp"
+
 #define GEOFENCE_FILENAME PX4_STORAGEDIR"/etc/geofence.txt"
 
 class Navigator;
@@ -158,17 +160,7 @@ private:
 		Error
 	};
 
-	struct PolygonInfo {
-		uint16_t fence_type; ///< one of MAV_CMD_NAV_FENCE_* (can also be a circular region)
-		uint16_t dataman_index;
-		union {
-			uint16_t vertex_count;
-			float circle_radius;
-		};
-	};
-
 	Navigator   *_navigator{nullptr};
-	PolygonInfo *_polygons{nullptr};
 
 	mission_stats_entry_s _stats;
 	DatamanState _dataman_state{DatamanState::UpdateRequestWait};
@@ -179,9 +171,9 @@ private:
 	float _altitude_min{0.0f};
 	float _altitude_max{0.0f};
 
-	int _num_polygons{0};
+	int _num_polygons{0}; ///< number of enabled polygons and circles
 
-	MapProjection _projection_reference{}; ///< class to convert (lon, lat) to local [m]
+	GeofenceIndex _fence_index{}; ///< polygons and circles, loaded from dataman
 
 	uint32_t _opaque_id{0}; ///< dataman geofence id: if it does not match, the polygon data was updated
 	bool _fence_updated{true};  ///< flag indicating if fence are updated to dataman cache
@@ -194,36 +186,22 @@ private:
 
 
 	/**
-	 * Check if a single point is within a polygon
-	 * @return true if within polygon
-	 */
-	bool insidePolygon(const PolygonInfo &polygon, double lat, double lon, float altitude);
-
-	/**
-	 * Check if a single point is within a circle
-	 * @param polygon must be a circle!
-	 * @return true if within polygon the circle
-	 */
-	bool insideCircle(const PolygonInfo &polygon, double lat, double lon, float altitude);
-
-	/**
-	 * Check if a single point is within a polygon or circle
-	 * @return true if within polygon or circle
+	 * Add a polygon or circle starting at the dataman item seq to the fence index
+	 * @return the number of dataman items used
 	 */
-
-	bool checkPointAgainstPolygonCircle(const PolygonInfo &polygon, double lat, double lon, float altitude);
+	int addPolygonCircle(int seq, const mission_fence_point_s &first_fence_point);
 
 	/**
 	 * Check polygon or circle geofence fullfills the requirements relative to Home.
 	 * @return true if checks pass
 	 */
-	bool checkHomeRequirementsForGeofence(const PolygonInfo &polygon);
+	bool checkHomeRequirementsForGeofence(int polygon);
 
 	/**
 	 * Check polygon or circle geofence fullfills the requirements relative to the current vehicle position.
 	 * @return true if checks pass
 	 */
-	bool checkCurrentPositionRequirementsForGeofence(const PolygonInfo &polygon);
+	bool checkCurrentPositionRequirementsForGeofence(int polygon);
 
 	DEFINE_PARAMETERS(
 		(ParamInt<px4::params::GF_ACTION>)         _param_gf_action,
@@ -49,17 +49,20 @@
 #include <lib/parameters/param.h>
 #include <uORB/uORBMessageFields.hpp>
 
+#include <chrono>
 #include <cstring>
 #include <float.h>
 #include <fstream>
 #include <iostream>
 #include <math.h>
+#include <queue>
 #include <time.h>
 #include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string>
 
+#include <logger/delta_encoder.h>
 #include <logger/messages.h>
 
 #include "Replay.hpp"
@@ -336,7 +339,14 @@ Replay::readFlagBits(std::ifstream &file, uint16_t msg_size)
 	bool contains_appended_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK;
 	bool has_unknown_incompat_bits = false;
 
-	if (incompat_flags[0] & ~0x1) {
+	if (incompat_flags[0] & ULOG_INCOMPAT_FLAG0_COMPRESSED_MASK) {
+		PX4_ERR("Log is compressed, decompress it first (Tools/ulog_decompress.py)");
+		return false;
+	}
+
+	_delta_data = incompat_flags[0] & ULOG_INCOMPAT_FLAG0_DELTA_DATA_MASK;
+
+	if (incompat_flags[0] & ~(ULOG_INCOMPAT_FLAG0_DATA_APPENDED_MASK | ULOG_INCOMPAT_FLAG0_DELTA_DATA_MASK)) {
 		has_unknown_incompat_bits = true;
 	}
 
@@ -418,25 +428,15 @@ string Replay::getOrbFields(const orb_metadata *meta)
 	return format;
 }
 
-bool
-Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
+void
+Replay::addSubscription(uint64_t message_pos)
 {
+	const uint16_t msg_size = _ulog_index.header(message_pos).msg_size;
 	_read_buffer.reserve(msg_size + 1);
 	uint8_t *message = _read_buffer.data();
-	streampos this_message_pos = file.tellg() - (streamoff)ULOG_MSG_HEADER_LEN;
-	file.read((char *)message, msg_size);
+	memcpy(message, _ulog_index.payload(message_pos), msg_size);
 	message[msg_size] = 0;
 
-	if (!file) {
-		return false;
-	}
-
-	if (file.tellg() <= _subscription_file_pos) { //already read this subscription
-		return true;
-	}
-
-	_subscription_file_pos = file.tellg();
-
 	uint8_t multi_id = *(uint8_t *)message;
 	uint16_t msg_id = ((uint16_t)message[1]) | (((uint16_t)message[2]) << 8);
 	string topic_name((char *)message + 3);
@@ -444,7 +444,7 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 
 	if (!orb_meta) {
 		PX4_WARN("Topic %s not found internally. Will ignore it", topic_name.c_str());
-		return true;
+		return;
 	}
 
 	CompatBase *compat = nullptr;
@@ -520,7 +520,7 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 				}
 			}
 
-			return true; // not a fatal error
+			return; // not a fatal error
 		}
 	}
 
@@ -535,30 +535,25 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 
 	if (!timestamp_found) {
 		delete subscription;
-		return true;
+		return;
 	}
 
 	if (field_size != 8) {
 		PX4_ERR("Unsupported timestamp with size %i, ignoring the topic %s", field_size, orb_meta->o_name);
 		delete subscription;
-		return true;
+		return;
 	}
 
 	//find first data message (and the timestamp)
-	streampos cur_pos = file.tellg();
-	subscription->next_read_pos = this_message_pos; //this will be skipped
-
-	if (!nextDataMessage(file, *subscription, msg_id)) {
-		delete subscription;
-		return false;
-	}
-
-	file.seekg(cur_pos);
+	const std::vector<uint64_t> &data_messages = _ulog_index.dataMessages(msg_id);
+	subscription->next_index = std::upper_bound(data_messages.begin(), data_messages.end(), message_pos)
+				   - data_messages.begin();
+	nextDataMessage(*subscription, msg_id);
 
 	if (!subscription->orb_meta) {
 		//no message found. This is not a fatal error
 		delete subscription;
-		return true;
+		return;
 	}
 
 	PX4_DEBUG("adding subscription for %s (msg_id %i)", subscription->orb_meta->o_name, msg_id);
@@ -572,7 +567,6 @@ Replay::readAndAddSubscription(std::ifstream &file, uint16_t msg_size)
 
 	onSubscriptionAdded(*_subscriptions[msg_id], msg_id);
 
-	return true;
 }
 
 bool
@@ -606,37 +600,30 @@ Replay::findFieldOffset(const string &format, const string &field_name, int &off
 	return false;
 }
 
-bool
-Replay::readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position)
+void
+Replay::handleAdditionalMessages(uint64_t end_position)
 {
-	ulog_message_header_s message_header;
+	const std::vector<uint64_t> &additional_messages = _ulog_index.additionalMessages();
 
-	while (file.tellg() < end_position) {
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	while (_next_additional_message < additional_messages.size()
+	       && additional_messages[_next_additional_message] < end_position) {
 
-		if (!file) {
-			return false;
-		}
+		const uint64_t message_pos = additional_messages[_next_additional_message++];
+		const ulog_message_header_s message_header = _ulog_index.header(message_pos);
 
 		switch (message_header.msg_type) {
 		case (int)ULogMessageType::PARAMETER:
-			if (!readAndApplyParameter(file, message_header.msg_size)) {
-				return false;
-			}
-
+			applyParameter(_ulog_index.payload(message_pos), message_header.msg_size);
 			break;
 
 		case (int)ULogMessageType::DROPOUT:
-			readDropout(file, message_header.msg_size);
+			handleDropout(_ulog_index.payload(message_pos), message_header.msg_size);
 			break;
 
-		default: //skip all others
-			file.seekg(message_header.msg_size, ios::cur);
+		default:
 			break;
 		}
 	}
-
-	return true;
 }
 
 bool
@@ -650,7 +637,18 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 		return false;
 	}
 
+	return applyParameter(message, msg_size);
+}
+
+bool
+Replay::applyParameter(const uint8_t *message, uint16_t msg_size)
+{
 	uint8_t key_len = message[0];
+
+	if (key_len + 1 > msg_size) {
+		return false;
+	}
+
 	string key((char *)message + 1, key_len);
 
 	size_t pos = key.find(' ');
@@ -682,100 +680,62 @@ Replay::readAndApplyParameter(std::ifstream &file, uint16_t msg_size)
 	return true;
 }
 
-bool
-Replay::readDropout(std::ifstream &file, uint16_t msg_size)
+void
+Replay::handleDropout(const uint8_t *message, uint16_t msg_size)
 {
-	uint16_t duration;
-	file.read((char *)&duration, sizeof(duration));
+	uint16_t duration = 0;
+
+	if (msg_size >= sizeof(duration)) {
+		memcpy(&duration, message, sizeof(duration));
+	}
 
 	PX4_ERR("Dropout in replayed log, %i ms", (int)duration);
-	return file.good();
 }
 
-bool
-Replay::nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id)
+void
+Replay::nextDataMessage(Subscription &subscription, int msg_id)
 {
-	ulog_message_header_s message_header;
-	file.seekg(subscription.next_read_pos);
-	//ignore the first message (it's data we already read)
-	file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-	if (file) {
-		file.seekg(message_header.msg_size, ios::cur);
-	}
-
-	uint16_t file_msg_id;
-	bool done = false;
-
-	while (file && !done) {
-		streampos cur_pos = file.tellg();
-		file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
-
-		if (!file) {
-			break;
-		}
+	const std::vector<uint64_t> &data_messages = _ulog_index.dataMessages(msg_id);
+
+	while (subscription.next_index < data_messages.size()) {
+		const uint64_t message_pos = data_messages[subscription.next_index++];
+		const ulog_message_header_s message_header = _ulog_index.header(message_pos);
+		const uint8_t *data = _ulog_index.payload(message_pos) + 2; //skip msg id
+		const int data_size = subscription.orb_meta->o_size_no_padding;
+
+		if (message_header.msg_type == (uint8_t)ULogMessageType::DATA_DELTA) {
+			// decode with respect to the previous message of the subscription
+			if (subscription.data.empty() || message_header.msg_size < 2 ||
+			    !logger::DeltaEncoder::decode(data, message_header.msg_size - 2, subscription.data.data(), data_size)) {
+				PX4_ERR("cannot decode delta encoded data message %s. Skipping", subscription.orb_meta->o_name);
+				subscription.data.clear(); // wait for the next full data message
+				continue;
+			}
 
-		if (((streamoff)cur_pos) + ULOG_MSG_HEADER_LEN + message_header.msg_size > _read_until_file_position) {
-			file.setstate(std::ios::eofbit);
-			break;
-		}
+			subscription.next_read_pos = message_pos;
+			memcpy(&subscription.next_timestamp, subscription.data.data() + subscription.timestamp_offset,
+			       sizeof(subscription.next_timestamp));
+			return;
 
-		switch (message_header.msg_type) {
-		case (int)ULogMessageType::ADD_LOGGED_MSG:
-			readAndAddSubscription(file, message_header.msg_size);
-			break;
-
-		case (int)ULogMessageType::DATA:
-			file.read((char *)&file_msg_id, sizeof(file_msg_id));
-
-			if (file) {
-				if (msg_id == file_msg_id) {
-					if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
-						subscription.next_read_pos = cur_pos;
-						file.seekg(subscription.timestamp_offset, ios::cur);
-						file.read((char *)&subscription.next_timestamp, sizeof(subscription.next_timestamp));
-						done = true;
-
-					} else { //sanity check failed!
-						PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
-							subscription.orb_meta->o_name, message_header.msg_size,
-							subscription.orb_meta->o_size_no_padding + 2);
-						file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-					}
-
-				} else { //not the one we are looking for
-					file.seekg(message_header.msg_size - sizeof(file_msg_id), ios::cur);
-				}
+		} else if (message_header.msg_size == subscription.orb_meta->o_size_no_padding + 2) {
+			if (_delta_data) {
+				subscription.data.assign(data, data + data_size);
 			}
 
-			break;
-
-		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
-		case (int)ULogMessageType::PARAMETER:
-		case (int)ULogMessageType::DROPOUT:
-		case (int)ULogMessageType::INFO:
-		case (int)ULogMessageType::INFO_MULTIPLE:
-		case (int)ULogMessageType::SYNC:
-		case (int)ULogMessageType::LOGGING:
-		case (int)ULogMessageType::PARAMETER_DEFAULT:
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+			subscription.next_read_pos = message_pos;
+			memcpy(&subscription.next_timestamp, data + subscription.timestamp_offset,
+			       sizeof(subscription.next_timestamp));
+			return;
 
-		default:
-			//this really should not happen
-			PX4_ERR("unknown log message type %i, size %i (offset %i)",
-				(int)message_header.msg_type, (int)message_header.msg_size, (int)file.tellg());
-			file.seekg(message_header.msg_size, ios::cur);
-			break;
+		} else { //sanity check failed!
+			PX4_ERR("data message %s has wrong size %i (expected %i). Skipping",
+				subscription.orb_meta->o_name, message_header.msg_size,
+				subscription.orb_meta->o_size_no_padding + 2);
 		}
 	}
 
-	if (file.eof()) { //no more data messages for this subscription
-		subscription.orb_meta = nullptr;
-		file.clear();
-	}
-
-	return file.good();
+	//no more data messages for this subscription
+	subscription.orb_meta = nullptr;
 }
 
 const orb_metadata *
@@ -891,6 +851,51 @@ Replay::run()
 		return;
 	}
 
+	replay_file.close();
+
+	// the data section is read from the indexed memory mapping of the file
+	const auto index_start = chrono::steady_clock::now();
+
+	if (!_ulog_index.open(_replay_file)) {
+		PX4_ERR("Failed to map the log file");
+		return;
+	}
+
+	uint64_t data_start = _data_section_start;
+	std::vector<uint64_t> subscriptions_before_start;
+	const char *start_time_str = getenv(replay::ENV_START);
+
+	if (start_time_str) {
+		// start at the last sync point before the given time, using the seek index appended by the logger
+		const uint64_t start_time = _file_start_time + (uint64_t)(atof(start_time_str) * 1.e6);
+		uint64_t sync_timestamp = 0;
+		uint64_t sync_offset = 0;
+
+		if (_ulog_index.readSeekIndex(_read_until_file_position)) {
+			sync_offset = _ulog_index.seek(start_time, sync_timestamp);
+
+		} else {
+			PX4_WARN("Log has no seek index, replaying from the start");
+		}
+
+		if (sync_offset > _data_section_start) {
+			PX4_INFO("Starting replay at t=%.3lf s (file offset %llu)", (double)(sync_timestamp - _file_start_time) / 1.e6,
+				 (unsigned long long)sync_offset);
+			subscriptions_before_start = _ulog_index.subscriptionsBefore(sync_offset);
+			data_start = sync_offset;
+			_file_start_time = sync_timestamp;
+		}
+	}
+
+	if (!_ulog_index.build(data_start, _read_until_file_position)) {
+		PX4_ERR("Failed to index the data section");
+		return;
+	}
+
+	PX4_INFO("Indexed %llu messages (%.1f MB) in %.3lf s", (unsigned long long)_ulog_index.numMessages(),
+		 (double)_ulog_index.size() / 1.e6,
+		 chrono::duration<double>(chrono::steady_clock::now() - index_start).count());
+
 	_speed_factor = 1.f;
 	const char *speedup = getenv("PX4_SIM_SPEED_FACTOR");
 
@@ -904,62 +909,52 @@ Replay::run()
 
 	PX4_INFO("Replay in progress...");
 
-	ulog_message_header_s message_header;
-	replay_file.seekg(_data_section_start);
-
-	//we know the next message must be an ADD_LOGGED_MSG
-	replay_file.read((char *)&message_header, ULOG_MSG_HEADER_LEN);
+	for (uint64_t message_pos : subscriptions_before_start) {
+		addSubscription(message_pos);
+	}
 
-	if (!readAndAddSubscription(replay_file, message_header.msg_size)) {
-		PX4_ERR("Failed to read subscription");
-		return;
+	for (uint64_t message_pos : _ulog_index.subscriptions()) {
+		addSubscription(message_pos);
 	}
 
 	const uint64_t timestamp_offset = getTimestampOffset();
 	uint32_t nr_published_messages = 0;
-	streampos last_additional_message_pos = _data_section_start;
-
-	while (!should_exit() && replay_file) {
+	const auto replay_start = chrono::steady_clock::now();
 
-		//Find the next message to publish. Messages from different subscriptions don't need
-		//to be in chronological order, so we need to check all subscriptions
-		uint64_t next_file_time = 0;
-		int next_msg_id = -1;
-		bool first_time = true;
+	//Find the next message to publish. Messages from different subscriptions don't need
+	//to be in chronological order, so we keep the next message of each subscription in a heap.
+	using NextMessage = std::pair<uint64_t, uint16_t>; ///< file timestamp, msg_id
+	std::priority_queue<NextMessage, std::vector<NextMessage>, std::greater<NextMessage>> next_messages;
 
-		for (size_t i = 0; i < _subscriptions.size(); ++i) {
-			const Subscription *subscription = _subscriptions[i];
-
-			if (!subscription) {
-				continue;
-			}
+	for (size_t i = 0; i < _subscriptions.size(); ++i) {
+		const Subscription *subscription = _subscriptions[i];
 
-			if (subscription->orb_meta && !subscription->ignored) {
-				if (first_time || subscription->next_timestamp < next_file_time) {
-					first_time = false;
-					next_msg_id = (int)i;
-					next_file_time = subscription->next_timestamp;
-				}
-			}
+		if (subscription && subscription->orb_meta && !subscription->ignored) {
+			next_messages.emplace(subscription->next_timestamp, (uint16_t)i);
 		}
+	}
 
-		if (next_msg_id == -1) {
-			break; //no active subscription anymore. We're done.
-		}
+	while (!should_exit() && !next_messages.empty()) {
+
+		const uint64_t next_file_time = next_messages.top().first;
+		const uint16_t next_msg_id = next_messages.top().second;
+		next_messages.pop();
 
 		Subscription &sub = *_subscriptions[next_msg_id];
 
 		if (next_file_time == 0 || next_file_time < _file_start_time) {
 			//someone didn't set the timestamp properly. Consider the message invalid
-			nextDataMessage(replay_file, sub, next_msg_id);
+			nextDataMessage(sub, next_msg_id);
+
+			if (sub.orb_meta) {
+				next_messages.emplace(sub.next_timestamp, next_msg_id);
+			}
+
 			continue;
 		}
 
 		//handle additional messages between last and next published data
-		replay_file.seekg(last_additional_message_pos);
-		streampos next_additional_message_pos = sub.next_read_pos;
-		readAndHandleAdditionalMessages(replay_file, next_additional_message_pos);
-		last_additional_message_pos = next_additional_message_pos;
+		handleAdditionalMessages(sub.next_read_pos);
 
 		// Perform scheduled parameter changes
 		while (_next_param_change < _dynamic_parameter_schedule.size() &&
@@ -975,14 +970,18 @@ Replay::run()
 		const uint64_t publish_timestamp = handleTopicDelay(next_file_time, timestamp_offset);
 
 		// It's time to publish
-		readTopicDataToBuffer(sub, replay_file);
+		readTopicDataToBuffer(sub);
 		memcpy(_read_buffer.data() + sub.timestamp_offset, &publish_timestamp, sizeof(uint64_t)); //adjust the timestamp
 
-		if (handleTopicUpdate(sub, _read_buffer.data(), replay_file)) {
+		if (handleTopicUpdate(sub, _read_buffer.data())) {
 			++nr_published_messages;
 		}
 
-		nextDataMessage(replay_file, sub, next_msg_id);
+		nextDataMessage(sub, next_msg_id);
+
+		if (sub.orb_meta) {
+			next_messages.emplace(sub.next_timestamp, next_msg_id);
+		}
 
 		// TODO: output status (eg. every sec), including total duration...
 	}
@@ -1004,14 +1003,17 @@ Replay::run()
 	}
 
 	if (!should_exit()) {
-		PX4_INFO("Replay done (published %u msgs, %.3lf s)", nr_published_messages,
-			 (double)hrt_elapsed_time(&_replay_start_time) / 1.e6);
+		const double replay_duration = chrono::duration<double>(chrono::steady_clock::now() - replay_start).count();
+		PX4_INFO("Replay done (published %u msgs, %.3lf s, %.0lf msgs/s)", nr_published_messages,
+			 (double)hrt_elapsed_time(&_replay_start_time) / 1.e6,
+			 replay_duration > 0. ? nr_published_messages / replay_duration : 0.);
 	}
 
 	onExitMainLoop();
 
+	_ulog_index.close();
+
 	if (!should_exit()) {
-		replay_file.close();
 		px4_shutdown_request();
 		// we need to ensure the shutdown logic gets updated and eventually triggers shutdown
 		hrt_abstime t = hrt_absolute_time();
@@ -1026,17 +1028,22 @@ Replay::run()
 }
 
 void
-Replay::readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file)
+Replay::readTopicDataToBuffer(const Subscription &sub)
 {
 	const size_t msg_read_size = sub.orb_meta->o_size_no_padding;
 	const size_t msg_write_size = sub.orb_meta->o_size;
 	_read_buffer.reserve(msg_write_size);
-	replay_file.seekg(sub.next_read_pos + (streamoff)(ULOG_MSG_HEADER_LEN + 2)); //skip header & msg id
-	replay_file.read((char *)_read_buffer.data(), msg_read_size);
+
+	if (!sub.data.empty()) {
+		memcpy(_read_buffer.data(), sub.data.data(), msg_read_size);
+
+	} else {
+		memcpy(_read_buffer.data(), _ulog_index.payload(sub.next_read_pos) + 2, msg_read_size); //skip msg id
+	}
 }
 
 bool
-Replay::handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file)
+Replay::handleTopicUpdate(Subscription &sub, void *data)
 {
 	return publishTopic(sub, data);
 }
@@ -1231,6 +1238,10 @@ the log file to be replayed. The second is the mode, specified via `replay_mode`
 - Generic otherwise: this can be used to replay any module(s), but the replay will be done with the same speed as the
   log was recorded.
 
+Optionally, `replay_start` can be set to a time in seconds since the start of the log, to skip the data before it.
+This uses the seek index appended by the logger, so that the skipped part of the log does not need to be read.
+Parameter changes in the skipped part are not applied.
+
 The module is typically used together with uORB publisher rules, to specify which messages should be replayed.
 The replay module will just publish all messages that are found in the log. It also applies the parameters from
 the log.
@@ -41,6 +41,7 @@
 #include <string>
 
 #include "definitions.hpp"
+#include "ULogIndex.hpp"
 
 #include <px4_platform_common/module.h>
 #include <uORB/topics/uORBTopics.hpp>
@@ -52,9 +53,9 @@ namespace px4
 /**
  * @class Replay
  * Parses an ULog file and replays it in 'real-time'. The timestamp of each replayed message is offset
- * to match the starting time of replay. It keeps a stream for each subscription to find the next message
- * to replay. This is necessary because data messages from different subscriptions don't need to be in
- * monotonic increasing order.
+ * to match the starting time of replay. The data section is memory mapped and indexed once, and the
+ * subscriptions are merged by timestamp with a heap. This is necessary because data messages from
+ * different subscriptions don't need to be in monotonic increasing order.
  */
 class Replay : public ModuleBase<Replay>
 {
@@ -135,8 +136,10 @@ protected:
 
 		bool ignored = false; ///< if true, it will not be considered for publication in the main loop
 
-		std::streampos next_read_pos;
+		uint64_t next_read_pos; ///< file offset of the next message
 		uint64_t next_timestamp; ///< timestamp of the file
+		size_t next_index = 0; ///< index of the message following next_read_pos in ULogIndex::dataMessages()
+		std::vector<uint8_t> data; ///< decoded data of the message at next_read_pos (only if the log contains delta encoded data)
 
 		CompatBase *compat = nullptr;
 
@@ -190,22 +193,19 @@ protected:
 	 * handle the publication of a topic update
 	 * @return true if published, false otherwise
 	 */
-	virtual bool handleTopicUpdate(Subscription &sub, void *data, std::ifstream &replay_file);
+	virtual bool handleTopicUpdate(Subscription &sub, void *data);
 
 	/**
 	 * read a topic from the file (offset given by the subscription) into _read_buffer
 	 */
-	void readTopicDataToBuffer(const Subscription &sub, std::ifstream &replay_file);
+	void readTopicDataToBuffer(const Subscription &sub);
 
 	/**
-	 * Find next data message for this subscription, starting with the stored file offset.
-	 * Skip the first message, and if found, read the timestamp and store the new file offset.
-	 * This also takes care of new subscriptions and parameter updates. When reaching EOF,
+	 * Find next data message for this subscription from the index, starting with next_index.
+	 * If found, read the timestamp and store the file offset. When reaching the end of the file,
 	 * the subscription is set to invalid.
-	 * File seek position is arbitrary after this call.
-	 * @return false on file error
 	 */
-	bool nextDataMessage(std::ifstream &file, Subscription &subscription, int msg_id);
+	void nextDataMessage(Subscription &subscription, int msg_id);
 
 	virtual uint64_t getTimestampOffset()
 	{
@@ -217,6 +217,8 @@ protected:
 	std::vector<Subscription *> _subscriptions;
 	std::vector<uint8_t> _read_buffer;
 
+	ULogIndex _ulog_index;
+
 	float _speed_factor{1.f}; ///< from PX4_SIM_SPEED_FACTOR env variable (set to 0 to avoid usleep = unlimited rate)
 
 private:
@@ -242,12 +244,12 @@ private:
 
 	uint64_t _file_start_time;
 	uint64_t _replay_start_time;
-	std::streampos _data_section_start; ///< first ADD_LOGGED_MSG message
-
-	/** keep track of file position to avoid adding a subscription multiple times. */
-	std::streampos _subscription_file_pos = 0;
+	uint64_t _data_section_start{0}; ///< file offset of the first ADD_LOGGED_MSG message
 
 	int64_t _read_until_file_position = 1ULL << 60; ///< read limit if log contains appended data
+	bool _delta_data{false}; ///< log contains delta encoded data messages
+
+	size_t _next_additional_message{0}; ///< index into ULogIndex::additionalMessages()
 
 	float _accumulated_delay{0.f};
 
@@ -262,9 +264,14 @@ private:
 
 	///file parsing methods. They return false, when further parsing should be aborted.
 	bool readFormat(std::ifstream &file, uint16_t msg_size);
-	bool readAndAddSubscription(std::ifstream &file, uint16_t msg_size);
 	bool readFlagBits(std::ifstream &file, uint16_t msg_size);
 
+	/**
+	 * Add the subscription of an ADD_LOGGED_MSG message and find its first data message.
+	 * @param message_pos file offset of the message
+	 */
+	void addSubscription(uint64_t message_pos);
+
 	/**
 	 * Read the file header and definitions sections. Apply the parameters from this section
 	 * and apply user-defined overridden parameters.
@@ -273,14 +280,14 @@ private:
 	bool readDefinitionsAndApplyParams(std::ifstream &file);
 
 	/**
-	 * Read and handle additional messages starting at current file position, while position < end_position.
+	 * Handle the additional messages from the index that are not handled yet, while position < end_position.
 	 * This handles dropout and parameter update messages.
 	 * We need to handle these separately, because they have no timestamp. We look at the file position instead.
-	 * @return false on file error
 	 */
-	bool readAndHandleAdditionalMessages(std::ifstream &file, std::streampos end_position);
-	bool readDropout(std::ifstream &file, uint16_t msg_size);
+	void handleAdditionalMessages(uint64_t end_position);
+	void handleDropout(const uint8_t *message, uint16_t msg_size);
 	bool readAndApplyParameter(std::ifstream &file, uint16_t msg_size);
+	bool applyParameter(const uint8_t *message, uint16_t msg_size);
 
 	static const orb_metadata *findTopic(const std::string &name);
 
@@ -0,0 +1,300 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "ULogIndex.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <logger/log_index.h>
+#include <px4_platform_common/log.h>
+
+namespace px4
+{
+
+ULogIndex::~ULogIndex()
+{
+	close();
+}
+
+bool
+ULogIndex::open(const char *file_name)
+{
+	close();
+
+	int fd = ::open(file_name, O_RDONLY);
+
+	if (fd < 0) {
+		PX4_ERR("failed to open %s (%i)", file_name, errno);
+		return false;
+	}
+
+	struct stat file_stat;
+
+	if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	void *data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// the mapping stays valid after closing the file
+	::close(fd);
+
+	if (data == MAP_FAILED) {
+		PX4_ERR("failed to map %s (%i)", file_name, errno);
+		return false;
+	}
+
+	// messages are mostly accessed in file order
+	madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+
+	_data = (const uint8_t *)data;
+	_size = file_stat.st_size;
+	return true;
+}
+
+void
+ULogIndex::close()
+{
+	if (_data) {
+		munmap((void *)_data, _size);
+		_data = nullptr;
+		_size = 0;
+	}
+
+	_num_messages = 0;
+	_data_messages.clear();
+	_subscriptions.clear();
+	_additional_messages.clear();
+	_sync_points.clear();
+	_seek_index_subscriptions.clear();
+}
+
+bool
+ULogIndex::readSeekIndex(uint64_t end)
+{
+	static constexpr char trailer_key[] = "uint64_t index_offset";
+	static constexpr size_t trailer_key_len = sizeof(trailer_key) - 1;
+	static_assert(ULOG_MSG_HEADER_LEN + 1 + trailer_key_len + sizeof(uint64_t) == logger::LogIndex::INDEX_TRAILER_SIZE,
+		      "unexpected index trailer size");
+
+	_sync_points.clear();
+	_seek_index_subscriptions.clear();
+
+	if (end > _size) {
+		end = _size;
+	}
+
+	if (end < sizeof(ulog_file_header_s) + logger::LogIndex::INDEX_TRAILER_SIZE) {
+		return false;
+	}
+
+	// the trailer is a fixed size INFO message at the end
+	const uint64_t trailer_offset = end - logger::LogIndex::INDEX_TRAILER_SIZE;
+	const ulog_message_header_s trailer_header = header(trailer_offset);
+	const uint8_t *trailer = payload(trailer_offset);
+
+	if (trailer_header.msg_type != (int)ULogMessageType::INFO ||
+	    trailer_header.msg_size != logger::LogIndex::INDEX_TRAILER_SIZE - ULOG_MSG_HEADER_LEN ||
+	    trailer[0] != trailer_key_len || memcmp(trailer + 1, trailer_key, trailer_key_len) != 0) {
+		return false;
+	}
+
+	uint64_t offset;
+	memcpy(&offset, trailer + 1 + trailer_key_len, sizeof(offset));
+
+	if (offset < sizeof(ulog_file_header_s) || offset >= trailer_offset) {
+		return false;
+	}
+
+	while (offset + ULOG_MSG_HEADER_LEN <= trailer_offset) {
+		const ulog_message_header_s message_header = header(offset);
+		const uint8_t *message = payload(offset);
+
+		if (offset + ULOG_MSG_HEADER_LEN + message_header.msg_size > trailer_offset) {
+			break;
+		}
+
+		offset += ULOG_MSG_HEADER_LEN + message_header.msg_size;
+
+		// [is_continued, key_len, key, values]
+		if (message_header.msg_type != (int)ULogMessageType::INFO_MULTIPLE || message_header.msg_size < 2 ||
+		    message[1] > message_header.msg_size - 2) {
+			continue;
+		}
+
+		char key[256];
+		memcpy(key, message + 2, message[1]);
+		key[message[1]] = 0;
+
+		unsigned num_values;
+		char name[sizeof(key)];
+
+		if (sscanf(key, "uint64_t[%u] %255s", &num_values, name) != 2 ||
+		    num_values * sizeof(uint64_t) != message_header.msg_size - 2u - message[1]) {
+			continue;
+		}
+
+		const uint8_t *values = message + 2 + message[1];
+
+		if (strcmp(name, "index_sync") == 0) {
+			for (unsigned i = 0; i + 1 < num_values; i += 2) {
+				SyncPoint sync_point;
+				memcpy(&sync_point.timestamp, values + i * sizeof(uint64_t), sizeof(uint64_t));
+				memcpy(&sync_point.offset, values + (i + 1) * sizeof(uint64_t), sizeof(uint64_t));
+
+				if (sync_point.offset < trailer_offset) {
+					_sync_points.push_back(sync_point);
+				}
+			}
+
+		} else if (strcmp(name, "index_msg_id") == 0) {
+			for (unsigned i = 0; i + 3 < num_values; i += 4) {
+				uint64_t add_logged_msg;
+				memcpy(&add_logged_msg, values + (i + 1) * sizeof(uint64_t), sizeof(uint64_t));
+
+				if (add_logged_msg > 0 && add_logged_msg < trailer_offset) {
+					_seek_index_subscriptions.push_back(add_logged_msg);
+				}
+			}
+		}
+	}
+
+	std::sort(_seek_index_subscriptions.begin(), _seek_index_subscriptions.end());
+
+	// in file order, which is also timestamp order
+	std::sort(_sync_points.begin(), _sync_points.end(), [](const SyncPoint & a, const SyncPoint & b) {
+		return a.offset < b.offset;
+	});
+
+	return !_sync_points.empty();
+}
+
+uint64_t
+ULogIndex::seek(uint64_t timestamp, uint64_t &sync_timestamp) const
+{
+	auto it = std::upper_bound(_sync_points.begin(), _sync_points.end(), timestamp,
+	[](uint64_t t, const SyncPoint & sync_point) {
+		return t < sync_point.timestamp;
+	});
+
+	if (it == _sync_points.begin()) {
+		return 0;
+	}
+
+	--it;
+	sync_timestamp = it->timestamp;
+	return it->offset;
+}
+
+std::vector<uint64_t>
+ULogIndex::subscriptionsBefore(uint64_t offset) const
+{
+	return std::vector<uint64_t>(_seek_index_subscriptions.begin(),
+				     std::lower_bound(_seek_index_subscriptions.begin(), _seek_index_subscriptions.end(), offset));
+}
+
+bool
+ULogIndex::build(uint64_t start, uint64_t end)
+{
+	if (end > _size) {
+		end = _size;
+	}
+
+	uint64_t offset = start;
+
+	while (offset + ULOG_MSG_HEADER_LEN <= end) {
+		const ulog_message_header_s message_header = header(offset);
+
+		if (offset + ULOG_MSG_HEADER_LEN + message_header.msg_size > end) {
+			break; // truncated message (e.g. at the end of the file)
+		}
+
+		switch (message_header.msg_type) {
+		case (int)ULogMessageType::DATA:
+		case (int)ULogMessageType::DATA_DELTA: {
+				if (message_header.msg_size < sizeof(uint16_t)) {
+					break;
+				}
+
+				uint16_t msg_id;
+				memcpy(&msg_id, payload(offset), sizeof(msg_id));
+
+				if (msg_id >= _data_messages.size()) {
+					_data_messages.resize(msg_id + 1);
+				}
+
+				_data_messages[msg_id].push_back(offset);
+			}
+			break;
+
+		case (int)ULogMessageType::ADD_LOGGED_MSG:
+			_subscriptions.push_back(offset);
+			break;
+
+		case (int)ULogMessageType::PARAMETER:
+		case (int)ULogMessageType::DROPOUT:
+			_additional_messages.push_back(offset);
+			break;
+
+		case (int)ULogMessageType::REMOVE_LOGGED_MSG: //skip these
+		case (int)ULogMessageType::INFO:
+		case (int)ULogMessageType::INFO_MULTIPLE:
+		case (int)ULogMessageType::SYNC:
+		case (int)ULogMessageType::LOGGING:
+		case (int)ULogMessageType::LOGGING_TAGGED:
+		case (int)ULogMessageType::PARAMETER_DEFAULT:
+			break;
+
+		default:
+			//this really should not happen
+			PX4_ERR("unknown log message type %i, size %i (offset %llu)",
+				(int)message_header.msg_type, (int)message_header.msg_size, (unsigned long long)offset);
+			break;
+		}
+
+		++_num_messages;
+		offset += ULOG_MSG_HEADER_LEN + message_header.msg_size;
+	}
+
+	return offset > start;
+}
+
+} //namespace px4
@@ -0,0 +1,147 @@
+/****************************************************************************
+ *
+ *   Copyright (C) 2026 PX4 Development Team. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name PX4 nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include <logger/messages.h>
+
+namespace px4
+{
+
+/**
+ * @class ULogIndex
+ * Read-only memory mapping of an ULog file, together with an index of its data section, built in a single pass:
+ * the file offsets of the data messages per msg_id, of the subscriptions (ADD_LOGGED_MSG) and of the messages
+ * without timestamp that need to be handled in file order (PARAMETER, DROPOUT).
+ * This avoids seeking back and forth in the file for every subscription during replay.
+ *
+ * If the logger appended a seek index (see logger/log_index.h), it can be read with readSeekIndex(), so that
+ * only the data section after a given timestamp needs to be indexed.
+ */
+class ULogIndex
+{
+public:
+	ULogIndex() = default;
+	~ULogIndex();
+
+	ULogIndex(const ULogIndex &) = delete;
+	ULogIndex &operator=(const ULogIndex &) = delete;
+
+	/**
+	 * Map a file into memory
+	 * @return true on success
+	 */
+	bool open(const char *file_name);
+
+	void close();
+
+	/**
+	 * Index the data section, i.e. all messages in the file range [start, end).
+	 * Indexing stops at the first truncated message.
+	 * @return true if at least one message was indexed
+	 */
+	bool build(uint64_t start, uint64_t end);
+
+	/**
+	 * Read the seek index appended by the logger, which ends at the file offset end.
+	 * @return true if the file contains a valid seek index
+	 */
+	bool readSeekIndex(uint64_t end);
+
+	bool hasSeekIndex() const { return !_sync_points.empty(); }
+
+	/**
+	 * Find the last sync point at or before a timestamp (requires a seek index).
+	 * @param timestamp log timestamp
+	 * @param sync_timestamp timestamp of the returned sync point
+	 * @return file offset of the sync point, 0 if there is none
+	 */
+	uint64_t seek(uint64_t timestamp, uint64_t &sync_timestamp) const;
+
+	/** file offsets of the ADD_LOGGED_MSG messages before a file offset, from the seek index, in file order */
+	std::vector<uint64_t> subscriptionsBefore(uint64_t offset) const;
+
+	uint64_t size() const { return _size; }
+
+	/** total number of indexed messages */
+	uint64_t numMessages() const { return _num_messages; }
+
+	/** message header of the message at a file offset */
+	ulog_message_header_s header(uint64_t offset) const
+	{
+		ulog_message_header_s message_header;
+		memcpy(&message_header, _data + offset, ULOG_MSG_HEADER_LEN);
+		return message_header;
+	}
+
+	/** message content (after the header) of the message at a file offset */
+	const uint8_t *payload(uint64_t offset) const { return _data + offset + ULOG_MSG_HEADER_LEN; }
+
+	/** file offsets of all data messages (DATA and DATA_DELTA) with a given msg_id, in file order */
+	const std::vector<uint64_t> &dataMessages(uint16_t msg_id) const
+	{
+		return msg_id < _data_messages.size() ? _data_messages[msg_id] : _no_messages;
+	}
+
+	/** file offsets of all ADD_LOGGED_MSG messages, in file order */
+	const std::vector<uint64_t> &subscriptions() const { return _subscriptions; }
+
+	/** file offsets of all PARAMETER and DROPOUT messages, in file order */
+	const std::vector<uint64_t> &additionalMessages() const { return _additional_messages; }
+
+private:
+	const uint8_t *_data{nullptr};
+	uint64_t _size{0};
+	uint64_t _num_messages{0};
+
+	std::vector<std::vector<uint64_t>> _data_messages;
+	std::vector<uint64_t> _subscriptions;
+	std::vector<uint64_t> _additional_messages;
+
+	const std::vector<uint64_t> _no_messages;
+
+	struct SyncPoint {
+		uint64_t timestamp;
+		uint64_t offset;
+	};
+
+	std::vector<SyncPoint> _sync_points; ///< from the seek index, ordered by timestamp
+	std::vector<uint64_t> _seek_index_subscriptions; ///< ADD_LOGGED_MSG offsets from the seek index, in file order
+};
+
+} //namespace px4
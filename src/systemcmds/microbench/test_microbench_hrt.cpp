@@ -38,6 +38,7 @@
 
 #include <unit_test.h>
 
+#include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
 #include <unistd.h>
@@ -47,6 +48,8 @@
 #include <px4_platform_common/px4_config.h>
 #include <px4_platform_common/micro_hal.h>
 
+using namespace time_literals;
+
 namespace MicroBenchHRT
 {
 
@@ -94,6 +97,9 @@ public:
 private:
 
 	bool time_px4_hrt();
+	bool time_hrt_callout_queue();
+
+	void time_hrt_callout_queue(int pending);
 
 	void reset();
 
@@ -118,6 +124,7 @@ private:
 bool MicroBenchHRT::run_tests()
 {
 	ut_run_test(time_px4_hrt);
+	ut_run_test(time_hrt_callout_queue);
 
 	return (_tests_failed == 0);
 }
@@ -148,4 +155,101 @@ bool MicroBenchHRT::time_px4_hrt()
 	return true;
 }
 
+static void fire_callout(void *arg)
+{
+	hrt_abstime *fired = (hrt_abstime *)arg;
+	*fired = hrt_absolute_time();
+}
+
+void MicroBenchHRT::time_hrt_callout_queue(int pending)
+{
+	static constexpr int count = 1000;
+
+	// far enough in the future to never fire during the benchmark
+	static constexpr hrt_abstime far_delay = 3600_s;
+
+	hrt_call *calls = new hrt_call[pending] {};
+	hrt_call probe{};
+
+	if (calls == nullptr) {
+		return;
+	}
+
+	for (int i = 0; i < pending; i++) {
+		hrt_call_after(&calls[i], far_delay + (hrt_abstime)(rand() % 1000000), nullptr, nullptr);
+	}
+
+	char name[64];
+
+	snprintf(name, sizeof(name), "hrt_call_after() insert, %d pending", pending);
+	perf_counter_t insert = perf_alloc(PC_ELAPSED, name);
+
+	snprintf(name, sizeof(name), "hrt_call_after() reschedule, %d pending", pending);
+	perf_counter_t reschedule = perf_alloc(PC_ELAPSED, name);
+
+	snprintf(name, sizeof(name), "hrt_cancel(), %d pending", pending);
+	perf_counter_t cancel = perf_alloc(PC_ELAPSED, name);
+
+	snprintf(name, sizeof(name), "hrt callout fire latency, %d pending", pending);
+	perf_counter_t fire = perf_alloc(PC_ELAPSED, name);
+
+	for (int i = 0; i < count; i++) {
+		const hrt_abstime delay = far_delay + (hrt_abstime)(rand() % 1000000);
+
+		px4_usleep(1);
+		perf_begin(insert);
+		hrt_call_after(&probe, delay, nullptr, nullptr);
+		perf_end(insert);
+
+		px4_usleep(1);
+		perf_begin(reschedule);
+		hrt_call_after(&probe, delay + 1, nullptr, nullptr);
+		perf_end(reschedule);
+
+		px4_usleep(1);
+		perf_begin(cancel);
+		hrt_cancel(&probe);
+		perf_end(cancel);
+	}
+
+	for (int i = 0; i < count / 10; i++) {
+		volatile hrt_abstime fired = 0;
+		const hrt_abstime deadline = hrt_absolute_time() + 1_ms;
+		hrt_call_at(&probe, deadline, fire_callout, (void *)&fired);
+
+		while (fired == 0) {
+			px4_usleep(100);
+		}
+
+		perf_set_elapsed(fire, fired - deadline);
+	}
+
+	perf_print_counter(insert);
+	perf_print_counter(reschedule);
+	perf_print_counter(cancel);
+	perf_print_counter(fire);
+
+	perf_free(insert);
+	perf_free(reschedule);
+	perf_free(cancel);
+	perf_free(fire);
+
+	for (int i = 0; i < pending; i++) {
+		hrt_cancel(&calls[i]);
+	}
+
+	hrt_cancel(&probe);
+
+	delete[] calls;
+}
+
+bool MicroBenchHRT::time_hrt_callout_queue()
+{
+	time_hrt_callout_queue(10);
+	time_hrt_callout_queue(100);
+	time_hrt_callout_queue(1000);
+
+	return true;
+}
+
 } // namespace MicroBenchHRT
@@ -99,8 +99,10 @@ private:
 	bool time_matrix_quaternion();
 	bool time_matrix_dcm();
 	bool time_matrix_pseduo_inverse();
+	bool time_matrix_covariance_update();
 
 	void reset();
+	void covarianceUpdateDense(const matrix::Vector<float, 24> &K, float S);
 
 	matrix::Quatf q;
 	matrix::Eulerf e;
@@ -108,6 +110,10 @@ private:
 	matrix::Matrix<float, 16, 6> A16;
 	matrix::Matrix<float, 6, 16> B16;
 	matrix::Matrix<float, 6, 16> B16_4;
+	matrix::SquareMatrix<float, 24> P24;
+	matrix::Vector<float, 24> K24;
+	matrix::Vector<float, 24> K24_16;
+	matrix::Vector<float, 24> K24_3;
 };
 
 bool MicroBenchMatrix::run_tests()
@@ -116,6 +122,7 @@ bool MicroBenchMatrix::run_tests()
 	ut_run_test(time_matrix_quaternion);
 	ut_run_test(time_matrix_dcm);
 	ut_run_test(time_matrix_pseduo_inverse);
+	ut_run_test(time_matrix_covariance_update);
 
 	return (_tests_failed == 0);
 }
@@ -145,6 +152,34 @@ void MicroBenchMatrix::reset()
 			B16_4(j, i) = random(-10.0, 10.0);
 		}
 	}
+
+	for (size_t j = 0; j < 24; j++) {
+		for (size_t i = 0; i <= j; i++) {
+			P24(j, i) = P24(i, j) = random(-1.0, 1.0);
+		}
+
+		K24(j) = random(-1.0, 1.0);
+		K24_16(j) = (j < 16) ? K24(j) : 0.f;
+		K24_3(j) = (j >= 6 && j < 9) ? K24(j) : 0.f;
+	}
+}
+
+void MicroBenchMatrix::covarianceUpdateDense(const matrix::Vector<float, 24> &K, float S)
+{
+	// full K * S * K' correction followed by forcing symmetry
+	for (size_t row = 0; row < 24; row++) {
+		for (size_t col = 0; col < 24; col++) {
+			P24(row, col) -= K(row) * S * K(col);
+		}
+	}
+
+	for (size_t row = 1; row < 24; row++) {
+		for (size_t col = 0; col < row; col++) {
+			const float tmp = (P24(row, col) + P24(col, row)) / 2.f;
+			P24(row, col) = tmp;
+			P24(col, row) = tmp;
+		}
+	}
 }
 
 bool MicroBenchMatrix::time_matrix_euler()
@@ -175,6 +210,18 @@ bool MicroBenchMatrix::time_matrix_pseduo_inverse()
 	return true;
 }
 
+bool MicroBenchMatrix::time_matrix_covariance_update()
+{
+	// scalar EKF covariance update P = P - K * S * K' with 24, 16 (e.g. wind and mag states inactive) and 3 non-zero gains
+	PERF("matrix 24x24 covariance update dense (24 non-zero)", covarianceUpdateDense(K24, 0.1f), 100);
+	PERF("matrix 24x24 covariance update symmetric (24 non-zero)", P24.rankOneUpdateSymmetric(K24, -0.1f), 100);
+	PERF("matrix 24x24 covariance update dense (16 non-zero)", covarianceUpdateDense(K24_16, 0.1f), 100);
+	PERF("matrix 24x24 covariance update symmetric (16 non-zero)", P24.rankOneUpdateSymmetric(K24_16, -0.1f), 100);
+	PERF("matrix 24x24 covariance update dense (3 non-zero)", covarianceUpdateDense(K24_3, 0.1f), 100);
+	PERF("matrix 24x24 covariance update symmetric (3 non-zero)", P24.rankOneUpdateSymmetric(K24_3, -0.1f), 100);
+	return true;
+}
+
 ut_declare_test_c(test_microbench_matrix, MicroBenchMatrix)
 
 } // namespace MicroBenchMatrix
@@ -44,6 +44,14 @@
 #include <stdio.h>
 #include <pthread.h>
 
+#if defined(__PX4_LINUX)
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif
+
 #include "dataman_client/DatamanClient.hpp"
 
 class DatamanTest : public UnitTest
@@ -76,6 +84,8 @@ private:
 	bool testSyncMutipleClients();
 	bool testSyncWriteReadAllItemsMaxSize();
 	bool testSyncClearAll();
+	bool testSyncMissionUpload();
+	bool testSyncDeferredWriteFailure();
 
 	//Async
 	bool testAsyncReadInvalidItem();
@@ -302,6 +312,157 @@ DatamanTest::testSyncClearAll()
 	return success;
 }
 
+bool
+DatamanTest::testSyncMissionUpload()
+{
+	const dm_item_t item = DM_KEY_WAYPOINTS_OFFBOARD_1;
+	const uint32_t num_items = _max_index[item];
+	hrt_abstime elapsed[2] {};
+
+	// Upload with every item made persistent (as before write coalescing), then with a single flush at the end
+	for (int batched = 0; batched < 2; ++batched) {
+
+		const hrt_abstime start = hrt_absolute_time();
+
+		for (uint32_t index = 0U; index < num_items; ++index) {
+
+			memset(_buffer_write, (uint8_t)((index + batched) % UINT8_MAX), sizeof(_buffer_write));
+
+			if (!_dataman_client1.writeSync(item, index, _buffer_write, g_per_item_size[item])) {
+				PX4_ERR("writeSync failed at index = %" PRIu32, index);
+				return false;
+			}
+
+			if (!batched && !_dataman_client1.flushSync()) {
+				PX4_ERR("flushSync failed at index = %" PRIu32, index);
+				return false;
+			}
+		}
+
+		if (!_dataman_client1.flushSync()) {
+			PX4_ERR("flushSync failed");
+			return false;
+		}
+
+		elapsed[batched] = hrt_elapsed_time(&start);
+
+		for (uint32_t index = 0U; index < num_items; ++index) {
+
+			if (!_dataman_client1.readSync(item, index, _buffer_read, g_per_item_size[item])) {
+				PX4_ERR("readSync failed at index = %" PRIu32, index);
+				return false;
+			}
+
+			const uint8_t expected_value = (uint8_t)((index + batched) % UINT8_MAX);
+
+			for (uint32_t i = 0U; i < g_per_item_size[item]; ++i) {
+				if (_buffer_read[i] != expected_value) {
+					PX4_ERR("readSync mismatch at index = %" PRIu32 ", element = %" PRIu32, index, i);
+					return false;
+				}
+			}
+		}
+	}
+
+	PX4_INFO("upload of %" PRIu32 " items: %.1f ms with sync per item, %.1f ms batched", num_items,
+		 (double)elapsed[0] / 1e3, (double)elapsed[1] / 1e3);
+
+	return _dataman_client1.clearSync(item);
+}
+
+#if defined(__PX4_LINUX)
+// file descriptor of the dataman file backend (-1 if not found, e.g. with the RAM backend)
+static int
+dataman_file_fd()
+{
+	char dataman_path[PATH_MAX];
+
+	if (realpath(PX4_STORAGEDIR "/dataman", dataman_path) == nullptr) {
+		return -1;
+	}
+
+	DIR *dir = opendir("/proc/self/fd");
+
+	if (dir == nullptr) {
+		return -1;
+	}
+
+	int fd = -1;
+	struct dirent *entry;
+
+	while ((fd < 0) && (entry = readdir(dir)) != nullptr) {
+		char link_path[32];
+		char file_path[PATH_MAX];
+		snprintf(link_path, sizeof(link_path), "/proc/self/fd/%s", entry->d_name);
+		const ssize_t len = readlink(link_path, file_path, sizeof(file_path) - 1);
+
+		if (len > 0) {
+			file_path[len] = '\0';
+
+			if (strcmp(file_path, dataman_path) == 0) {
+				fd = atoi(entry->d_name);
+			}
+		}
+	}
+
+	closedir(dir);
+	return fd;
+}
+#endif // __PX4_LINUX
+
+bool
+DatamanTest::testSyncDeferredWriteFailure()
+{
+#if defined(__PX4_LINUX)
+	const int fd = dataman_file_fd();
+
+	if (fd < 0) {
+		PX4_WARN("dataman file not found, skipping");
+		return true;
+	}
+
+	mission_s mission_state{};
+
+	if (!_dataman_client1.readSync(DM_KEY_MISSION_STATE, 0, reinterpret_cast<uint8_t *>(&mission_state),
+				       sizeof(mission_s)) || !_dataman_client1.flushSync()) {
+		PX4_ERR("mission state read failed");
+		return false;
+	}
+
+	// make the deferred write of the item fail: replace the dataman file by a read-only descriptor
+	const int fd_saved = dup(fd);
+	const int fd_read_only = open(PX4_STORAGEDIR "/dataman", O_RDONLY);
+	ut_assert_true(fd_saved >= 0 && fd_read_only >= 0);
+	ut_assert_true(dup2(fd_read_only, fd) == fd);
+
+	memset(_buffer_write, 0x5a, sizeof(_buffer_write));
+	const bool write_success = _dataman_client1.writeSync(DM_KEY_WAYPOINTS_OFFBOARD_0, 0, _buffer_write,
+				   g_per_item_size[DM_KEY_WAYPOINTS_OFFBOARD_0]);
+
+	// the idle dataman makes the write persistent in the background (at least once a second)
+	px4_usleep(1500_ms);
+
+	dup2(fd_saved, fd);
+	close(fd_saved);
+	close(fd_read_only);
+
+	ut_assert_true(write_success);
+
+	// the commit record of the transaction must not be written on top of the lost item
+	const bool commit_success = _dataman_client1.writeSync(DM_KEY_MISSION_STATE, 0,
+				    reinterpret_cast<uint8_t *>(&mission_state), sizeof(mission_s));
+	ut_assert_false(commit_success);
+
+	// the error is only reported once
+	ut_assert_true(_dataman_client1.writeSync(DM_KEY_MISSION_STATE, 0, reinterpret_cast<uint8_t *>(&mission_state),
+			sizeof(mission_s)));
+
+	return _dataman_client1.clearSync(DM_KEY_WAYPOINTS_OFFBOARD_0);
+#else
+	return true;
+#endif // __PX4_LINUX
+}
+
 bool
 DatamanTest::testAsyncReadInvalidItem()
 {
@@ -1128,6 +1289,8 @@ bool DatamanTest::run_tests()
 	ut_run_test(testSyncMutipleClients);
 	ut_run_test(testSyncWriteReadAllItemsMaxSize);
 	ut_run_test(testSyncClearAll);
+	ut_run_test(testSyncMissionUpload);
+	ut_run_test(testSyncDeferredWriteFailure);
 
 	ut_run_test(testAsyncReadInvalidItem);
 	ut_run_test(testAsyncWriteInvalidItem);
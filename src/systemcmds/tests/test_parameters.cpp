@@ -39,12 +39,14 @@
 #include <unit_test.h>
 
 #include <px4_platform_common/defines.h>
+#include <drivers/drv_hrt.h>
 #include <lib/parameters/param.h>
 
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <math.h>
+#include <string.h>
 
 class ParameterTest : public UnitTest
 {
@@ -83,6 +85,9 @@ private:
 	bool CustomDefaults();
 	bool exportImport();
 
+	// lookup of all parameters by name
+	bool FindAll();
+
 	// tests on system parameters
 	// WARNING, can potentially trash your system
 	bool exportImportAll();
@@ -140,6 +145,69 @@ bool ParameterTest::SimpleFind()
 	return true;
 }
 
+bool ParameterTest::FindAll()
+{
+	const unsigned count = param_count();
+
+	// every parameter is found by its name
+	const hrt_abstime start = hrt_absolute_time();
+	unsigned mismatches = 0;
+
+	for (unsigned i = 0; i < count; i++) {
+		const param_t param = param_for_index(i);
+
+		if (param_find_no_notification(param_name(param)) != param) {
+			mismatches++;
+		}
+	}
+
+	const hrt_abstime elapsed = hrt_elapsed_time(&start);
+
+	ut_compare("param_find returned a different parameter", 0u, mismatches);
+
+	// reference: binary search over the sorted names (lookup before the perfect hash)
+	const hrt_abstime start_bsearch = hrt_absolute_time();
+	unsigned found = 0;
+
+	for (unsigned i = 0; i < count; i++) {
+		const char *name = param_name(param_for_index(i));
+		unsigned front = 0;
+		unsigned last = count - 1;
+
+		while (front <= last) {
+			const unsigned middle = front + (last - front) / 2;
+			const int ret = strcmp(name, param_name(param_for_index(middle)));
+
+			if (ret == 0) {
+				found++;
+				break;
+
+			} else if (ret < 0) {
+				if (middle == 0) {
+					break;
+				}
+
+				last = middle - 1;
+
+			} else {
+				front = middle + 1;
+			}
+		}
+	}
+
+	const hrt_abstime elapsed_bsearch = hrt_elapsed_time(&start_bsearch);
+
+	ut_compare("binary search did not find all parameters", count, found);
+
+	ut_assert_true(param_find_no_notification("TEST_DOES_NOT_EXIST") == PARAM_INVALID);
+	ut_assert_true(param_find_no_notification("") == PARAM_INVALID);
+
+	PX4_INFO("param_find of %u parameters: %" PRIu64 " us (binary search: %" PRIu64 " us)", count, elapsed,
+		 elapsed_bsearch);
+
+	return true;
+}
+
 bool ParameterTest::ResetAll()
 {
 	_set_all_int_parameters_to(50);
@@ -582,6 +650,7 @@ bool ParameterTest::run_tests()
 	ut_run_test(ResetAllExcludesWildcard);
 	ut_run_test(CustomDefaults);
 	ut_run_test(exportImport);
+	ut_run_test(FindAll);
 
 	// WARNING, can potentially trash your system
 #ifdef __PX4_POSIX